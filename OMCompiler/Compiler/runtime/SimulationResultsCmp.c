@@ -34,8 +34,10 @@
 #include <errno.h>
 #include <string.h>
 #include <assert.h>
+#include <pthread.h>
 
 #include "systemimpl.h"
+#include "util/rtclock.h"
 
 /* Size of the buffer for warnings and other messages */
 #define WARNINGBUFFSIZE 4096
@@ -96,6 +98,66 @@ static char ** getVars(void *vars, unsigned int* nvars)
   return cmpvars;
 }
 
+/* Reads one variable of a MAT or CSV file directly into a new array, without
+ * going through a MetaModelica list. For MAT files the values are not cached by
+ * the reader, so comparing all variables of a file streams over it; only files
+ * that store the values row by row (and cannot be mapped) are read completely
+ * when all variables are compared. Returns 1 if the file format is not handled here. */
+static int getDataDirect(DataField *res, const char *varname, const char *filename, unsigned int size, int suggestReadAll, SimulationResult_Globals* srg, int runningTestsuite)
+{
+  const char *msg[2] = {"",""};
+  double *vals;
+  unsigned int i;
+
+  switch (srg->curFormat) {
+  case MATLAB4: {
+    ModelicaMatReader *reader = &srg->matReader;
+    ModelicaMatVariable_t *var;
+    if (size == 0) {
+      size = reader->nrows;
+    } else if (reader->nrows != size) {
+      c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_error, gettext("readDataset(...): Expected and actual dimension sizes do not match."), NULL, 0);
+      return 0;
+    }
+    if (suggestReadAll && !reader->columnMajor && !reader->mappedFile) {
+      omc_matlab4_read_all_vals(reader);
+    }
+    var = omc_matlab4_find_var(reader,varname);
+    if (var == NULL) {
+      msg[0] = runningTestsuite ? SystemImpl__basename(filename) : filename;
+      msg[1] = varname;
+      c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_error, gettext("Could not read variable %s in file %s."), msg, 2);
+      return 0;
+    }
+    if (var->isParam) {
+      double val = (var->index<0) ? -reader->params[abs(var->index)-1] : reader->params[abs(var->index)-1];
+      res->data = (double*) malloc(sizeof(double)*size);
+      for (i=0; i<size; i++) {
+        res->data[i] = val;
+      }
+    } else {
+      res->data = omc_matlab4_take_vals(reader,var->index);
+    }
+    res->n = res->data ? size : 0;
+    return 0;
+  }
+  case CSV:
+    vals = srg->csvReader ? read_csv_dataset(srg->csvReader,varname) : NULL;
+    if (vals == NULL) {
+      msg[0] = runningTestsuite ? SystemImpl__basename(filename) : filename;
+      msg[1] = varname;
+      c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_error, gettext("Could not read variable %s in file %s."), msg, 2);
+      return 0;
+    }
+    res->data = (double*) malloc(sizeof(double)*size);
+    memcpy(res->data, vals, sizeof(double)*size);
+    res->n = size;
+    return 0;
+  default:
+    return 1;
+  }
+}
+
 static DataField getData(const char *varname,const char *filename, unsigned int size, int suggestRealAll, SimulationResult_Globals* srg, int runningTestsuite)
 {
   DataField res;
@@ -104,6 +166,11 @@ static DataField getData(const char *varname,const char *filename, unsigned int
   res.n = 0;
   res.data = NULL;
 
+  if (UNKNOWN_PLOT == SimulationResultsImpl__openFile(filename,srg) ||
+      0 == getDataDirect(&res,varname,filename,size,suggestRealAll,srg,runningTestsuite)) {
+    return res;
+  }
+
   /* fprintf(stderr, "getData of Var: %s from file %s\n", varname,filename);  */
   cmpvar = mmc_mk_nil();
   cmpvar =  mmc_mk_cons(mmc_mk_scon(varname),cmpvar);
@@ -583,6 +650,178 @@ static const char* getTimeVarName(void *vars) {
 
 #include "SimulationResultsCmpTubes.c"
 
+/* Number of variables read from the files at once by the result diff. The tubes
+ * of one batch are calculated in parallel while the next batch is read, so at
+ * most two batches of variables are kept in memory. */
+#define CMP_BATCH_SIZE 64
+
+typedef struct {
+  char *var;
+  DataField data,dataref;
+  tubeComparison cmp;
+} cmpVariable;
+
+typedef struct {
+  pthread_mutex_t mutex;
+  cmpVariable *vars;
+  int n;
+  int current;
+  DataField *time,*timeref;
+  double reltol,rangeDelta,reltolDiffMaxMin;
+} tubeWorkerData;
+
+/* Statistics of the last comparison, see SimulationResults_diffStatistics */
+static struct {
+  int numVars;
+  double bytes;
+  double seconds;
+} cmpStatistics;
+
+/* Reads a variable from both files. Returns 0 on success; else a warning was added. */
+static int loadCmpVariable(cmpVariable *v, char *var, const char *filename, const char *reffilename, unsigned int size, unsigned int size_ref, int suggestReadAll, int offset, int offsetRef, int runningTestsuite)
+{
+  const char *msg[2] = {"",""};
+  unsigned int len = strlen(var), j, k = 0;
+  char *var1 = (char*) omc_alloc_interface.malloc(len+10);
+  for (j=0;j<len;j++) {
+    if (var[j] !='\"' ) {
+      var1[k] = var[j];
+      k +=1;
+    }
+  }
+  var1[k] = 0;
+  v->var = var;
+  v->data.data = NULL;
+  /* fprintf(stderr, "compare var: %s\n",var); */
+  /* check if in ref_file */
+  v->dataref = getData(var1,reffilename,size_ref,suggestReadAll,&simresglob_ref,runningTestsuite);
+  if (v->dataref.n==0) {
+    if (v->dataref.data) {
+      free(v->dataref.data);
+    }
+    GC_free(var1);
+    msg[0] = runningTestsuite ? SystemImpl__basename(reffilename) : reffilename;
+    msg[1] = var;
+    c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_warning, gettext("Get data of variable %s from file %s failed!\n"), msg, 2);
+    return 1;
+  }
+  /*  check if in file */
+  v->data = getData(var1,filename,size,suggestReadAll,&simresglob_c,runningTestsuite);
+  GC_free(var1);
+  if (v->data.n==0)  {
+    if (v->data.data) {
+      free(v->data.data);
+    }
+    free(v->dataref.data);
+    msg[0] = runningTestsuite ? SystemImpl__basename(filename) : filename;
+    msg[1] = var;
+    c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_warning, gettext("Get data of variable %s from file %s failed!\n"), msg, 2);
+    return 1;
+  }
+  /* adjust initial data points */
+  for(j=offset; j>0; j--)
+    v->data.data[j-1] = v->data.data[j];
+  for(j=offsetRef; j>0; j--)
+    v->dataref.data[j-1] = v->dataref.data[j];
+  cmpStatistics.numVars++;
+  cmpStatistics.bytes += (v->data.n + v->dataref.n) * sizeof(double);
+  return 0;
+}
+
+static void freeCmpVariable(cmpVariable *v)
+{
+  free(v->dataref.data);
+  free(v->data.data);
+}
+
+/* Reads the next variables that exist in both files into batch; returns how many */
+static int loadCmpBatch(cmpVariable *batch, char **cmpvars, unsigned int ncmpvars, unsigned int *next, unsigned int *ngetfailedvars, const char *filename, const char *reffilename, unsigned int size, unsigned int size_ref, int suggestReadAll, int offset, int offsetRef, int runningTestsuite)
+{
+  int n = 0;
+  while (n < CMP_BATCH_SIZE && *next < ncmpvars) {
+    if (loadCmpVariable(&batch[n],cmpvars[(*next)++],filename,reffilename,size,size_ref,suggestReadAll,offset,offsetRef,runningTestsuite)) {
+      (*ngetfailedvars)++;
+    } else {
+      n++;
+    }
+  }
+  return n;
+}
+
+static void* tubeWorkerThread(void *in)
+{
+  tubeWorkerData *work = (tubeWorkerData*) in;
+  while (1) {
+    int i;
+    pthread_mutex_lock(&work->mutex);
+    i = work->current++;
+    pthread_mutex_unlock(&work->mutex);
+    if (i >= work->n) break;
+    calculateTubeComparison(&work->vars[i].cmp,work->time,work->timeref,&work->vars[i].data,&work->vars[i].dataref,work->reltol,work->rangeDelta,work->reltolDiffMaxMin);
+  }
+  return NULL;
+}
+
+/* Compares the variables with tubes. The files are read batch by batch on the
+ * calling thread (the readers are not thread-safe), while the tubes of the
+ * previous batch are calculated by worker threads. The results are written in
+ * the order of cmpvars, independent of the number of threads. */
+static unsigned int cmpTubesInBatches(char **cmpvars, unsigned int ncmpvars, unsigned int *ngetfailedvars, const char *filename, const char *reffilename, unsigned int size, unsigned int size_ref, int suggestReadAll, int offset, int offsetRef, int runningTestsuite, DataField *time, DataField *timeref, double reltol, double rangeDelta, double reltolDiffMaxMin, char **cmpdiffvars, unsigned int vardiffindx, int keepEqualResults, void **diffLst, const char *prefix, int isHtml, char **htmlOut)
+{
+  cmpVariable *batches[2];
+  int nbatch[2];
+  int cur = 0, nthreads = System_numProcessors(), i;
+  unsigned int next = 0;
+  tubeWorkerData work;
+  pthread_t *th;
+
+  if (nthreads > CMP_BATCH_SIZE) {
+    nthreads = CMP_BATCH_SIZE;
+  }
+  batches[0] = (cmpVariable*) omc_alloc_interface.malloc(2*CMP_BATCH_SIZE*sizeof(cmpVariable));
+  batches[1] = batches[0] + CMP_BATCH_SIZE;
+  th = (pthread_t*) omc_alloc_interface.malloc(nthreads*sizeof(pthread_t));
+  pthread_mutex_init(&work.mutex,NULL);
+  work.time = time;
+  work.timeref = timeref;
+  work.reltol = reltol;
+  work.rangeDelta = rangeDelta;
+  work.reltolDiffMaxMin = reltolDiffMaxMin;
+
+  nbatch[cur] = loadCmpBatch(batches[cur],cmpvars,ncmpvars,&next,ngetfailedvars,filename,reffilename,size,size_ref,suggestReadAll,offset,offsetRef,runningTestsuite);
+  while (nbatch[cur] > 0) {
+    int nth = nthreads < nbatch[cur] ? nthreads : nbatch[cur], live_threads = 0;
+    work.vars = batches[cur];
+    work.n = nbatch[cur];
+    work.current = 0;
+    if (nth > 1) {
+      for (i=0; i<nth; i++) {
+        if (GC_pthread_create(&th[i],NULL,tubeWorkerThread,&work)) {
+          break; /* the threads that were started (or this thread) do the remaining work */
+        }
+        live_threads++;
+      }
+    }
+    /* read the next batch while the tubes are calculated */
+    nbatch[1-cur] = loadCmpBatch(batches[1-cur],cmpvars,ncmpvars,&next,ngetfailedvars,filename,reffilename,size,size_ref,suggestReadAll,offset,offsetRef,runningTestsuite);
+    tubeWorkerThread(&work);
+    for (i=0; i<live_threads; i++) {
+      GC_pthread_join(th[i],NULL);
+    }
+    for (i=0; i<nbatch[cur]; i++) {
+      cmpVariable *v = &batches[cur][i];
+      vardiffindx = writeTubeComparison(&v->cmp,0 /* isResultCmp */,v->var,time,timeref,reltol,rangeDelta,reltolDiffMaxMin,cmpdiffvars,vardiffindx,keepEqualResults,diffLst,prefix,isHtml,htmlOut);
+      freeCmpVariable(v);
+    }
+    cur = 1-cur;
+  }
+
+  pthread_mutex_destroy(&work.mutex);
+  GC_free(th);
+  GC_free(batches[0]);
+  return vardiffindx;
+}
+
 /* Common, huge function, for both result comparison and result diff */
 void* SimulationResultsCmp_compareResults(int isResultCmp, int runningTestsuite, const char *filename, const char *reffilename, const char *resultfilename, double reltol, double abstol, double reltolDiffMaxMin, double rangeDelta, void *vars, int keepEqualResults, int *success, int isHtml, char **htmlOut)
 {
@@ -592,19 +831,23 @@ void* SimulationResultsCmp_compareResults(int isResultCmp, int runningTestsuite,
   unsigned int ncmpvars = 0;
   unsigned int ngetfailedvars = 0;
   void *allvars,*allvarsref,*res;
-  unsigned int i,size,size_ref,len,j,k;
-  char *var,*var1,*var2;
-  DataField time,timeref,data,dataref;
+  unsigned int i,size,size_ref;
+  DataField time,timeref;
   DiffDataField ddf;
   const char *msg[2] = {"",""};
   const char *timeVarName, *timeVarNameRef;
   int suggestReadAll=0;
+  rtclock_t cmpClock;
   ddf.data=NULL;
   ddf.n=0;
   ddf.n_max=0;
-  len = 1;
   int offset, offsetRef;
 
+  cmpStatistics.numVars = 0;
+  cmpStatistics.bytes = 0;
+  cmpStatistics.seconds = 0;
+  rt_ext_tp_tick(&cmpClock);
+
   /* open files */
   /*  fprintf(stderr, "Open File %s\n", filename); */
   if (UNKNOWN_PLOT == SimulationResultsImpl__openFile(filename,&simresglob_c)) {
@@ -675,6 +918,7 @@ void* SimulationResultsCmp_compareResults(int isResultCmp, int runningTestsuite,
     }
     MMC_THROW();
   }
+  cmpStatistics.bytes += (time.n + timeref.n) * sizeof(double);
   cmpdiffvars = (char**)omc_alloc_interface.malloc(sizeof(char*)*(ncmpvars));
   /* check if time is larger or less reftime */
   res = mmc_mk_nil();
@@ -691,84 +935,22 @@ void* SimulationResultsCmp_compareResults(int isResultCmp, int runningTestsuite,
   /* calculate offsets */
   for(offset=0; offset<time.n-1 && time.data[offset] == time.data[offset+1]; ++offset);
   for(offsetRef=0; offsetRef<timeref.n-1 && timeref.data[offsetRef] == timeref.data[offsetRef+1]; ++offsetRef);
-  var1=NULL;
-  var2=NULL;
   /* compare vars */
   /* fprintf(stderr, "compare vars\n"); */
-  for (i=0;i<ncmpvars;i++) {
-    var = cmpvars[i];
-    len = strlen(var);
-    if (var1) {
-      free(var1);
-      var1 = NULL;
-    }
-    var1 = (char*) omc_alloc_interface.malloc(len+10);
-    k = 0;
-    for (j=0;j<len;j++) {
-      if (var[j] !='\"' ) {
-        var1[k] = var[j];
-        k +=1;
-      }
-    }
-    var1[k] = 0;
-    /* fprintf(stderr, "compare var: %s\n",var); */
-    /* check if in ref_file */
-    dataref = getData(var1,reffilename,size_ref,suggestReadAll,&simresglob_ref,runningTestsuite);
-    if (dataref.n==0) {
-      if (dataref.data) {
-        free(dataref.data);
-      }
-      if (var1) {
-        GC_free(var1);
-        var1 = NULL;
-      }
-      msg[0] = runningTestsuite ? SystemImpl__basename(reffilename) : reffilename;
-      msg[1] = var;
-      c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_warning, gettext("Get data of variable %s from file %s failed!\n"), msg, 2);
-      ngetfailedvars++;
-      continue;
-    }
-    /*  check if in file */
-    data = getData(var1,filename,size,suggestReadAll,&simresglob_c,runningTestsuite);
-    if (data.n==0)  {
-      if (data.data) {
-        free(data.data);
-      }
-      if (var1) {
-        GC_free(var1);
-        var1 = NULL;
+  if (isResultCmp) {
+    cmpVariable v;
+    for (i=0;i<ncmpvars;i++) {
+      if (loadCmpVariable(&v,cmpvars[i],filename,reffilename,size,size_ref,suggestReadAll,offset,offsetRef,runningTestsuite)) {
+        ngetfailedvars++;
+        continue;
       }
-      msg[0] = runningTestsuite ? SystemImpl__basename(filename) : filename;
-      msg[1] = var;
-      c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_warning, gettext("Get data of variable %s from file %s failed!\n"), msg, 2);
-      ngetfailedvars++;
-      continue;
-    }
-    /* adjust initial data points */
-    for(j=offset; j>0; j--)
-      data.data[j-1] = data.data[j];
-    for(j=offsetRef; j>0; j--)
-      dataref.data[j-1] = dataref.data[j];
-    /* compare */
-    if (isHtml) {
-      vardiffindx = cmpDataTubes(isResultCmp,var,&time,&timeref,&data,&dataref,reltol,rangeDelta,reltolDiffMaxMin,&ddf,cmpdiffvars,vardiffindx,keepEqualResults,&res,resultfilename,1,htmlOut);
-    } else if (isResultCmp) {
-      vardiffindx = cmpData(isResultCmp,var,&time,&timeref,&data,&dataref,reltol,abstol,&ddf,cmpdiffvars,vardiffindx,keepEqualResults,&res,resultfilename);
-    } else {
-      vardiffindx = cmpDataTubes(isResultCmp,var,&time,&timeref,&data,&dataref,reltol,rangeDelta,reltolDiffMaxMin,&ddf,cmpdiffvars,vardiffindx,keepEqualResults,&res,resultfilename,0,0);
-    }
-    /* free */
-    if (dataref.data) {
-      free(dataref.data);
-    }
-    if (data.data) {
-      free(data.data);
-    }
-    if (var1) {
-      GC_free(var1);
-      var1 = NULL;
+      vardiffindx = cmpData(isResultCmp,v.var,&time,&timeref,&v.data,&v.dataref,reltol,abstol,&ddf,cmpdiffvars,vardiffindx,keepEqualResults,&res,resultfilename);
+      freeCmpVariable(&v);
     }
+  } else {
+    vardiffindx = cmpTubesInBatches(cmpvars,ncmpvars,&ngetfailedvars,filename,reffilename,size,size_ref,suggestReadAll,offset,offsetRef,runningTestsuite,&time,&timeref,reltol,rangeDelta,reltolDiffMaxMin,cmpdiffvars,vardiffindx,keepEqualResults,&res,resultfilename,isHtml,htmlOut);
   }
+  cmpStatistics.seconds = rt_ext_tp_tock(&cmpClock);
 
   if (isResultCmp) {
     if (writeLogFile(resultfilename,&ddf,filename,reffilename,reltol,abstol)) {
@@ -793,8 +975,6 @@ void* SimulationResultsCmp_compareResults(int isResultCmp, int runningTestsuite,
     }
   }
 
-  // if (var1) free(var1);
-  // if (var2) free(var2);
   if (ddf.data) free(ddf.data);
   if (cmpvars) GC_free(cmpvars);
   if (time.data) free(time.data);
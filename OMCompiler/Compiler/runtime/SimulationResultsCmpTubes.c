@@ -638,50 +638,71 @@ static double* validate(int n, addTargetEventTimesRes ref, double *low, double *
   return NULL;
 }
 
-static unsigned int cmpDataTubes(int isResultCmp, char* varname, DataField *time, DataField *reftime, DataField *data, DataField *refdata, double reltol, double rangeDelta, double reltolDiffMaxMin, DiffDataField *ddf, char **cmpdiffvars, unsigned int vardiffindx, int keepEqualResults, void **diffLst, const char *prefix, int isHtml, char **htmlOut)
+/* The tubes of one variable. Calculated by calculateTubeComparison without
+ * touching any shared state, so that several variables can be compared in parallel;
+ * the results are then written in variable order by writeTubeComparison. */
+typedef struct {
+  addTargetEventTimesRes ref,actual,actualoriginal;
+  privates *priv;
+  size_t n;
+  double *calibrated_values,*high,*low,*error,abstol;
+  double *reftime; /* calculateTubes moves points at events; each variable gets its own copy of the reference time */
+} tubeComparison;
+
+static void calculateTubeComparison(tubeComparison *cmp, DataField *time, DataField *reftime, DataField *data, DataField *refdata, double reltol, double rangeDelta, double reltolDiffMaxMin)
 {
   int withTubes = 0 == rangeDelta;
-  FILE *fout = NULL;
-  char *fname = NULL;
-  char *html;
   /* The tolerance for detecting events is proportional to the number of output points in the file */
   double xabstol = (reftime->data[reftime->n-1]-reftime->data[0])*(withTubes ? rangeDelta : 1e-3) / fmax(time->n,reftime->n);
   /* Calculate the tubes without additional events added */
-  addTargetEventTimesRes ref,actual,actualoriginal;
   privates *priv=NULL;
-  size_t n,maxn,html_size=0;
-  double *calibrated_values=NULL, *high=NULL, *low=NULL, *error=NULL,maxPlusTol,minMinusTol,abstol;
-
-  ref.values = refdata->data;
-  ref.time = reftime->data;
-  ref.size = reftime->n;
-  actualoriginal.values = data->data;
-  actualoriginal.time = time->data;
-  actualoriginal.size = time->n;
-  actual = actualoriginal;
+  size_t n;
+
+  cmp->reftime = (double*) omc_alloc_interface.malloc_atomic(sizeof(double)*reftime->n);
+  memcpy(cmp->reftime, reftime->data, sizeof(double)*reftime->n);
+  cmp->ref.values = refdata->data;
+  cmp->ref.time = cmp->reftime;
+  cmp->ref.size = reftime->n;
+  cmp->actualoriginal.values = data->data;
+  cmp->actualoriginal.time = time->data;
+  cmp->actualoriginal.size = time->n;
+  cmp->actual = cmp->actualoriginal;
   /* assertMonotonic(ref); */
   /* assertMonotonic(actual); */
   /* ref = removeUneventfulPoints(ref, reltol*reltol, xabstol); */
   /* actual = removeUneventfulPoints(actual, reltol*reltol, xabstol); */
   /* assertMonotonic(ref); */
   /* assertMonotonic(actual); */
-  priv = withTubes ? skipCalculateTubes(ref.time,ref.values,ref.size) : calculateTubes(ref.time,ref.values,ref.size,rangeDelta);
+  priv = withTubes ? skipCalculateTubes(cmp->ref.time,cmp->ref.values,cmp->ref.size) : calculateTubes(cmp->ref.time,cmp->ref.values,cmp->ref.size,rangeDelta);
   /* ref = mergeTimelines(ref,actual,xabstol); */
   /* assertMonotonic(ref); */
-  n = ref.size;
-  calibrated_values = calibrateValues(ref.time,actual.time,actual.values,&n,actual.size,xabstol);
-  maxPlusTol = priv->max + fabs(priv->max) * reltol;
-  minMinusTol = priv->min - fabs(priv->min) * reltol;
-  high = calibrateValues(ref.time,priv->xHigh,priv->yHigh,&n,priv->countHigh,xabstol);
-  low  = calibrateValues(ref.time,priv->xLow,priv->yLow,&n,priv->countLow,xabstol);
+  n = cmp->ref.size;
+  cmp->calibrated_values = calibrateValues(cmp->ref.time,cmp->actual.time,cmp->actual.values,&n,cmp->actual.size,xabstol);
+  cmp->high = calibrateValues(cmp->ref.time,priv->xHigh,priv->yHigh,&n,priv->countHigh,xabstol);
+  cmp->low  = calibrateValues(cmp->ref.time,priv->xLow,priv->yLow,&n,priv->countLow,xabstol);
   /* If all values in the reference are ~0 (and the same)... Allow reltolDiffMaxMin^2 as tolerance
    * Maybe we should just treat it differently though
    * Like not creating a tubes and simply check that the other file also has only identical points close to this
    */
-  abstol = (priv->max-priv->min == 0 && priv->max < reltolDiffMaxMin*reltolDiffMaxMin) ? reltolDiffMaxMin*reltolDiffMaxMin : fabs((priv->max-priv->min)*reltolDiffMaxMin);
-  addRelativeTolerance(high,ref.values,n,reltol,abstol,1);
-  addRelativeTolerance(low ,ref.values,n,reltol,abstol,-1);
-  error = validate(n,ref,low,high,calibrated_values,reltol,abstol,xabstol);
+  cmp->abstol = (priv->max-priv->min == 0 && priv->max < reltolDiffMaxMin*reltolDiffMaxMin) ? reltolDiffMaxMin*reltolDiffMaxMin : fabs((priv->max-priv->min)*reltolDiffMaxMin);
+  addRelativeTolerance(cmp->high,cmp->ref.values,n,reltol,cmp->abstol,1);
+  addRelativeTolerance(cmp->low ,cmp->ref.values,n,reltol,cmp->abstol,-1);
+  cmp->error = validate(n,cmp->ref,cmp->low,cmp->high,cmp->calibrated_values,reltol,cmp->abstol,xabstol);
+  cmp->priv = priv;
+  cmp->n = n;
+}
+
+static unsigned int writeTubeComparison(tubeComparison *cmp, int isResultCmp, char* varname, DataField *time, DataField *reftime, double reltol, double rangeDelta, double reltolDiffMaxMin, char **cmpdiffvars, unsigned int vardiffindx, int keepEqualResults, void **diffLst, const char *prefix, int isHtml, char **htmlOut)
+{
+  int withTubes = 0 == rangeDelta;
+  FILE *fout = NULL;
+  char *fname = NULL;
+  char *html;
+  addTargetEventTimesRes ref = cmp->ref, actual = cmp->actual, actualoriginal = cmp->actualoriginal;
+  privates *priv = cmp->priv;
+  size_t n = cmp->n,maxn,html_size=0;
+  double *calibrated_values = cmp->calibrated_values, *high = cmp->high, *low = cmp->low, *error = cmp->error, abstol = cmp->abstol;
+
   if ( isHtml ) {
 
 #if _XOPEN_SOURCE >= 700 || _POSIX_C_SOURCE >= 200809L
@@ -860,5 +881,6 @@ fprintf(fout, "{title: '%s',\n"
   GC_free(priv->yLow);
   GC_free(priv);
   GC_free(calibrated_values);
+  GC_free(cmp->reftime);
   return vardiffindx;
 }
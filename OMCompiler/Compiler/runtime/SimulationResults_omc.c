@@ -94,6 +94,13 @@ const char* SimulationResults_diffSimulationResultsHtml(int runningTestsuite, co
   return res;
 }
 
+void SimulationResults_diffStatistics(int *numVars, double *megaBytes, double *seconds)
+{
+  *numVars = cmpStatistics.numVars;
+  *megaBytes = cmpStatistics.bytes / (1024.0*1024.0);
+  *seconds = cmpStatistics.seconds;
+}
+
 void SimulationResults_close()
 {
   SimulationResultsImpl__close(&simresglob);
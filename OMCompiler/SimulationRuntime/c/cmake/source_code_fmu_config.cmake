@@ -24,6 +24,7 @@ set(SOURCE_FMU_COMMON_FILES_LIST ./gc/memory_pool.c
                                  ./util/index_spec.c
                                  ./util/integer_array.c
                                  ./util/list.c
+                                 ./util/matrix_kernels.c
                                  ./util/modelica_string_lit.c
                                  ./util/modelica_string.c
                                  ./util/ModelicaUtilities.c
@@ -158,6 +159,7 @@ set(SOURCE_FMU_COMMON_HEADERS \"./omc_inline.h\",
                               \"./util/utility.h\",
                               \"./util/varinfo.h\",
                               \"./util/list.h\",
+                              \"./util/matrix_kernels.h\",
                               \"./util/doubleEndedList.h\",
                               \"./util/rational.h\",
                               \"./util/modelica_string_lit.h\",
@@ -54,6 +54,10 @@ target_link_libraries(OpenModelicaRuntimeC PUBLIC OMCPThreads::OMCPThreads)
 target_link_libraries(OpenModelicaRuntimeC PUBLIC omc::3rd::omcgc)
 target_link_libraries(OpenModelicaRuntimeC PUBLIC omc::3rd::ryu)
 
+# Large matrix products of the array library (util/matrix_kernels.c) are passed to BLAS.
+target_compile_definitions(OpenModelicaRuntimeC PRIVATE USE_BLAS)
+target_link_libraries(OpenModelicaRuntimeC PUBLIC ${LAPACK_LIBRARIES})
+
 if(MINGW)
   target_link_libraries(OpenModelicaRuntimeC PUBLIC dbghelp)
   target_link_libraries(OpenModelicaRuntimeC PUBLIC regex)
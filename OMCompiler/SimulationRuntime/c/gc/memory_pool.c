@@ -52,15 +52,51 @@ extern "C" {
 #define OMC_ERROR_AT_EXPAND_REQUEST 1024*OMC_MEGABYTE
 
 
-/// This is the pointer to the current block of memory. The 'memory pool'.
-/// It changes when the program requests memory space that does not fit
-/// in the current block. In which case a new block will be created and
-/// this will be updated. Restoring a saved state (a cleanup operation)
-/// will also update this.
-OMCMemPoolBlock *memory_pools = NULL;
-
+static void free_pool_blocks(OMCMemPoolBlock *block);
+
+/// Every thread has its own pool. The current block of the calling thread
+/// is stored in a thread-specific key, so allocations only bump the used
+/// amount of a block owned by this thread and do not need a lock.
+/// The current block changes when the program requests memory space that
+/// does not fit in it. In which case a new block will be created and
+/// the key will be updated. Restoring a saved state (a cleanup operation)
+/// will also update it. The blocks are freed when the thread exits.
 #if defined(OM_HAVE_PTHREADS)
-static pthread_mutex_t memory_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t memory_pool_key;
+static pthread_once_t memory_pool_once = PTHREAD_ONCE_INIT;
+
+static void memory_pool_thread_exit(void *block)
+{
+  free_pool_blocks((OMCMemPoolBlock*) block);
+}
+
+static void memory_pool_key_init(void)
+{
+  pthread_key_create(&memory_pool_key, memory_pool_thread_exit);
+}
+
+static inline OMCMemPoolBlock* current_pool(void)
+{
+  pthread_once(&memory_pool_once, memory_pool_key_init);
+  return (OMCMemPoolBlock*) pthread_getspecific(memory_pool_key);
+}
+
+static inline void set_current_pool(OMCMemPoolBlock *block)
+{
+  pthread_setspecific(memory_pool_key, block);
+}
+#else
+static OMCMemPoolBlock *memory_pools = NULL;
+
+static inline OMCMemPoolBlock* current_pool(void)
+{
+  return memory_pools;
+}
+
+static inline void set_current_pool(OMCMemPoolBlock *block)
+{
+  memory_pools = block;
+}
 #endif
 
 static int GC_collect_a_little_or_not(void)
@@ -68,15 +104,22 @@ static int GC_collect_a_little_or_not(void)
   return 0;
 }
 
+static OMCMemPoolBlock* pool_create(void)
+{
+  OMCMemPoolBlock *block = (OMCMemPoolBlock*) omc_alloc_interface.malloc_uncollectable(sizeof(OMCMemPoolBlock));
+  block->used = 0;
+  block->size = OMC_INITIAL_BLOCK_SIZE;
+  block->memory = omc_alloc_interface.malloc_uncollectable(block->size);
+  block->previous = NULL;
+  set_current_pool(block);
+  return block;
+}
+
 static void pool_init(void)
 {
   // pool_init is called unconditionally in fmi2Instantiate, so let's put the condition here
-  if (!memory_pools) {
-    memory_pools = (OMCMemPoolBlock*) omc_alloc_interface.malloc_uncollectable(sizeof(OMCMemPoolBlock));
-    memory_pools->used = 0;
-    memory_pools->size = OMC_INITIAL_BLOCK_SIZE;
-    memory_pools->memory = omc_alloc_interface.malloc_uncollectable(memory_pools->size);
-    memory_pools->previous = NULL;
+  if (!current_pool()) {
+    pool_create();
   }
 }
 
@@ -85,12 +128,15 @@ static inline size_t round_up(size_t num, size_t factor)
   return num + factor - 1 - ((num + factor - 1) % factor);
 }
 
-static inline void pool_expand(size_t len)
+static inline OMCMemPoolBlock* pool_expand(OMCMemPoolBlock *pool, size_t len)
 {
   OMCMemPoolBlock *newBlock = NULL;
 
   // The new block will be 1.5x the current block's size. More if we request a very large array.
-  size_t new_size = 3*memory_pools->size / 2;
+  size_t new_size = 3*pool->size / 2;
+  if (new_size < len) {
+    new_size = len;
+  }
   // Align the new size to the initial block size (2MB right now) for easier debugging.
   new_size = round_up(new_size, OMC_INITIAL_BLOCK_SIZE);
 
@@ -104,35 +150,31 @@ static inline void pool_expand(size_t len)
   newBlock->used = 0;
   newBlock->size = new_size;
   newBlock->memory = omc_alloc_interface.malloc_uncollectable(newBlock->size);
-  newBlock->previous = memory_pools;
-  memory_pools = newBlock;
+  newBlock->previous = pool;
+  set_current_pool(newBlock);
+  return newBlock;
 }
 
 static void* pool_malloc(size_t requested_size)
 {
   void *res;
+  OMCMemPoolBlock *pool = current_pool();
   requested_size = round_up(requested_size, 8);
 
-#if defined(OM_HAVE_PTHREADS)
-  pthread_mutex_lock(&memory_pool_mutex);
-#endif
-
   /// If we forgot to explicitly initialize the pool, initialize it now.
-  pool_init();
+  if (!pool) {
+    pool = pool_create();
+  }
 
   /// If the current block does not have enough remaining space, expand the pool
   /// by creating another block. The new block should, at least, be as big as
-  /// the requested size. Note that, this will update the global memory_pools pointer.
-  if (memory_pools->size - memory_pools->used < requested_size) {
-    pool_expand(requested_size);
+  /// the requested size. Note that, this will update the current block of this thread.
+  if (pool->size - pool->used < requested_size) {
+    pool = pool_expand(pool, requested_size);
   }
 
-  res = (void*)((char*)memory_pools->memory + memory_pools->used);
-  memory_pools->used += requested_size;
-
-#if defined(OM_HAVE_PTHREADS)
-  pthread_mutex_unlock(&memory_pool_mutex);
-#endif
+  res = (void*)((char*)pool->memory + pool->used);
+  pool->used += requested_size;
 
   memset(res, 0, requested_size);
   return res;
@@ -151,22 +193,26 @@ static void print_mem_pool(OMCMemPoolBlock* chunk) {
 
 MemPoolState omc_util_get_pool_state() {
   MemPoolState state;
+  OMCMemPoolBlock *pool = current_pool();
   /// If we forgot to explicitly initialize the pool, initialize it now.
-  pool_init();
+  if (!pool) {
+    pool = pool_create();
+  }
 
-  state.block = memory_pools;
-  state.used = memory_pools->used;
+  state.block = pool;
+  state.used = pool->used;
 
   return state;
 }
 
 void omc_util_restore_pool_state(MemPoolState in_state) {
   // printf("original state:\n");
-  // print_mem_pool(memory_pools);
+  // print_mem_pool(current_pool());
 
   assert(in_state.block);
 
-  OMCMemPoolBlock* currentBlock = memory_pools;
+  /// The state has to be restored by the thread that created it.
+  OMCMemPoolBlock* currentBlock = current_pool();
   /// Start from the current block and traverse the chain until we find the block
   /// that was saved in the state.
   /// Clean up the blocks as we go since they will no longer be reachable after updating
@@ -184,16 +230,14 @@ void omc_util_restore_pool_state(MemPoolState in_state) {
   assert(currentBlock);
 
   currentBlock->used = in_state.used;
-  memory_pools = currentBlock;
+  set_current_pool(currentBlock);
 
   // printf("updated state:\n");
-  // print_mem_pool(memory_pools);
+  // print_mem_pool(current_pool());
 }
 
-void free_memory_pool()
+static void free_pool_blocks(OMCMemPoolBlock *currentBlock)
 {
-  OMCMemPoolBlock* currentBlock = memory_pools;
-
   while (currentBlock) {
     OMCMemPoolBlock* previous = currentBlock->previous;
     omc_alloc_interface.free_uncollectable(currentBlock->memory);
@@ -204,8 +248,12 @@ void free_memory_pool()
     omc_alloc_interface.free_uncollectable(currentBlock);
     currentBlock = previous;
   }
+}
 
-  memory_pools = NULL;
+void free_memory_pool()
+{
+  free_pool_blocks(current_pool());
+  set_current_pool(NULL);
 }
 
 static void nofree(void* ptr)
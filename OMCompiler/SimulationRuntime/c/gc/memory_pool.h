@@ -43,6 +43,8 @@ extern "C" {
 /// chink of memory space to be used for requests by the program. It knows the size
 /// of the chunk and keeps track of how much of it used currently. Each block also has
 /// a pointer to the previous block.
+/// Every thread allocates from its own pool, so the functions below only act on the
+/// pool of the calling thread.
 typedef struct OMCMemPoolBlock_s {
   void *memory;
   size_t used;
@@ -62,8 +64,9 @@ typedef struct {
 /// @brief Get the current state of the pool (the current block and used amount in that block)
 MemPoolState omc_util_get_pool_state();
 /// @brief Restors the memory pool to a given state (specifc block and used amount in that block).
+/// The state has to be restored by the same thread that got it.
 void omc_util_restore_pool_state(MemPoolState in_state_v);
-/// @brief Completely cleans up the memory pool by deleting all blocks.
+/// @brief Completely cleans up the memory pool of the calling thread by deleting all blocks.
 void free_memory_pool();
 
 
@@ -31,9 +31,18 @@
 /*! File jac_util.c
  */
 
+#ifdef USE_PARJAC
+  #define GC_THREADS
+  #include "../gc/omc_gc.h"
+#endif
+
+#include <string.h>
+
 #include "jacobian_util.h"
 #include "options.h"
+#include "../util/context.h"
 #include "../util/omc_file.h"
+#include "../util/parallel_helper.h"
 
 /**
  * @brief Initialize analytic jacobian.
@@ -99,6 +108,216 @@ void freeAnalyticJacobian(ANALYTIC_JACOBIAN *jac) {
   free(jac->sparsePattern); jac->sparsePattern = NULL;
 }
 
+/**
+ * @brief Allocate colored evaluation of an analytic Jacobian.
+ *
+ * Groups the columns of the sparsity pattern by color and allocates
+ * the thread local Jacobians. All thread local Jacobians share the sparsity
+ * pattern and constant equations of `jacobian`, only seed, temporary and result
+ * vectors are private. The first thread uses `jacobian` itself.
+ *
+ * @param jacobian              Analytic Jacobian with sparsity pattern.
+ * @param nThreads              Maximum number of threads used in evalColoredJacobian.
+ *                              Use 1 if the column function is not thread safe.
+ * @param useColoring           If false every column is evaluated on its own.
+ * @return COLORED_JACOBIAN*    Colored Jacobian, free with freeColoredJacobian.
+ */
+COLORED_JACOBIAN* allocColoredJacobian(ANALYTIC_JACOBIAN* jacobian, int nThreads, modelica_boolean useColoring) {
+  COLORED_JACOBIAN* coloredJac = (COLORED_JACOBIAN*) malloc(sizeof(COLORED_JACOBIAN));
+  SPARSE_PATTERN* spp = jacobian->sparsePattern;
+  unsigned int columns = jacobian->sizeCols;
+  unsigned int i, color;
+  int th;
+
+  coloredJac->jacobian = jacobian;
+  coloredJac->nColors = useColoring ? spp->maxColors : columns;
+  coloredJac->colorStart = (unsigned int*) calloc(coloredJac->nColors+1, sizeof(unsigned int));
+  coloredJac->columns = (unsigned int*) malloc(columns*sizeof(unsigned int));
+
+  if (useColoring) {
+    /* Counting sort of the columns by color, colors start at 1 */
+    for (i = 0; i < columns; i++) {
+      color = spp->colorCols[i];
+      if (color > 0 && color <= coloredJac->nColors) {
+        coloredJac->colorStart[color]++;
+      }
+    }
+    for (color = 0; color < coloredJac->nColors; color++) {
+      coloredJac->colorStart[color+1] += coloredJac->colorStart[color];
+    }
+    for (i = 0; i < columns; i++) {
+      color = spp->colorCols[i];
+      if (color > 0 && color <= coloredJac->nColors) {
+        coloredJac->columns[coloredJac->colorStart[color-1]++] = i;
+      }
+    }
+    /* colorStart[i] now points to the start of color i+1, shift back */
+    for (color = coloredJac->nColors; color > 0; color--) {
+      coloredJac->colorStart[color] = coloredJac->colorStart[color-1];
+    }
+    coloredJac->colorStart[0] = 0;
+  } else {
+    for (i = 0; i < columns; i++) {
+      coloredJac->colorStart[i] = i;
+      coloredJac->columns[i] = i;
+    }
+    coloredJac->colorStart[columns] = columns;
+  }
+
+  coloredJac->nJacobians = nThreads < omc_get_max_threads() ? nThreads : omc_get_max_threads();
+  if (coloredJac->nJacobians < 1) {
+    coloredJac->nJacobians = 1;
+  }
+  coloredJac->jacobians = (ANALYTIC_JACOBIAN**) malloc(coloredJac->nJacobians*sizeof(ANALYTIC_JACOBIAN*));
+  coloredJac->jacobians[0] = jacobian;
+  for (th = 1; th < coloredJac->nJacobians; th++) {
+    coloredJac->jacobians[th] = copyAnalyticJacobian(jacobian);
+  }
+
+  return coloredJac;
+}
+
+/**
+ * @brief Free colored Jacobian.
+ *
+ * Frees the thread local Jacobians, but not the Jacobian they were copied from
+ * and not the shared sparsity pattern.
+ *
+ * @param coloredJac  Pointer to colored Jacobian, can be NULL.
+ */
+void freeColoredJacobian(COLORED_JACOBIAN* coloredJac) {
+  int th;
+
+  if (coloredJac == NULL) {
+    return;
+  }
+  for (th = 1; th < coloredJac->nJacobians; th++) {
+    free(coloredJac->jacobians[th]->seedVars);
+    free(coloredJac->jacobians[th]->tmpVars);
+    free(coloredJac->jacobians[th]->resultVars);
+    free(coloredJac->jacobians[th]);
+  }
+  free(coloredJac->jacobians);
+  free(coloredJac->colorStart);
+  free(coloredJac->columns);
+  free(coloredJac);
+}
+
+/**
+ * @brief Evaluate analytic Jacobian color by color.
+ *
+ * Every color is an independent task: the seed vector of a thread local
+ * Jacobian is set for the columns of that color, the column function is
+ * evaluated once and the non-zero elements of these columns are scattered
+ * into `matrix` with `setJacElement`. With more than one thread local Jacobian
+ * the colors are distributed over OpenMP threads.
+ *
+ * Constant equations of coloredJac->jacobian have to be evaluated by the caller,
+ * they are repeated here for the other thread local Jacobians.
+ * Elements not in the sparsity pattern are not touched, so `matrix` has to be
+ * zeroed by the caller if needed.
+ *
+ * @param data            Runtime data struct.
+ * @param threadData      Thread data for error handling.
+ * @param coloredJac      Colored Jacobian.
+ * @param jacobianColumn  Function evaluating the Jacobian for the current seed vector.
+ * @param matrix          Matrix to store Jacobian in, passed to setJacElement.
+ * @param setJacElement   Function to set element (i,j) in matrix.
+ */
+void evalColoredJacobian(DATA* data, threadData_t* threadData, COLORED_JACOBIAN* coloredJac,
+                         analyticalJacobianColumn_func_ptr jacobianColumn,
+                         void* matrix, setJacElementFunc setJacElement)
+{
+  const SPARSE_PATTERN* spp = coloredJac->jacobian->sparsePattern;
+  const int rows = coloredJac->jacobian->sizeRows;
+  const int nColors = coloredJac->nColors;
+  const int sequential = coloredJac->nJacobians == 1;
+  int color;
+
+#ifdef USE_PARJAC
+  GC_allow_register_threads();
+#endif
+
+#pragma omp parallel num_threads(coloredJac->nJacobians) if(!sequential) default(none) \
+                     shared(data, threadData, coloredJac, jacobianColumn, matrix, setJacElement, spp) \
+                     firstprivate(rows, nColors, sequential) private(color)
+{
+#ifdef USE_PARJAC
+  /* Register omp-thread in GC */
+  if(!GC_thread_is_registered()) {
+     struct GC_stack_base sb;
+     memset (&sb, 0, sizeof(sb));
+     GC_get_stack_base(&sb);
+     GC_register_my_thread (&sb);
+  }
+#endif
+  ANALYTIC_JACOBIAN* t_jac = coloredJac->jacobians[omc_get_thread_num()];
+  unsigned int k, col, nth;
+
+  if (t_jac != coloredJac->jacobian) {
+    t_jac->dae_cj = coloredJac->jacobian->dae_cj;
+    if (t_jac->constantEqns != NULL) {
+      t_jac->constantEqns(data, threadData, t_jac, NULL);
+    }
+  }
+
+#pragma omp for schedule(dynamic)
+  for (color = 0; color < nColors; color++) {
+    /* Set seed vector for current color */
+    for (k = coloredJac->colorStart[color]; k < coloredJac->colorStart[color+1]; k++) {
+      t_jac->seedVars[coloredJac->columns[k]] = 1.0;
+    }
+
+    jacobianColumn(data, threadData, t_jac, NULL);
+    if (sequential) {
+      increaseJacContext(data);
+    }
+
+    /* Scatter columns of current color and reset seed vector */
+    for (k = coloredJac->colorStart[color]; k < coloredJac->colorStart[color+1]; k++) {
+      col = coloredJac->columns[k];
+      for (nth = spp->leadindex[col]; nth < spp->leadindex[col+1]; nth++) {
+        setJacElement(spp->index[nth], col, nth, t_jac->resultVars[spp->index[nth]], matrix, rows);
+      }
+      t_jac->seedVars[col] = 0.0;
+    }
+  }
+} // omp parallel
+}
+
+/**
+ * @brief Set element of dense Jacobian stored in column-major order.
+ *
+ * Jac(row, column) = val.
+ *
+ * @param row       Row of matrix element.
+ * @param column    Column of matrix element.
+ * @param nth       Sparsity pattern lead index, unused.
+ * @param value     Value to set in position (i,j).
+ * @param Jac       Pointer to double array storing matrix.
+ * @param nRows     Number of rows of Jacobian matrix.
+ */
+void setJacElementDense(int row, int column, int nth, double value, void* Jac, int nRows) {
+  ((double*) Jac)[column*nRows + row] = value;
+}
+
+/**
+ * @brief Set element of sparse Jacobian stored in compressed sparse column format.
+ *
+ * The column pointers and row indices are the ones of the sparsity pattern,
+ * so only the value array has to be written, e.g. Ax of a KLU matrix.
+ *
+ * @param row       Row of matrix element, unused.
+ * @param column    Column of matrix element, unused.
+ * @param nth       Sparsity pattern lead index.
+ * @param value     Value to set in position (i,j).
+ * @param Jac       Pointer to double array storing the non-zero values.
+ * @param nRows     Number of rows of Jacobian matrix, unused.
+ */
+void setJacElementCSC(int row, int column, int nth, double value, void* Jac, int nRows) {
+  ((double*) Jac)[nth] = value;
+}
+
 /**
  * @brief Allocate memory for sparsity pattern.
  *
@@ -40,10 +40,49 @@
 extern "C" {
 #endif
 
+/**
+ * @brief Set element of Jacobian matrix.
+ *
+ * Jac(row, column) = val.
+ *
+ * @param row       Row of matrix element.
+ * @param column    Column of matrix element.
+ * @param nth       Sparsity pattern lead index.
+ * @param value     Value to set in position (i,j).
+ * @param Jac       Pointer to data structure storing matrix.
+ * @param nRows     Number of rows of Jacobian matrix.
+ */
+typedef void (*setJacElementFunc)(int row, int column, int nth, double value, void* Jac, int nRows);
+
+/**
+ * @brief Colored evaluation of an analytic Jacobian.
+ *
+ * Columns of the sparsity pattern grouped by color and one analytic Jacobian
+ * per thread, so that every color can be evaluated as an independent task.
+ * Use allocColoredJacobian and freeColoredJacobian for construction and destruction.
+ */
+typedef struct COLORED_JACOBIAN
+{
+  ANALYTIC_JACOBIAN* jacobian;    /* Jacobian the thread local copies were made from */
+  unsigned int nColors;           /* Number of column groups */
+  unsigned int* colorStart;       /* Columns of group i are columns[colorStart[i]], ..., columns[colorStart[i+1]-1], size nColors+1 */
+  unsigned int* columns;          /* Column indices sorted by group, size jacobian->sizeCols */
+  int nJacobians;                 /* Number of threads evaluating groups in parallel */
+  ANALYTIC_JACOBIAN** jacobians;  /* Thread local Jacobians, jacobians[0] is jacobian itself, size nJacobians */
+} COLORED_JACOBIAN;
+
 void initAnalyticJacobian(ANALYTIC_JACOBIAN* jacobian, unsigned int sizeCols, unsigned int sizeRows, unsigned int sizeTmpVars, int (*constantEqns)(void* data, threadData_t *threadData, void* thisJacobian, void* parentJacobian), SPARSE_PATTERN* sparsePattern);
 ANALYTIC_JACOBIAN* copyAnalyticJacobian(ANALYTIC_JACOBIAN* source);
 void freeAnalyticJacobian(ANALYTIC_JACOBIAN* jac);
 
+COLORED_JACOBIAN* allocColoredJacobian(ANALYTIC_JACOBIAN* jacobian, int nThreads, modelica_boolean useColoring);
+void freeColoredJacobian(COLORED_JACOBIAN* coloredJac);
+void evalColoredJacobian(DATA* data, threadData_t* threadData, COLORED_JACOBIAN* coloredJac,
+                         analyticalJacobianColumn_func_ptr jacobianColumn,
+                         void* matrix, setJacElementFunc setJacElement);
+void setJacElementDense(int row, int column, int nth, double value, void* Jac, int nRows);
+void setJacElementCSC(int row, int column, int nth, double value, void* Jac, int nRows);
+
 SPARSE_PATTERN* allocSparsePattern(unsigned int n_leadIndex, unsigned int numberOfNonZeros, unsigned int maxColors);
 void freeSparsePattern(SPARSE_PATTERN *spp);
 FILE * openSparsePatternFile(DATA* data, threadData_t *threadData, const char* filename);
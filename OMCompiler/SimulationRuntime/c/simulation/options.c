@@ -31,6 +31,7 @@
 #include "options.h"
 #include "../util/omc_error.h"
 #include "simulation_runtime.h"
+#include "simulation_log_binary.h"
 
 #include <string.h>
 #include <stdio.h>
@@ -52,6 +53,30 @@ int helpFlagSet(int argc, char** argv)
 }
 
 #if !defined(OMC_MINIMAL_RUNTIME)
+/* <executable>_log.bin in the output path (-outputPath) or the working directory */
+static const char* binaryLogFileName(const char *executable)
+{
+  static char fileName[4096];
+  const char *base = strrchr(executable, '/');
+  const char *baseWin = strrchr(executable, '\\');
+  size_t length;
+
+  if (baseWin && (!base || baseWin > base)) {
+    base = baseWin;
+  }
+  base = base ? base + 1 : executable;
+  length = strlen(base);
+  if (length > 4 && 0 == strcmp(base + length - 4, ".exe")) {
+    length -= 4;
+  }
+  if (omc_flag[FLAG_OUTPUT_PATH]) {
+    snprintf(fileName, sizeof(fileName), "%s/%.*s_log.bin", omc_flagValue[FLAG_OUTPUT_PATH], (int) length, base);
+  } else {
+    snprintf(fileName, sizeof(fileName), "%.*s_log.bin", (int) length, base);
+  }
+  return fileName;
+}
+
 int setLogFormat(int argc, char** argv)
 {
   const char* value = getOption(FLAG_NAME[FLAG_LOG_FORMAT], argc, argv);
@@ -66,8 +91,15 @@ int setLogFormat(int argc, char** argv)
       setStreamPrintXML(2);
     } else if (0 == strcmp(value, "text")) {
       setStreamPrintXML(0);
+    } else if (0 == strcmp(value, "binary")) {
+      /* the forked batch runs have no writer thread, they log to text files */
+      if (omc_flag[FLAG_BATCH]) {
+        warningStreamPrint(LOG_STDOUT, 0, "-logFormat=binary can not be used together with -batch");
+        return 1;
+      }
+      return openBinaryLog(binaryLogFileName(argv[0]));
     } else {
-      warningStreamPrint(LOG_STDOUT, 0, "invalid command line option: -logFormat=%s, expected text, xml, or xmltcp", value);
+      warningStreamPrint(LOG_STDOUT, 0, "invalid command line option: -logFormat=%s, expected text, xml, xmltcp or binary", value);
       return 1;
     }
   }
@@ -29,6 +29,7 @@
  */
 
 #include "simulation_result.h"
+#include "util/rtclock.h"
 
 extern "C" {
 
@@ -46,6 +47,41 @@ simulation_result sim_result = {
   sim_result_doNothing, /* emit */
   sim_result_doNothing, /* writeParam */
   sim_result_doNothing, /* free */
+  0, /* emitInBackground */
+  0.0 /* emitCpuTime */
 };
 
+/**
+ * @brief Start the output timer for an emitted row.
+ *
+ * The timers belong to the solver thread. If emit runs in the writer thread
+ * of -asyncOutput no timer is used and the cpu time recorded by the solver
+ * thread is returned instead.
+ *
+ * @param self  Simulation result.
+ * @return      Value of $cpuTime for the row.
+ */
+double sim_result_startEmit(simulation_result *self)
+{
+  double cpuTimeValue;
+
+  if (self->emitInBackground)
+    return self->emitCpuTime;
+
+  rt_tick(SIM_TIMER_OUTPUT);
+  rt_accumulate(SIM_TIMER_TOTAL);
+  cpuTimeValue = rt_accumulated(SIM_TIMER_TOTAL);
+  rt_tick(SIM_TIMER_TOTAL);
+  return cpuTimeValue;
+}
+
+/**
+ * @brief Stop the output timer started by sim_result_startEmit.
+ */
+void sim_result_endEmit(simulation_result *self)
+{
+  if (!self->emitInBackground)
+    rt_accumulate(SIM_TIMER_OUTPUT);
+}
+
 }
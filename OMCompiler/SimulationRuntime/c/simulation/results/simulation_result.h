@@ -47,10 +47,15 @@ typedef struct simulation_result {
   void (*emit)(struct simulation_result*,DATA*,threadData_t *threadData);
   void (*writeParameterData)(struct simulation_result*,DATA*,threadData_t *threadData);
   void (*free)(struct simulation_result*,DATA*,threadData_t *threadData);
+  int emitInBackground; /* emit runs in the writer thread of -asyncOutput, see simulation_result_async.h */
+  double emitCpuTime; /* $cpuTime of the row emitted in the background */
 } simulation_result;
 
 extern simulation_result sim_result;
 
+double sim_result_startEmit(simulation_result *self);
+void sim_result_endEmit(simulation_result *self);
+
 #ifdef __cplusplus
 }
 #endif /* cplusplus */
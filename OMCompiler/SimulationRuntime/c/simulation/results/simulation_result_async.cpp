@@ -0,0 +1,384 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+#include "util/omc_error.h"
+#include "util/rtclock.h"
+#include "simulation/options.h"
+#include "simulation_result_async.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#if defined(OM_HAVE_PTHREADS)
+#include <pthread.h>
+#include <sys/time.h>
+#endif
+
+/* memory used for queued rows, the ring has at least 2 and at most
+ * ASYNC_OUTPUT_MAX_ROWS slots */
+#define ASYNC_OUTPUT_BUFFER_SIZE (32*1024*1024)
+#define ASYNC_OUTPUT_MAX_ROWS 4096
+/* the writer thread looks for queued rows at least this often [ms] */
+#define ASYNC_OUTPUT_WAIT_MS 100
+
+extern "C" {
+
+#if defined(OM_HAVE_PTHREADS)
+
+/* Copy of everything the result backends read from DATA at an output step */
+typedef struct async_slot {
+  SIMULATION_DATA sData;
+  double cpuTime;
+  double solverSteps;
+  modelica_real *sensitivityMatrix;
+} async_slot;
+
+/* Writer state of one simulation_result, kept in its storage */
+typedef struct async_output {
+  /* the wrapped backend with its own storage, emit runs in the writer thread */
+  simulation_result inner;
+
+  async_slot *slots;
+  size_t nSlots;
+  size_t batchSize;      /* number of queued rows that wakes up the writer */
+  size_t head;           /* rows queued so far */
+  size_t tail;           /* rows written so far */
+  unsigned long stalls;  /* number of times emit had to wait for a free slot */
+  int running;
+  int stop;
+  int failed;
+
+  /* DATA as seen by the wrapped backend in the writer thread */
+  DATA shadowData;
+  SIMULATION_INFO shadowInfo;
+  SIMULATION_DATA *shadowLocalData[1];
+
+  pthread_t thread;
+  pthread_mutex_t mutex;
+  pthread_cond_t rowsQueued;
+  pthread_cond_t rowsWritten;
+} async_output;
+
+static void writeSlot(async_output *out, size_t row, threadData_t *threadData)
+{
+  async_slot *slot = &out->slots[row % out->nSlots];
+
+  out->shadowLocalData[0] = &slot->sData;
+  out->shadowInfo.solverSteps = slot->solverSteps;
+  out->shadowInfo.sensitivityMatrix = slot->sensitivityMatrix;
+  out->inner.emitCpuTime = slot->cpuTime;
+  out->inner.emit(&out->inner, &out->shadowData, threadData);
+}
+
+/* Writes (or discards) queued rows in batches until asked to stop */
+static void writeRows(async_output *out, threadData_t *threadData, int write)
+{
+  pthread_mutex_lock(&out->mutex);
+  while (1) {
+    while (out->head == out->tail && !out->stop) {
+      struct timeval now;
+      struct timespec timeout;
+      gettimeofday(&now, NULL);
+      timeout.tv_sec = now.tv_sec + (now.tv_usec / 1000 + ASYNC_OUTPUT_WAIT_MS) / 1000;
+      timeout.tv_nsec = ((now.tv_usec / 1000 + ASYNC_OUTPUT_WAIT_MS) % 1000) * 1000000;
+      pthread_cond_timedwait(&out->rowsQueued, &out->mutex, &timeout);
+    }
+    if (out->head == out->tail) {
+      break;
+    }
+    size_t end = out->head;
+    pthread_mutex_unlock(&out->mutex);
+
+    if (write) {
+      for (size_t row = out->tail; row < end; row++) {
+        writeSlot(out, row, threadData);
+        /* make the slot available as soon as it is written */
+        pthread_mutex_lock(&out->mutex);
+        out->tail = row + 1;
+        pthread_cond_broadcast(&out->rowsWritten);
+        pthread_mutex_unlock(&out->mutex);
+      }
+      pthread_mutex_lock(&out->mutex);
+    } else {
+      pthread_mutex_lock(&out->mutex);
+      out->tail = end;
+      pthread_cond_broadcast(&out->rowsWritten);
+    }
+  }
+  pthread_mutex_unlock(&out->mutex);
+}
+
+static void* asyncWriterThread(void *arg)
+{
+  async_output *out = (async_output*) arg;
+  int failed = 0;
+
+  MMC_TRY_TOP()
+    writeRows(out, threadData, 1);
+  MMC_CATCH_TOP(failed = 1)
+
+  if (failed) {
+    pthread_mutex_lock(&out->mutex);
+    out->failed = 1;
+    pthread_mutex_unlock(&out->mutex);
+    /* keep emit from blocking until the main thread notices the error */
+    writeRows(out, NULL, 0);
+  }
+  return NULL;
+}
+
+/* Blocks until all queued rows are written. Throws if the writer failed. */
+static void drainAsyncOutput(async_output *out, threadData_t *threadData)
+{
+  int failed;
+
+  if (!out->running)
+    return;
+
+  pthread_mutex_lock(&out->mutex);
+  pthread_cond_signal(&out->rowsQueued);
+  while (out->tail != out->head)
+    pthread_cond_wait(&out->rowsWritten, &out->mutex);
+  failed = out->failed;
+  pthread_mutex_unlock(&out->mutex);
+
+  if (failed)
+    throwStreamPrint(threadData, "Failed to write the result file %s", out->inner.filename);
+}
+
+static void stopAsyncOutput(async_output *out)
+{
+  if (!out->running)
+    return;
+
+  pthread_mutex_lock(&out->mutex);
+  out->stop = 1;
+  pthread_cond_signal(&out->rowsQueued);
+  pthread_mutex_unlock(&out->mutex);
+  pthread_join(out->thread, NULL);
+
+  pthread_mutex_destroy(&out->mutex);
+  pthread_cond_destroy(&out->rowsQueued);
+  pthread_cond_destroy(&out->rowsWritten);
+  out->running = 0;
+}
+
+static void freeSlots(async_output *out)
+{
+  for (size_t i = 0; i < out->nSlots; i++) {
+    free(out->slots[i].sData.realVars);
+    free(out->slots[i].sData.integerVars);
+    free(out->slots[i].sData.booleanVars);
+    if (out->slots[i].sData.stringVars)
+      omc_alloc_interface.free_uncollectable(out->slots[i].sData.stringVars);
+    free(out->slots[i].sensitivityMatrix);
+  }
+  free(out->slots);
+  out->slots = NULL;
+  out->nSlots = 0;
+}
+
+static void async_init(simulation_result *self, DATA *data, threadData_t *threadData)
+{
+  async_output *out = (async_output*) self->storage;
+  const MODEL_DATA *mData = data->modelData;
+  size_t nSensitivity = data->simulationInfo->sensitivityMatrix ? mData->nSensitivityVars : 0;
+  size_t rowSize = sizeof(async_slot) + mData->nVariablesReal * sizeof(modelica_real) + mData->nVariablesInteger * sizeof(modelica_integer)
+                 + mData->nVariablesBoolean * sizeof(modelica_boolean) + mData->nVariablesString * sizeof(modelica_string)
+                 + nSensitivity * sizeof(modelica_real);
+
+  out->inner.init(&out->inner, data, threadData);
+
+  out->nSlots = ASYNC_OUTPUT_BUFFER_SIZE / rowSize;
+  if (out->nSlots < 2) out->nSlots = 2;
+  if (out->nSlots > ASYNC_OUTPUT_MAX_ROWS) out->nSlots = ASYNC_OUTPUT_MAX_ROWS;
+  out->batchSize = out->nSlots / 4 > 0 ? out->nSlots / 4 : 1;
+
+  out->slots = (async_slot*) calloc(out->nSlots, sizeof(async_slot));
+  assertStreamPrint(threadData, 0 != out->slots, "Out of memory");
+  for (size_t i = 0; i < out->nSlots; i++) {
+    async_slot *slot = &out->slots[i];
+    slot->sData.realVars = (modelica_real*) malloc(mData->nVariablesReal * sizeof(modelica_real) + 1);
+    slot->sData.integerVars = (modelica_integer*) malloc(mData->nVariablesInteger * sizeof(modelica_integer) + 1);
+    slot->sData.booleanVars = (modelica_boolean*) malloc(mData->nVariablesBoolean * sizeof(modelica_boolean) + 1);
+    /* keeps the queued strings alive */
+    slot->sData.stringVars = mData->nVariablesString ? (modelica_string*) omc_alloc_interface.malloc_uncollectable(mData->nVariablesString * sizeof(modelica_string)) : NULL;
+    slot->sensitivityMatrix = nSensitivity ? (modelica_real*) calloc(nSensitivity, sizeof(modelica_real)) : NULL;
+    assertStreamPrint(threadData, slot->sData.realVars && slot->sData.integerVars && slot->sData.booleanVars, "Out of memory");
+  }
+
+  out->shadowData = *data;
+  out->shadowInfo = *data->simulationInfo;
+  out->shadowData.simulationInfo = &out->shadowInfo;
+  out->shadowData.localData = out->shadowLocalData;
+  out->head = 0;
+  out->tail = 0;
+  out->stalls = 0;
+  out->stop = 0;
+  out->failed = 0;
+
+  pthread_mutex_init(&out->mutex, NULL);
+  pthread_cond_init(&out->rowsQueued, NULL);
+  pthread_cond_init(&out->rowsWritten, NULL);
+  if (pthread_create(&out->thread, NULL, asyncWriterThread, out)) {
+    freeSlots(out);
+    throwStreamPrint(threadData, "Could not create the output thread: %s", strerror(errno));
+  }
+  out->running = 1;
+  infoStreamPrint(LOG_SOLVER, 0, "Writing the result file in a background thread using %zu rows of %zu bytes", out->nSlots, rowSize);
+}
+
+static void async_emit(simulation_result *self, DATA *data, threadData_t *threadData)
+{
+  async_output *out = (async_output*) self->storage;
+  const MODEL_DATA *mData = data->modelData;
+  const SIMULATION_DATA *sData = data->localData[0];
+  int failed;
+
+  pthread_mutex_lock(&out->mutex);
+  while (out->head - out->tail == out->nSlots && !out->failed) {
+    out->stalls++;
+    pthread_cond_signal(&out->rowsQueued);
+    pthread_cond_wait(&out->rowsWritten, &out->mutex);
+  }
+  failed = out->failed;
+  pthread_mutex_unlock(&out->mutex);
+
+  if (failed)
+    throwStreamPrint(threadData, "Failed to write the result file %s", self->filename);
+
+  /* the timers are only used on this thread, the wrapped emit gets the cpu
+   * time from the slot and only the copy is charged to the output timer */
+  rt_tick(SIM_TIMER_OUTPUT);
+  rt_accumulate(SIM_TIMER_TOTAL);
+  double cpuTime = rt_accumulated(SIM_TIMER_TOTAL);
+  rt_tick(SIM_TIMER_TOTAL);
+
+  /* the writer does not touch the slot at head until it is queued */
+  async_slot *slot = &out->slots[out->head % out->nSlots];
+  slot->cpuTime = cpuTime;
+  slot->sData.timeValue = sData->timeValue;
+  memcpy(slot->sData.realVars, sData->realVars, mData->nVariablesReal * sizeof(modelica_real));
+  memcpy(slot->sData.integerVars, sData->integerVars, mData->nVariablesInteger * sizeof(modelica_integer));
+  memcpy(slot->sData.booleanVars, sData->booleanVars, mData->nVariablesBoolean * sizeof(modelica_boolean));
+  if (slot->sData.stringVars)
+    memcpy(slot->sData.stringVars, sData->stringVars, mData->nVariablesString * sizeof(modelica_string));
+  slot->solverSteps = data->simulationInfo->solverSteps;
+  if (slot->sensitivityMatrix)
+    memcpy(slot->sensitivityMatrix, data->simulationInfo->sensitivityMatrix, (mData->nSensitivityVars - mData->nSensitivityParamVars) * sizeof(modelica_real));
+  rt_accumulate(SIM_TIMER_OUTPUT);
+
+  pthread_mutex_lock(&out->mutex);
+  out->head++;
+  if (out->head - out->tail >= out->batchSize)
+    pthread_cond_signal(&out->rowsQueued);
+  pthread_mutex_unlock(&out->mutex);
+}
+
+static void async_writeParameterData(simulation_result *self, DATA *data, threadData_t *threadData)
+{
+  async_output *out = (async_output*) self->storage;
+
+  drainAsyncOutput(out, threadData);
+  out->inner.writeParameterData(&out->inner, data, threadData);
+}
+
+static void async_free(simulation_result *self, DATA *data, threadData_t *threadData)
+{
+  async_output *out = (async_output*) self->storage;
+  int failed = out->failed;
+
+  if (out->running) {
+    stopAsyncOutput(out);
+    failed = out->failed;
+    infoStreamPrint(LOG_STATS, 0, "background output: %zu rows written, emit waited %lu times for a free row", out->tail, out->stalls);
+    freeSlots(out);
+  }
+
+  out->inner.free(&out->inner, data, threadData);
+  self->init = out->inner.init;
+  self->emit = out->inner.emit;
+  self->writeParameterData = out->inner.writeParameterData;
+  self->free = out->inner.free;
+  self->storage = out->inner.storage;
+  free(out);
+
+  if (failed)
+    throwStreamPrint(threadData, "Failed to write the result file %s", self->filename);
+}
+
+#endif /* OM_HAVE_PTHREADS */
+
+/**
+ * @brief Let a background thread write the results of the given backend.
+ *
+ * Replaces the callbacks of self by wrappers that queue the output rows and
+ * call the original callbacks. Has to be called before init.
+ *
+ * @param self  Simulation result with the callbacks of the selected format.
+ */
+void wrapAsyncResult(simulation_result *self)
+{
+#if defined(OM_HAVE_PTHREADS)
+  if (self->emit == async_emit)
+    return;
+
+  async_output *out = (async_output*) calloc(1, sizeof(async_output));
+  if (!out) {
+    warningStreamPrint(LOG_STDOUT, 0, "-%s is ignored: out of memory", FLAG_NAME[FLAG_ASYNC_OUTPUT]);
+    return;
+  }
+  out->inner = *self;
+  out->inner.emitInBackground = 1;
+
+  self->storage = out;
+  self->init = async_init;
+  self->emit = async_emit;
+  self->writeParameterData = async_writeParameterData;
+  self->free = async_free;
+#else
+  warningStreamPrint(LOG_STDOUT, 0, "-%s is not supported without pthreads", FLAG_NAME[FLAG_ASYNC_OUTPUT]);
+#endif
+}
+
+/**
+ * @brief Wait until all queued output rows are written.
+ *
+ * Does nothing if self does not write asynchronously.
+ */
+void syncAsyncResult(simulation_result *self, threadData_t *threadData)
+{
+#if defined(OM_HAVE_PTHREADS)
+  if (self->emit == async_emit)
+    drainAsyncOutput((async_output*) self->storage, threadData);
+#endif
+}
+
+}
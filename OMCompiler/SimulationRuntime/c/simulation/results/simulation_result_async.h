@@ -1,7 +1,7 @@
 /*
  * This file is part of OpenModelica.
  *
- * Copyright (c) 1998-2019, Open Source Modelica Consortium (OSMC),
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
  * c/o Linköpings universitet, Department of Computer and Information Science,
  * SE-58183 Linköping, Sweden.
  *
@@ -28,37 +28,35 @@
  *
  */
 
- /*! \file jacobianSymbolical.h
- */
-
-#ifndef OMC_JACOBIAN_SYMBOLICAL_H
-#define OMC_JACOBIAN_SYMBOLICAL_H
-
-#include "../../simulation_data.h"
-#include "util/parallel_helper.h"
-
-/**
- * @brief Set element of Jacobian matrix.
+/*
+ * Asynchronous result writing (-asyncOutput).
  *
- * Jac(row, column) = val.
+ * Wraps any simulation_result backend. emit only copies the current values
+ * into a slot of a bounded ring and returns, a background thread calls the
+ * wrapped emit for the queued rows in batches. init, writeParameterData and
+ * free run on the calling thread after the ring has been drained.
  *
- * @param row       Row of matrix element.
- * @param column    Column of matrix element.
- * @param nth       Sparsity pattern lead index.
- * @param value     Value to set in position (i,j).
- * @param Jac       Pointer to data structure storing matrix.
- * @param nRows     Number of rows of Jacobian matrix, unused.
+ * The ring and the thread belong to the wrapped simulation_result (they are
+ * kept in its storage). The wrapped emit runs with emitInBackground set: it
+ * must not use the process-global timers and takes $cpuTime from emitCpuTime,
+ * which is recorded on the calling thread when the row is copied.
  */
-typedef void (*setJacElementFunc)(int row, int column, int nth, double value, void* Jac, int nRows);
 
-void allocateThreadLocalJacobians(DATA* data, ANALYTIC_JACOBIAN** jacColumns);
+#include "simulation_data.h"
+#include "simulation_result.h"
+
+#ifndef _SIMULATION_RESULT_ASYNC_H
+#define _SIMULATION_RESULT_ASYNC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* cplusplus */
 
-void genericColoredSymbolicJacobianEvaluation(int rows, int columns, SPARSE_PATTERN* spp,
-                                              void* matrixA, ANALYTIC_JACOBIAN* jacColumns,
-                                              DATA* data,
-                                              threadData_t* threadData,
-                                              setJacElementFunc setJacElement);
+void wrapAsyncResult(simulation_result *self);
+void syncAsyncResult(simulation_result *self, threadData_t *threadData);
 
-void freeAnalyticalJacobian(ANALYTIC_JACOBIAN** jacColumns);
+#ifdef __cplusplus
+}
+#endif /* cplusplus */
 
 #endif
@@ -41,6 +41,7 @@
 #include "util/omc_error.h"
 #include "util/omc_file.h"
 #include "simulation_result_csv.h"
+#include "simulation_result_gather.h"
 #include "util/rtclock.h"
 
 #include <stdio.h>
@@ -52,6 +53,13 @@
 
 extern "C" {
 
+typedef struct csv_data {
+  FILE *fout;
+  OUTPUT_GATHER gather;
+  double *row;
+  char *isInteger;  /* columns printed as integers */
+} csv_data;
+
 /**
  * @brief Count the occurrences of a substring in a string
  *
@@ -117,64 +125,27 @@ void csvEscapedString(const char* original, char* replaced, size_t n, threadData
  */
 void omc_csv_emit(simulation_result *self, DATA *data, threadData_t *threadData)
 {
-  FILE *fout = (FILE*) self->storage;
+  csv_data *csvData = (csv_data*) self->storage;
+  FILE *fout = csvData->fout;
   const char* format = ",%.16g";
   const char* formatint = ",%i";
-  const char* formatbool = ",%i";
-  const char* formatstring = ",\"%s\"";
-  int i;
-  modelica_real value = 0;
-  double cpuTimeValue = 0;
-  rt_tick(SIM_TIMER_OUTPUT);
-
-  rt_accumulate(SIM_TIMER_TOTAL);
-  cpuTimeValue = rt_accumulated(SIM_TIMER_TOTAL);
-  rt_tick(SIM_TIMER_TOTAL);
+  size_t i;
+  double cpuTimeValue = sim_result_startEmit(self);
 
   fprintf(fout, "%.16g", data->localData[0]->timeValue);
   if(self->cpuTime)
     fprintf(fout, format, cpuTimeValue);
-  for(i = 0; i < data->modelData->nVariablesReal; i++) if(!data->modelData->realVarsData[i].filterOutput)
-    fprintf(fout, format, (data->localData[0])->realVars[i]);
-  for(i = 0; i < data->modelData->nVariablesInteger; i++) if(!data->modelData->integerVarsData[i].filterOutput)
-    fprintf(fout, formatint, (data->localData[0])->integerVars[i]);
-  for(i = 0; i < data->modelData->nVariablesBoolean; i++) if(!data->modelData->booleanVarsData[i].filterOutput)
-    fprintf(fout, formatbool, (data->localData[0])->booleanVars[i]);
-  //for(i = 0; i < data->modelData->nVariablesString; i++) if(!data->modelData->stringVarsData[i].filterOutput)
-  //  fprintf(fout, formatstring, MMC_STRINGDATA((data->localData[0])->stringVars[i]));
-
-  for(i = 0; i < data->modelData->nAliasReal; i++) if(!data->modelData->realAlias[i].filterOutput && data->modelData->realAlias[i].aliasType != 1) {
-    if (data->modelData->realAlias[i].aliasType == 2) {
-      value = (data->localData[0])->timeValue;
-    } else {
-      value = (data->localData[0])->realVars[data->modelData->realAlias[i].nameID];
-    }
-    if (data->modelData->realAlias[i].negate) {
-      fprintf(fout, format, -value);
-    } else {
-      fprintf(fout, format, value);
-    }
-  }
-  for(i = 0; i < data->modelData->nAliasInteger; i++) if(!data->modelData->integerAlias[i].filterOutput && data->modelData->integerAlias[i].aliasType != 1) {
-    if (data->modelData->integerAlias[i].negate) {
-      fprintf(fout, formatint, -(data->localData[0])->integerVars[data->modelData->integerAlias[i].nameID]);
-    } else {
-      fprintf(fout, formatint, (data->localData[0])->integerVars[data->modelData->integerAlias[i].nameID]);
-    }
-  }
-  for(i = 0; i < data->modelData->nAliasBoolean; i++) if(!data->modelData->booleanAlias[i].filterOutput && data->modelData->booleanAlias[i].aliasType != 1) {
-    if (data->modelData->booleanAlias[i].negate) {
-      fprintf(fout, formatbool, (data->localData[0])->booleanVars[data->modelData->booleanAlias[i].nameID]==1?0:1);
+
+  gatherOutputRow(&csvData->gather, data, csvData->row);
+  for(i = 0; i < csvData->gather.nColumns; i++) {
+    if (csvData->isInteger[i]) {
+      fprintf(fout, formatint, (int) csvData->row[i]);
     } else {
-      fprintf(fout, formatbool, (data->localData[0])->booleanVars[data->modelData->booleanAlias[i].nameID]);
+      fprintf(fout, format, csvData->row[i]);
     }
   }
-  //for(i = 0; i < data->modelData->nAliasString; i++) if(!data->modelData->stringAlias[i].filterOutput && data->modelData->stringAlias[i].aliasType != 1) {
-  //  /* there would no negation of a string happen */
-  //  fprintf(fout, formatstring, MMC_STRINGDATA((data->localData[0])->stringVars[data->modelData->stringAlias[i].nameID]));
-  //}
   fprintf(fout, "\n");
-  rt_accumulate(SIM_TIMER_OUTPUT);
+  sim_result_endEmit(self);
 }
 
 /**
@@ -192,9 +163,16 @@ void omc_csv_init(simulation_result *self, DATA *data, threadData_t *threadData)
   const char* format = ",\"%s\"";
   FILE *fout = omc_fopen(self->filename, "w");
   char escapedNameBuffer[MAX_IDENT_LENGTH];
+  csv_data *csvData;
+  OUTPUT_GATHER *gather;
 
   assertStreamPrint(threadData, 0!=fout, "Error, couldn't create output file: [%s] because of %s", self->filename, strerror(errno));
 
+  csvData = (csv_data*) malloc(sizeof(csv_data));
+  csvData->fout = fout;
+  gather = &csvData->gather;
+  initOutputGather(gather);
+
   fprintf(fout, "\"time\"");
   if(self->cpuTime) {
     fprintf(fout, format, "$cpuTime");
@@ -202,17 +180,20 @@ void omc_csv_init(simulation_result *self, DATA *data, threadData_t *threadData)
   for(i = 0; i < mData->nVariablesReal; i++) if(!mData->realVarsData[i].filterOutput) {
     csvEscapedString(mData->realVarsData[i].info.name, escapedNameBuffer, MAX_IDENT_LENGTH, threadData);
     fprintf(fout, format, escapedNameBuffer);
+    addOutputColumn(gather, OUTPUT_SOURCE_REAL_VARS, i, 0);
   }
   for(i = 0; i < mData->nVariablesInteger; i++) {
     if(!mData->integerVarsData[i].filterOutput) {
       csvEscapedString(mData->integerVarsData[i].info.name, escapedNameBuffer, MAX_IDENT_LENGTH, threadData);
       fprintf(fout, format, escapedNameBuffer);
+      addOutputColumn(gather, OUTPUT_SOURCE_INTEGER_VARS, i, 0);
     }
   }
   for(i = 0; i < mData->nVariablesBoolean; i++) {
     if(!mData->booleanVarsData[i].filterOutput) {
       csvEscapedString(mData->booleanVarsData[i].info.name, escapedNameBuffer, MAX_IDENT_LENGTH, threadData);
       fprintf(fout, format, escapedNameBuffer);
+      addOutputColumn(gather, OUTPUT_SOURCE_BOOLEAN_VARS, i, 0);
     }
   }
 
@@ -220,29 +201,51 @@ void omc_csv_init(simulation_result *self, DATA *data, threadData_t *threadData)
     if(!mData->realAlias[i].filterOutput && data->modelData->realAlias[i].aliasType != 1) {
       csvEscapedString(mData->realAlias[i].info.name, escapedNameBuffer, MAX_IDENT_LENGTH, threadData);
       fprintf(fout, format, escapedNameBuffer);
+      addAliasColumn(gather, OUTPUT_SOURCE_REAL_VARS, &mData->realAlias[i]);
     }
   }
   for(i = 0; i < mData->nAliasInteger; i++) {
     if(!mData->integerAlias[i].filterOutput && data->modelData->integerAlias[i].aliasType != 1) {
       csvEscapedString(mData->integerAlias[i].info.name, escapedNameBuffer, MAX_IDENT_LENGTH, threadData);
       fprintf(fout, format, escapedNameBuffer);
+      addAliasColumn(gather, OUTPUT_SOURCE_INTEGER_VARS, &mData->integerAlias[i]);
     }
   }
   for(i = 0; i < mData->nAliasBoolean; i++) {
     if(!mData->booleanAlias[i].filterOutput && data->modelData->booleanAlias[i].aliasType != 1) {
       csvEscapedString(mData->booleanAlias[i].info.name, escapedNameBuffer, MAX_IDENT_LENGTH, threadData);
       fprintf(fout, format, escapedNameBuffer);
+      addAliasColumn(gather, OUTPUT_SOURCE_BOOLEAN_VARS, &mData->booleanAlias[i]);
     }
   }
   fprintf(fout, "\n");
-  self->storage = fout;
+
+  /* everything but the real variables and their aliases is printed as integer */
+  csvData->row = (double*) malloc(gather->nColumns * sizeof(double));
+  csvData->isInteger = (char*) calloc(gather->nColumns + 1, sizeof(char));
+  memset(csvData->isInteger, 1, gather->nColumns);
+  for(int negate = 0; negate < 2; negate++) {
+    const OUTPUT_GATHER_LIST *reals = &gather->lists[OUTPUT_SOURCE_REAL_VARS][negate];
+    const OUTPUT_GATHER_LIST *time = &gather->lists[OUTPUT_SOURCE_TIME][negate];
+    for(size_t k = 0; k < reals->n; k++)
+      csvData->isInteger[reals->column[k]] = 0;
+    for(size_t k = 0; k < time->n; k++)
+      csvData->isInteger[time->column[k]] = 0;
+  }
+
+  self->storage = csvData;
 }
 
 void omc_csv_free(simulation_result *self, DATA *data, threadData_t *threadData)
 {
-  FILE *fout = (FILE*) self->storage;
+  csv_data *csvData = (csv_data*) self->storage;
   rt_tick(SIM_TIMER_OUTPUT);
-  fclose(fout);
+  fclose(csvData->fout);
+  freeOutputGather(&csvData->gather);
+  free(csvData->row);
+  free(csvData->isInteger);
+  free(csvData);
+  self->storage = NULL;
   rt_accumulate(SIM_TIMER_OUTPUT);
 }
 
@@ -0,0 +1,161 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+#include "util/omc_error.h"
+#include "simulation_result_gather.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Gather kernels, row[column[k]] = values[source[k]] */
+template<typename T>
+static void gatherValues(const OUTPUT_GATHER_LIST *list, const T *values, double *row)
+{
+  const size_t n = list->n;
+  const size_t *source = list->source;
+  const size_t *column = list->column;
+
+  for (size_t k = 0; k < n; k++)
+    row[column[k]] = (double) values[source[k]];
+}
+
+template<typename T>
+static void gatherNegatedValues(const OUTPUT_GATHER_LIST *list, const T *values, double *row)
+{
+  const size_t n = list->n;
+  const size_t *source = list->source;
+  const size_t *column = list->column;
+
+  for (size_t k = 0; k < n; k++)
+    row[column[k]] = -(double) values[source[k]];
+}
+
+static void gatherNegatedBooleans(const OUTPUT_GATHER_LIST *list, const modelica_boolean *values, double *row)
+{
+  const size_t n = list->n;
+  const size_t *source = list->source;
+  const size_t *column = list->column;
+
+  for (size_t k = 0; k < n; k++)
+    row[column[k]] = values[source[k]] ? 0.0 : 1.0;
+}
+
+extern "C" {
+
+void initOutputGather(OUTPUT_GATHER *gather)
+{
+  memset(gather, 0, sizeof(OUTPUT_GATHER));
+}
+
+void freeOutputGather(OUTPUT_GATHER *gather)
+{
+  for (int i = 0; i < OUTPUT_SOURCE_MAX; i++)
+    for (int negate = 0; negate < 2; negate++) {
+      free(gather->lists[i][negate].source);
+      free(gather->lists[i][negate].column);
+    }
+  memset(gather, 0, sizeof(OUTPUT_GATHER));
+}
+
+/* Adds n columns that are written by the emitter itself, e.g. time or
+ * $cpuTime. Returns the first of them. */
+size_t reserveOutputColumns(OUTPUT_GATHER *gather, size_t n)
+{
+  size_t column = gather->nColumns;
+  gather->nColumns += n;
+  return column;
+}
+
+/* Adds a column holding the value source[index] of the given source array,
+ * negated if negate is set. Returns the column. */
+size_t addOutputColumn(OUTPUT_GATHER *gather, OUTPUT_SOURCE source, size_t index, int negate)
+{
+  OUTPUT_GATHER_LIST *list = &gather->lists[source][negate ? 1 : 0];
+
+  if (list->n == list->size) {
+    list->size = list->size ? 2 * list->size : 64;
+    list->source = (size_t*) realloc(list->source, list->size * sizeof(size_t));
+    list->column = (size_t*) realloc(list->column, list->size * sizeof(size_t));
+    assertStreamPrint(NULL, list->source && list->column, "addOutputColumn: Out of memory");
+  }
+  list->source[list->n] = index;
+  list->column[list->n] = gather->nColumns;
+  list->n++;
+
+  return gather->nColumns++;
+}
+
+/* Adds a column for an alias of a variable of the given source, resolving
+ * aliases of parameters and of time. */
+size_t addAliasColumn(OUTPUT_GATHER *gather, OUTPUT_SOURCE source, const DATA_ALIAS *alias)
+{
+  if (alias->aliasType == 2)
+    return addOutputColumn(gather, OUTPUT_SOURCE_TIME, 0, alias->negate);
+
+  if (alias->aliasType == 1) {
+    switch (source) {
+    case OUTPUT_SOURCE_REAL_VARS:    source = OUTPUT_SOURCE_REAL_PARAMETER;    break;
+    case OUTPUT_SOURCE_INTEGER_VARS: source = OUTPUT_SOURCE_INTEGER_PARAMETER; break;
+    case OUTPUT_SOURCE_BOOLEAN_VARS: source = OUTPUT_SOURCE_BOOLEAN_PARAMETER; break;
+    default: break;
+    }
+  }
+
+  return addOutputColumn(gather, source, alias->nameID, alias->negate);
+}
+
+/* Fills all non-reserved columns of row with the current values. */
+void gatherOutputRow(const OUTPUT_GATHER *gather, const DATA *data, double *row)
+{
+  const SIMULATION_DATA *sData = data->localData[0];
+  const SIMULATION_INFO *sInfo = data->simulationInfo;
+  const OUTPUT_GATHER_LIST *time = gather->lists[OUTPUT_SOURCE_TIME];
+
+  gatherValues(&gather->lists[OUTPUT_SOURCE_REAL_VARS][0], sData->realVars, row);
+  gatherNegatedValues(&gather->lists[OUTPUT_SOURCE_REAL_VARS][1], sData->realVars, row);
+  gatherValues(&gather->lists[OUTPUT_SOURCE_INTEGER_VARS][0], sData->integerVars, row);
+  gatherNegatedValues(&gather->lists[OUTPUT_SOURCE_INTEGER_VARS][1], sData->integerVars, row);
+  gatherValues(&gather->lists[OUTPUT_SOURCE_BOOLEAN_VARS][0], sData->booleanVars, row);
+  gatherNegatedBooleans(&gather->lists[OUTPUT_SOURCE_BOOLEAN_VARS][1], sData->booleanVars, row);
+
+  gatherValues(&gather->lists[OUTPUT_SOURCE_REAL_PARAMETER][0], sInfo->realParameter, row);
+  gatherNegatedValues(&gather->lists[OUTPUT_SOURCE_REAL_PARAMETER][1], sInfo->realParameter, row);
+  gatherValues(&gather->lists[OUTPUT_SOURCE_INTEGER_PARAMETER][0], sInfo->integerParameter, row);
+  gatherNegatedValues(&gather->lists[OUTPUT_SOURCE_INTEGER_PARAMETER][1], sInfo->integerParameter, row);
+  gatherValues(&gather->lists[OUTPUT_SOURCE_BOOLEAN_PARAMETER][0], sInfo->booleanParameter, row);
+  gatherNegatedBooleans(&gather->lists[OUTPUT_SOURCE_BOOLEAN_PARAMETER][1], sInfo->booleanParameter, row);
+
+  for (size_t k = 0; k < time[0].n; k++)
+    row[time[0].column[k]] = sData->timeValue;
+  for (size_t k = 0; k < time[1].n; k++)
+    row[time[1].column[k]] = -sData->timeValue;
+}
+
+}
@@ -0,0 +1,85 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+/*
+ * Precompiled output index lists for the result emitters.
+ *
+ * The emitters decide once in their init function which variables end up in
+ * which column of an output row (filterOutput, time_unvarying, alias type and
+ * negation). The gather lists store this as flat (source index, column) pairs
+ * grouped by source array and negation, so filling a row at every output step
+ * is a set of branch free gather loops.
+ */
+
+#include "simulation_data.h"
+
+#ifndef _SIMULATION_RESULT_GATHER_H
+#define _SIMULATION_RESULT_GATHER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* cplusplus */
+
+typedef enum {
+  OUTPUT_SOURCE_REAL_VARS = 0,
+  OUTPUT_SOURCE_INTEGER_VARS,
+  OUTPUT_SOURCE_BOOLEAN_VARS,
+  OUTPUT_SOURCE_REAL_PARAMETER,
+  OUTPUT_SOURCE_INTEGER_PARAMETER,
+  OUTPUT_SOURCE_BOOLEAN_PARAMETER,
+  OUTPUT_SOURCE_TIME,
+
+  OUTPUT_SOURCE_MAX
+} OUTPUT_SOURCE;
+
+typedef struct OUTPUT_GATHER_LIST {
+  size_t n;
+  size_t size;
+  size_t *source;  /* index into the source array */
+  size_t *column;  /* column in the output row */
+} OUTPUT_GATHER_LIST;
+
+typedef struct OUTPUT_GATHER {
+  size_t nColumns;
+  OUTPUT_GATHER_LIST lists[OUTPUT_SOURCE_MAX][2];  /* [source][negate] */
+} OUTPUT_GATHER;
+
+void initOutputGather(OUTPUT_GATHER *gather);
+void freeOutputGather(OUTPUT_GATHER *gather);
+size_t reserveOutputColumns(OUTPUT_GATHER *gather, size_t n);
+size_t addOutputColumn(OUTPUT_GATHER *gather, OUTPUT_SOURCE source, size_t index, int negate);
+size_t addAliasColumn(OUTPUT_GATHER *gather, OUTPUT_SOURCE source, const DATA_ALIAS *alias);
+void gatherOutputRow(const OUTPUT_GATHER *gather, const DATA *data, double *row);
+
+#ifdef __cplusplus
+}
+#endif /* cplusplus */
+
+#endif
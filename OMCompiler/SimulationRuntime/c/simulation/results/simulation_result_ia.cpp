@@ -201,7 +201,8 @@ void ia_init(simulation_result *self, DATA *data, threadData_t *threadData)
 void ia_emit(simulation_result *self, DATA *data, threadData_t *threadData)
 {
   TRACE_PUSH
-  rt_tick(SIM_TIMER_OUTPUT);
+  if (!self->emitInBackground)
+    rt_tick(SIM_TIMER_OUTPUT);
 
   int i;
   const IA_DATA *iaData = (IA_DATA*)self->storage;
@@ -290,7 +291,8 @@ void ia_emit(simulation_result *self, DATA *data, threadData_t *threadData)
   communicateMsg(4, msgSIZE, msgDATA);
   delete[] msgDATA;
 
-  rt_accumulate(SIM_TIMER_OUTPUT);
+  if (!self->emitInBackground)
+    rt_accumulate(SIM_TIMER_OUTPUT);
   TRACE_POP
 }
 
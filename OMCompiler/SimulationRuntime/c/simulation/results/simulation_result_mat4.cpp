@@ -31,15 +31,18 @@
 #include "MatVer4.h"
 #include "util/omc_error.h"
 #include "util/omc_file.h"
+#include "util/omc_mmap.h"
 #include "util/rtclock.h"
 #include "simulation/options.h"
 #include "simulation_result_mat4.h"
+#include "simulation_result_gather.h"
 
 #include <fstream>
 #include <iostream>
 #include <map>
 #include <string>
 #include <utility>
+#include <algorithm>
 #include <cstring>
 #include <cstdlib>
 #include <stdint.h>
@@ -57,6 +60,9 @@ typedef struct mat_data {
   size_t nEmits;
   size_t sync;
   void* data_2;
+  double* row; /* one row of data_2 in double precision */
+  size_t sensitivityColumn;
+  OUTPUT_GATHER gather;
   MatVer4Type_t type;
 } mat_data;
 
@@ -72,6 +78,7 @@ void mat4_init4(simulation_result *self, DATA *data, threadData_t *threadData)
   const MODEL_DATA *mData = data->modelData;
   mat_data *matData = new mat_data();
   self->storage = matData;
+  initOutputGather(&matData->gather);
 
   assert(sizeof(char) == 1);
 
@@ -707,6 +714,34 @@ void mat4_writeParameterData4(simulation_result *self, DATA *data, threadData_t
   //  Data Type: IEEE 754 double-precision
   matData->data2HdrPos = ftell(matData->pFile);
   matData->data_2 = malloc(size * matData->nData2);
+  matData->row = (double*) malloc(sizeof(double) * matData->nData2);
+
+  /* Column layout of data_2: time, $cpuTime, $solverSteps, variables,
+   * sensitivities, integers, booleans, negated boolean aliases. */
+  OUTPUT_GATHER *gather = &matData->gather;
+  freeOutputGather(gather);
+  reserveOutputColumns(gather, 1 + (self->cpuTime ? 1 : 0) + (omc_flag[FLAG_SOLVER_STEPS] ? 1 : 0));
+
+  for (int i=0; i < mData->nVariablesReal; i++)
+    if (!mData->realVarsData[i].filterOutput && !mData->realVarsData[i].time_unvarying)
+      addOutputColumn(gather, OUTPUT_SOURCE_REAL_VARS, i, 0);
+
+  if (omc_flag[FLAG_IDAS])
+    matData->sensitivityColumn = reserveOutputColumns(gather, mData->nSensitivityVars - mData->nSensitivityParamVars);
+
+  for (int i=0; i < mData->nVariablesInteger; i++)
+    if (!mData->integerVarsData[i].filterOutput && !mData->integerVarsData[i].time_unvarying)
+      addOutputColumn(gather, OUTPUT_SOURCE_INTEGER_VARS, i, 0);
+
+  for (int i=0; i < mData->nVariablesBoolean; i++)
+    if (!mData->booleanVarsData[i].filterOutput && !mData->booleanVarsData[i].time_unvarying)
+      addOutputColumn(gather, OUTPUT_SOURCE_BOOLEAN_VARS, i, 0);
+
+  for (int i=0; i < mData->nAliasBoolean; i++)
+    if (!mData->booleanAlias[i].filterOutput && mData->booleanAlias[i].aliasType == 0 && mData->booleanAlias[i].negate)
+      addOutputColumn(gather, OUTPUT_SOURCE_BOOLEAN_VARS, mData->booleanAlias[i].nameID, 1);
+
+  assertStreamPrint(threadData, gather->nColumns == matData->nData2, "Inconsistent number of columns in data_2");
   writeMatrix_matVer4(matData->pFile, "data_2", matData->nData2, 0, NULL, matData->type);
   rt_accumulate(SIM_TIMER_OUTPUT);
 }
@@ -714,50 +749,39 @@ void mat4_writeParameterData4(simulation_result *self, DATA *data, threadData_t
 void mat4_emit4(simulation_result *self, DATA *data, threadData_t *threadData)
 {
   mat_data *matData = (mat_data*) self->storage;
-  const SIMULATION_INFO *sInfo = data->simulationInfo;
-  const MODEL_DATA      *mData = data->modelData;
+  const MODEL_DATA *mData = data->modelData;
 
   if (!matData->pFile)
     return;
 
-  rt_tick(SIM_TIMER_OUTPUT);
-  rt_accumulate(SIM_TIMER_TOTAL);
-  double cpuTimeValue = rt_accumulated(SIM_TIMER_TOTAL);
-  rt_tick(SIM_TIMER_TOTAL);
+  double cpuTimeValue = sim_result_startEmit(self);
 
+  double *row = matData->row;
   size_t cur = 0;
   /* time */
-  WRITE_REAL_VALUE(matData->data_2, cur++, data->localData[0]->timeValue);
+  row[cur++] = data->localData[0]->timeValue;
 
   if (self->cpuTime)
-    WRITE_REAL_VALUE(matData->data_2, cur++, cpuTimeValue);
+    row[cur++] = cpuTimeValue;
 
   if (omc_flag[FLAG_SOLVER_STEPS])
-    WRITE_REAL_VALUE(matData->data_2, cur++, data->simulationInfo->solverSteps);
+    row[cur++] = data->simulationInfo->solverSteps;
 
-  for (int i=0; i < mData->nVariablesReal; i++)
-    if (!mData->realVarsData[i].filterOutput && !mData->realVarsData[i].time_unvarying)
-      WRITE_REAL_VALUE(matData->data_2, cur++, data->localData[0]->realVars[i]);
+  gatherOutputRow(&matData->gather, data, row);
 
   if (omc_flag[FLAG_IDAS])
-    for (int i=mData->nSensitivityParamVars; i < mData->nSensitivityVars; i++)
-      WRITE_REAL_VALUE(matData->data_2, cur++, data->simulationInfo->sensitivityMatrix[i]);
-
-  for (int i=0; i < mData->nVariablesInteger; i++)
-    if (!mData->integerVarsData[i].filterOutput && !mData->integerVarsData[i].time_unvarying)
-      WRITE_REAL_VALUE(matData->data_2, cur++, data->localData[0]->integerVars[i]);
-
-  for (int i=0; i < mData->nVariablesBoolean; i++)
-    if (!mData->booleanVarsData[i].filterOutput && !mData->booleanVarsData[i].time_unvarying)
-      WRITE_REAL_VALUE(matData->data_2, cur++, data->localData[0]->booleanVars[i]);
-
-  for (int i=0; i < mData->nAliasBoolean; i++)
-    if (!mData->booleanAlias[i].filterOutput)
-      if (mData->booleanAlias[i].aliasType == 0)
-        if (mData->booleanAlias[i].negate)
-          WRITE_REAL_VALUE(matData->data_2, cur++, (1-data->localData[0]->booleanVars[mData->booleanAlias[i].nameID]));
+    for (int i=mData->nSensitivityParamVars, k=0; i < mData->nSensitivityVars; i++, k++)
+      row[matData->sensitivityColumn + k] = data->simulationInfo->sensitivityMatrix[i];
 
-  fwrite(matData->data_2, sizeofMatVer4Type(matData->type), matData->nData2, matData->pFile);
+  if (matData->type == MatVer4Type_DOUBLE)
+    fwrite(row, sizeof(double), matData->nData2, matData->pFile);
+  else
+  {
+    float *data_2 = (float*) matData->data_2;
+    for (size_t i=0; i < matData->nData2; i++)
+      data_2[i] = (float) row[i];
+    fwrite(data_2, sizeof(float), matData->nData2, matData->pFile);
+  }
   matData->nEmits++;
 
   if (matData->sync > 0 && matData->nEmits > matData->sync)
@@ -766,7 +790,111 @@ void mat4_emit4(simulation_result *self, DATA *data, threadData_t *threadData)
     matData->nEmits = 0;
   }
 
-  rt_accumulate(SIM_TIMER_OUTPUT);
+  sim_result_endEmit(self);
+}
+
+/* Transposes the column-major rows x cols matrix in into out (cols x rows).
+ * Works on tiles so that both source and destination stay in cache. */
+static void transposeMatrix(const uint8_t *in, uint8_t *out, size_t rows, size_t cols, size_t size)
+{
+  const size_t blockSize = 64;
+  for (size_t j0 = 0; j0 < cols; j0 += blockSize)
+    for (size_t i0 = 0; i0 < rows; i0 += blockSize)
+    {
+      const size_t j1 = std::min(j0 + blockSize, cols);
+      const size_t i1 = std::min(i0 + blockSize, rows);
+      for (size_t j = j0; j < j1; j++)
+        for (size_t i = i0; i < i1; i++)
+          memcpy(out + (j + i*cols)*size, in + (i + j*rows)*size, size);
+    }
+}
+
+/* Rewrites the finished result file in binNormal layout, i.e. with all
+ * matrices transposed. Every variable of data_2 is then one contiguous
+ * block of nrows values starting at (abs(index)-1)*nrows. */
+static void mat4_writeColumnMajor(const char *filename, threadData_t *threadData)
+{
+  //       Name: Aclass, rows "Atrajectory", "1.1", "", "binNormal"
+  const char Aclass[] = "A1\0bt.\0ir1\0na\0\0Nj\0\0oe\0\0rc\0\0mt\0\0ao\0\0lr\0\0\0y\0\0\0";
+  static const char *names[] = {"name", "description", "dataInfo", "data_1", "data_2"};
+  std::string tmpName = std::string(filename) + ".tmp";
+  omc_mmap_read src = omc_mmap_open_read(filename);
+  size_t pos = 0;
+  size_t data2Pos = 0, data2Rows = 0, data2Cols = 0, data2Size = 0;
+
+  FILE *pFile = omc_fopen(tmpName.c_str(), "wb+");
+  if (!pFile)
+  {
+    omc_mmap_close_read(src);
+    throwStreamPrint(threadData, "Cannot open file %s for writing", tmpName.c_str());
+  }
+  writeMatrix_matVer4(pFile, "Aclass", 4, 11, Aclass, MatVer4Type_CHAR);
+
+  for (int k = 0; k < 6; k++)
+  {
+    MatVer4Header header;
+    if (pos + sizeof(MatVer4Header) > src.size)
+    {
+      fclose(pFile);
+      omc_mmap_close_read(src);
+      omc_unlink(tmpName.c_str());
+      throwStreamPrint(threadData, "Corrupt result file %s", filename);
+    }
+    memcpy(&header, src.data + pos, sizeof(MatVer4Header));
+    MatVer4Type_t type = (MatVer4Type_t) (header.type % 100);
+    size_t size = sizeofMatVer4Type(type);
+    const uint8_t *matrixData = (const uint8_t*) src.data + pos + sizeof(MatVer4Header) + header.namelen;
+    pos += sizeof(MatVer4Header) + header.namelen + size * header.mrows * header.ncols;
+
+    if (k == 0) /* Aclass is replaced */
+      continue;
+
+    if (k < 5)
+    {
+      void *transposed = malloc(size * header.mrows * header.ncols + 1);
+      if (!transposed)
+      {
+        fclose(pFile);
+        omc_mmap_close_read(src);
+        omc_unlink(tmpName.c_str());
+        throwStreamPrint(threadData, "Not enough memory to rewrite result file %s", filename);
+      }
+      transposeMatrix(matrixData, (uint8_t*) transposed, header.mrows, header.ncols, size);
+      writeMatrix_matVer4(pFile, names[k-1], header.ncols, header.mrows, transposed, type);
+      free(transposed);
+    }
+    else
+    {
+      writeMatrix_matVer4(pFile, "data_2", header.ncols, header.mrows, NULL, type);
+      data2Pos = ftell(pFile);
+      data2Rows = header.mrows;
+      data2Cols = header.ncols;
+      data2Size = size;
+      /* Grow the file so that data_2 can be transposed into a mapping of it */
+      if (data2Rows * data2Cols > 0)
+      {
+        omc_fseek(pFile, data2Pos + data2Rows * data2Cols * data2Size - 1, SEEK_SET);
+        fputc(0, pFile);
+      }
+    }
+  }
+  fclose(pFile);
+
+  if (data2Rows * data2Cols > 0)
+  {
+    omc_mmap_write dst = omc_mmap_open_write(tmpName.c_str(), 0);
+    transposeMatrix((const uint8_t*) src.data + pos - data2Rows * data2Cols * data2Size, (uint8_t*) dst.data + data2Pos, data2Rows, data2Cols, data2Size);
+    omc_mmap_close_write(dst);
+  }
+  omc_mmap_close_read(src);
+
+  if (omc_rename(tmpName.c_str(), filename))
+  {
+    /* rename does not replace existing files on all platforms */
+    omc_unlink(filename);
+    if (omc_rename(tmpName.c_str(), filename))
+      throwStreamPrint(threadData, "Cannot rename %s to %s", tmpName.c_str(), filename);
+  }
 }
 
 void mat4_free4(simulation_result *self, DATA *data, threadData_t *threadData)
@@ -789,10 +917,16 @@ void mat4_free4(simulation_result *self, DATA *data, threadData_t *threadData)
     free(matData->data_2);
     matData->data_2 = NULL;
   }
+  free(matData->row);
+  matData->row = NULL;
+  freeOutputGather(&matData->gather);
 
   fclose(matData->pFile);
   matData->pFile = NULL;
 
+  if (omc_flag[FLAG_MAT_COLUMN_MAJOR])
+    mat4_writeColumnMajor(self->filename, threadData);
+
   rt_accumulate(SIM_TIMER_OUTPUT);
 }
 
@@ -41,6 +41,7 @@
 #include "util/omc_error.h"
 #include "util/omc_file.h"
 #include "simulation_result_plt.h"
+#include "simulation_result_gather.h"
 #include "util/rtclock.h"
 
 #include <stdio.h>
@@ -57,36 +58,36 @@ typedef struct plt_data {
   long maxPoints;
   long dataSize;
   int num_vars;
+  OUTPUT_GATHER gather;
 } plt_data;
 
-static void add_result(simulation_result *self,DATA *data,double *data_, long *actualPoints);
+static void add_result(simulation_result *self,DATA *data,double *data_, long *actualPoints, double cpuTimeValue);
 static void deallocResult(plt_data *pltData);
 static void printPltLine(FILE* f, double time, double val);
 
-static int calcDataSize(simulation_result *self,const MODEL_DATA *modelData)
+/* Column layout of the result data: time, $cpuTime, variables, aliases. */
+static void initGather(simulation_result *self, const MODEL_DATA *modelData, OUTPUT_GATHER *gather)
 {
-  int sz = 1, i; /* time */
-  if(self->cpuTime)
-    sz++; /* $cpuTime */
-  for(i = 0; i < modelData->nVariablesReal; i++) if(!modelData->realVarsData[i].filterOutput) sz++;
-  for(i = 0; i < modelData->nVariablesInteger; i++) if(!modelData->integerVarsData[i].filterOutput) sz++;
-  for(i = 0; i < modelData->nVariablesBoolean; i++) if(!modelData->booleanVarsData[i].filterOutput) sz++;
+  int i;
+  initOutputGather(gather);
+  reserveOutputColumns(gather, self->cpuTime ? 2 : 1); /* time, $cpuTime */
+  for(i = 0; i < modelData->nVariablesReal; i++) if(!modelData->realVarsData[i].filterOutput) addOutputColumn(gather, OUTPUT_SOURCE_REAL_VARS, i, 0);
+  for(i = 0; i < modelData->nVariablesInteger; i++) if(!modelData->integerVarsData[i].filterOutput) addOutputColumn(gather, OUTPUT_SOURCE_INTEGER_VARS, i, 0);
+  for(i = 0; i < modelData->nVariablesBoolean; i++) if(!modelData->booleanVarsData[i].filterOutput) addOutputColumn(gather, OUTPUT_SOURCE_BOOLEAN_VARS, i, 0);
   /* for(int i = 0; i < modelData->nVariablesString; i++) if(!modelData->stringVarsData[i].filterOutput) sz++; */
 
-  for(i = 0; i < modelData->nAliasReal; i++) if(!modelData->realAlias[i].filterOutput) sz++;
-  for(i = 0; i < modelData->nAliasInteger; i++) if(!modelData->integerAlias[i].filterOutput) sz++;
-  for(i = 0; i < modelData->nAliasBoolean; i++) if(!modelData->booleanAlias[i].filterOutput) sz++;
+  for(i = 0; i < modelData->nAliasReal; i++) if(!modelData->realAlias[i].filterOutput) addAliasColumn(gather, OUTPUT_SOURCE_REAL_VARS, &modelData->realAlias[i]);
+  for(i = 0; i < modelData->nAliasInteger; i++) if(!modelData->integerAlias[i].filterOutput) addAliasColumn(gather, OUTPUT_SOURCE_INTEGER_VARS, &modelData->integerAlias[i]);
+  for(i = 0; i < modelData->nAliasBoolean; i++) if(!modelData->booleanAlias[i].filterOutput) addAliasColumn(gather, OUTPUT_SOURCE_BOOLEAN_VARS, &modelData->booleanAlias[i]);
   /* for(int i = 0; i < modelData->nAliasString; i++) if(!modelData->stringAlias[i].filterOutput) sz++; */
-
-  return sz;
 }
 
 void plt_emit(simulation_result *self,DATA *data, threadData_t *threadData)
 {
   plt_data *pltData = (plt_data*) self->storage;
-  rt_tick(SIM_TIMER_OUTPUT);
+  double cpuTimeValue = sim_result_startEmit(self);
   if(pltData->actualPoints < pltData->maxPoints) {
-      add_result(self,data,pltData->simulationResultData,&pltData->actualPoints); /*used for non-interactive simulation */
+      add_result(self,data,pltData->simulationResultData,&pltData->actualPoints,cpuTimeValue); /*used for non-interactive simulation */
   } else {
     pltData->maxPoints = (long)(1.4*pltData->maxPoints + (pltData->maxPoints-pltData->actualPoints) + 2000);
     /* cerr << "realloc simulationResultData to a size of " << maxPoints * dataSize * sizeof(double) << endl; */
@@ -94,95 +95,25 @@ void plt_emit(simulation_result *self,DATA *data, threadData_t *threadData)
     if(!pltData->simulationResultData) {
       throwStreamPrint(threadData, "Error allocating simulation result data of size %ld",pltData->maxPoints * pltData->dataSize);
     }
-    add_result(self,data,pltData->simulationResultData,&pltData->actualPoints);
+    add_result(self,data,pltData->simulationResultData,&pltData->actualPoints,cpuTimeValue);
   }
-  rt_accumulate(SIM_TIMER_OUTPUT);
+  sim_result_endEmit(self);
 }
 
 /*
  * add the values of one step for all variables to the data
  * array to be able to later store this on file.
  */
-static void add_result(simulation_result *self,DATA *data,double *data_, long *actualPoints)
+static void add_result(simulation_result *self,DATA *data,double *data_, long *actualPoints, double cpuTimeValue)
 {
   plt_data *pltData = (plt_data*) self->storage;
   const DATA *simData = data;
-  int i;
-  double cpuTimeValue = 0;
-
-  rt_accumulate(SIM_TIMER_TOTAL);
-  cpuTimeValue = rt_accumulated(SIM_TIMER_TOTAL);
-  rt_tick(SIM_TIMER_TOTAL);
-
-  {
-    data_[pltData->currentPos++] = simData->localData[0]->timeValue;
 
-    if(self->cpuTime)
-      data_[pltData->currentPos++] = cpuTimeValue;
-
-    /* .. reals .. */
-    for(i = 0; i < simData->modelData->nVariablesReal; i++) {
-      if(!simData->modelData->realVarsData[i].filterOutput) {
-        data_[pltData->currentPos++] = simData->localData[0]->realVars[i];
-      }
-    }
-    /* .. integers .. */
-    for(i = 0; i < simData->modelData->nVariablesInteger; i++) {
-      if(!simData->modelData->integerVarsData[i].filterOutput) {
-        data_[pltData->currentPos++] = simData->localData[0]->integerVars[i];
-      }
-    }
-    /* .. booleans .. */
-    for(i = 0; i < simData->modelData->nVariablesBoolean; i++) {
-      if(!simData->modelData->booleanVarsData[i].filterOutput) {
-        data_[pltData->currentPos++] = simData->localData[0]->booleanVars[i];
-      }
-    }
-    /* .. alias reals .. */
-    for(i = 0; i < simData->modelData->nAliasReal; i++) {
-      if(!simData->modelData->realAlias[i].filterOutput) {
-        double value;
-        if(simData->modelData->realAlias[i].aliasType == 2)
-          value = (simData->localData[0])->timeValue;
-        else if(simData->modelData->realAlias[i].aliasType == 1)
-          value = simData->simulationInfo->realParameter[simData->modelData->realAlias[i].nameID];
-        else
-          value = (simData->localData[0])->realVars[simData->modelData->realAlias[i].nameID];
-        if(simData->modelData->realAlias[i].negate)
-          data_[pltData->currentPos++] = -value;
-        else
-          data_[pltData->currentPos++] = value;
-      }
-    }
-    /* .. alias integers .. */
-    for(i = 0; i < simData->modelData->nAliasInteger; i++) {
-      if(!simData->modelData->integerAlias[i].filterOutput) {
-        modelica_integer value;
-        if(simData->modelData->integerAlias[i].aliasType == 1)
-          value = simData->simulationInfo->integerParameter[simData->modelData->realAlias[i].nameID];
-        else
-          value = (simData->localData[0])->integerVars[simData->modelData->realAlias[i].nameID];
-        if(simData->modelData->integerAlias[i].negate)
-          data_[pltData->currentPos++] = -value;
-        else
-          data_[pltData->currentPos++] = value;
-      }
-    }
-    /* .. alias booleans .. */
-    for(i = 0; i < simData->modelData->nAliasBoolean; i++) {
-      if(!simData->modelData->booleanAlias[i].filterOutput) {
-        modelica_boolean value;
-        if(simData->modelData->integerAlias[i].aliasType == 1)
-          value = simData->simulationInfo->booleanParameter[simData->modelData->realAlias[i].nameID];
-        else
-          value = (simData->localData[0])->booleanVars[simData->modelData->realAlias[i].nameID];
-        if(simData->modelData->booleanAlias[i].negate)
-          data_[pltData->currentPos++] = value==1?0:1;
-        else
-          data_[pltData->currentPos++] = value;
-      }
-    }
-  }
+  data_[pltData->currentPos] = simData->localData[0]->timeValue;
+  if(self->cpuTime)
+    data_[pltData->currentPos + 1] = cpuTimeValue;
+  gatherOutputRow(&pltData->gather, simData, data_ + pltData->currentPos);
+  pltData->currentPos += pltData->gather.nColumns;
 
   /*cerr << "  ... done" << endl; */
   (*actualPoints)++;
@@ -203,8 +134,9 @@ void plt_init(simulation_result *self,DATA *data, threadData_t *threadData)
 
   assertStreamPrint(threadData, self->numpoints >= 0, "Automatic output steps not supported in OpenModelica yet. Set numpoints >= 0.");
 
-  pltData->num_vars = calcDataSize(self,data->modelData);
-  pltData->dataSize = calcDataSize(self,data->modelData);
+  initGather(self, data->modelData, &pltData->gather);
+  pltData->num_vars = pltData->gather.nColumns;
+  pltData->dataSize = pltData->gather.nColumns;
   pltData->simulationResultData = (double*)malloc(self->numpoints * pltData->dataSize * sizeof(double));
   if(!pltData->simulationResultData) {
     throwStreamPrint(threadData, "Error allocating simulation result data of size %ld failed",self->numpoints * pltData->dataSize);
@@ -227,6 +159,7 @@ static void deallocResult(plt_data *pltData)
     free(pltData->simulationResultData);
     pltData->simulationResultData = 0;
   }
+  freeOutputGather(&pltData->gather);
 }
 
 static void printPltLine(FILE* f, double time, double val)
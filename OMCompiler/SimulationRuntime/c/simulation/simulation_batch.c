@@ -0,0 +1,306 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+
+/*! \file simulation_batch.c
+ *
+ *  Parameter sweeps with -batch=<file>. The model description is read once,
+ *  then every row of the file is simulated in a worker process forked from
+ *  the loaded model. The workers share the parsed data copy-on-write and
+ *  don't contend for the global state of the runtime (result writer,
+ *  solver statics, jump buffers), which is not safe to share between
+ *  threads.
+ */
+
+#include "simulation_batch.h"
+#include "simulation_runtime.h"
+#include "options.h"
+#include "../util/omc_error.h"
+#include "../util/read_csv.h"
+#include "../util/simulation_options.h"
+
+#include <errno.h>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(__MINGW32__) && !defined(_MSC_VER)
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+typedef enum
+{
+  BATCH_START_TIME,
+  BATCH_STOP_TIME,
+  BATCH_STEP_SIZE,
+  BATCH_TOLERANCE,
+  BATCH_REAL_PARAMETER,
+  BATCH_INTEGER_PARAMETER,
+  BATCH_BOOLEAN_PARAMETER,
+  BATCH_REAL_VARIABLE,
+  BATCH_INTEGER_VARIABLE,
+  BATCH_BOOLEAN_VARIABLE
+} BATCH_TARGET;
+
+/* Value that is set by one column of the batch file */
+typedef struct
+{
+  BATCH_TARGET target;
+  long index;
+} BATCH_COLUMN;
+
+#if !defined(__MINGW32__) && !defined(_MSC_VER)
+
+#define FIND_BATCH_VARIABLE(n, vars, kind) \
+  for (i = 0; i < (n); i++) { \
+    if (0 == strcmp((vars)[i].info.name, name)) { \
+      column->target = (kind); \
+      column->index = i; \
+      return 1; \
+    } \
+  }
+
+/**
+ * @brief Find the variable that is set by a column of the batch file.
+ *
+ * @return int    1 if the name is known, 0 otherwise.
+ */
+static int findBatchColumn(MODEL_DATA *modelData, const char *name, BATCH_COLUMN *column)
+{
+  long i;
+
+  column->index = 0;
+  if (0 == strcmp(name, "startTime")) {
+    column->target = BATCH_START_TIME;
+    return 1;
+  } else if (0 == strcmp(name, "stopTime")) {
+    column->target = BATCH_STOP_TIME;
+    return 1;
+  } else if (0 == strcmp(name, "stepSize")) {
+    column->target = BATCH_STEP_SIZE;
+    return 1;
+  } else if (0 == strcmp(name, "tolerance")) {
+    column->target = BATCH_TOLERANCE;
+    return 1;
+  }
+
+  FIND_BATCH_VARIABLE(modelData->nParametersReal, modelData->realParameterData, BATCH_REAL_PARAMETER)
+  FIND_BATCH_VARIABLE(modelData->nParametersInteger, modelData->integerParameterData, BATCH_INTEGER_PARAMETER)
+  FIND_BATCH_VARIABLE(modelData->nParametersBoolean, modelData->booleanParameterData, BATCH_BOOLEAN_PARAMETER)
+  FIND_BATCH_VARIABLE(modelData->nVariablesReal, modelData->realVarsData, BATCH_REAL_VARIABLE)
+  FIND_BATCH_VARIABLE(modelData->nVariablesInteger, modelData->integerVarsData, BATCH_INTEGER_VARIABLE)
+  FIND_BATCH_VARIABLE(modelData->nVariablesBoolean, modelData->booleanVarsData, BATCH_BOOLEAN_VARIABLE)
+  return 0;
+}
+
+#undef FIND_BATCH_VARIABLE
+
+/* Set the start values of one row, like -override does before the model is initialized */
+static void applyBatchRow(DATA *data, struct csv_data *sets, const BATCH_COLUMN *columns, int row)
+{
+  MODEL_DATA *modelData = data->modelData;
+  SIMULATION_INFO *simulationInfo = data->simulationInfo;
+  int i;
+
+  for (i = 0; i < sets->numvars; i++) {
+    double value = sets->data[i*sets->numsteps + row];
+    long index = columns[i].index;
+    switch (columns[i].target) {
+    case BATCH_START_TIME:        simulationInfo->startTime = value; break;
+    case BATCH_STOP_TIME:         simulationInfo->stopTime = value; break;
+    case BATCH_STEP_SIZE:         simulationInfo->stepSize = value; break;
+    case BATCH_TOLERANCE:         simulationInfo->tolerance = value; break;
+    case BATCH_REAL_PARAMETER:    modelData->realParameterData[index].attribute.start = value; break;
+    case BATCH_INTEGER_PARAMETER: modelData->integerParameterData[index].attribute.start = (modelica_integer) value; break;
+    case BATCH_BOOLEAN_PARAMETER: modelData->booleanParameterData[index].attribute.start = value != 0; break;
+    case BATCH_REAL_VARIABLE:     modelData->realVarsData[index].attribute.start = value; break;
+    case BATCH_INTEGER_VARIABLE:  modelData->integerVarsData[index].attribute.start = (modelica_integer) value; break;
+    case BATCH_BOOLEAN_VARIABLE:  modelData->booleanVarsData[index].attribute.start = value != 0; break;
+    }
+    infoStreamPrint(LOG_SOLVER, 0, "batch %s = %g", sets->variables[i], value);
+  }
+  simulationInfo->minStepSize = 4.0 * DBL_EPSILON * fmax(fabs(simulationInfo->startTime), fabs(simulationInfo->stopTime));
+}
+
+/**
+ * @brief Name of the result file of a run.
+ *
+ * The run number is appended to the name given by -r, otherwise the
+ * result is named <model>_res_<run>.<format> like a single run would be.
+ */
+static const char* batchFileName(DATA *data, int run, const char *extension)
+{
+  const char *result = omc_flagValue[FLAG_R];
+  const char *dot, *separator;
+  const char *fileName = NULL;
+  int res;
+
+  if (result) {
+    dot = strrchr(result, '.');
+    separator = strrchr(result, '/');
+    if (dot && (!separator || dot > separator)) {
+      res = GC_asprintf(&fileName, "%.*s_%d%s", (int)(dot - result), result, run, extension ? extension : dot);
+    } else {
+      res = GC_asprintf(&fileName, "%s_%d%s", result, run, extension ? extension : "");
+    }
+  } else if (omc_flag[FLAG_OUTPUT_PATH]) {
+    res = GC_asprintf(&fileName, "%s/%s_res_%d%s%s", omc_flagValue[FLAG_OUTPUT_PATH], data->modelData->modelFilePrefix, run,
+                      extension ? "" : ".", extension ? extension : data->simulationInfo->outputFormat);
+  } else {
+    res = GC_asprintf(&fileName, "%s_res_%d%s%s", data->modelData->modelFilePrefix, run,
+                      extension ? "" : ".", extension ? extension : data->simulationInfo->outputFormat);
+  }
+  if (0 > res) {
+    throwStreamPrint(NULL, "simulation_batch.c: Error: can not allocate memory.");
+  }
+  return fileName;
+}
+
+/* Body of a worker process, simulates one row of the batch file */
+static int runBatchRow(int argc, char **argv, DATA *data, threadData_t *threadData, struct csv_data *sets, const BATCH_COLUMN *columns, int row)
+{
+  const char *logFile = batchFileName(data, row + 1, ".log");
+  int retVal = 1;
+
+  if (!freopen(logFile, "w", stdout)) {
+    warningStreamPrint(LOG_STDOUT, 0, "Could not open log file %s of batch run %d.", logFile, row + 1);
+  }
+
+  MMC_TRY_INTERNAL(globalJumpBuffer)
+    applyBatchRow(data, sets, columns, row);
+    omc_flag[FLAG_R] = 1;
+    omc_flagValue[FLAG_R] = batchFileName(data, row + 1, NULL);
+    retVal = startNonInteractiveSimulation(argc, argv, data, threadData);
+  MMC_CATCH_INTERNAL(globalJumpBuffer)
+
+  fflush(NULL);
+  return retVal;
+}
+
+/**
+ * @brief Simulate every row of the file given by -batch.
+ *
+ * The first line of the file names the parameters, start values or
+ * experiment settings (startTime, stopTime, stepSize, tolerance) that are
+ * set, every further line is one run. Up to -batchProcesses runs are
+ * simulated at the same time, each writes its own result and log file.
+ *
+ * @return int    0 if all runs succeeded.
+ */
+int runBatchSimulation(int argc, char **argv, DATA *data, threadData_t *threadData)
+{
+  struct csv_data *sets = read_csv(omc_flagValue[FLAG_BATCH]);
+  BATCH_COLUMN *columns;
+  pid_t *pids;
+  int i, row = 0, running = 0, failed = 0, nProcesses, status;
+  pid_t pid;
+
+  if (!sets) {
+    errorStreamPrint(LOG_STDOUT, 0, "Could not read batch file %s.", omc_flagValue[FLAG_BATCH]);
+    return 1;
+  }
+
+  columns = (BATCH_COLUMN*) malloc(sets->numvars * sizeof(BATCH_COLUMN));
+  pids = (pid_t*) calloc(sets->numsteps, sizeof(pid_t));
+  for (i = 0; i < sets->numvars; i++) {
+    if (!findBatchColumn(data->modelData, sets->variables[i], &columns[i])) {
+      errorStreamPrint(LOG_STDOUT, 0, "Batch file %s sets %s, which is not a parameter or variable of the model.", omc_flagValue[FLAG_BATCH], sets->variables[i]);
+      free(columns);
+      free(pids);
+      omc_free_csv_reader(sets);
+      return 1;
+    }
+  }
+
+  nProcesses = omc_flag[FLAG_BATCH_PROCESSES] ? atoi(omc_flagValue[FLAG_BATCH_PROCESSES]) : (int) sysconf(_SC_NPROCESSORS_ONLN);
+  if (nProcesses < 1) {
+    nProcesses = 1;
+  }
+  infoStreamPrint(LOG_STDOUT, 0, "Simulating %d parameter sets from %s with up to %d processes.", sets->numsteps, omc_flagValue[FLAG_BATCH], nProcesses);
+
+  while (row < sets->numsteps || running > 0) {
+    if (row < sets->numsteps && running < nProcesses) {
+      fflush(NULL);
+      pid = fork();
+      if (0 == pid) {
+        _exit(runBatchRow(argc, argv, data, threadData, sets, columns, row) ? 1 : 0);
+      } else if (pid < 0) {
+        errorStreamPrint(LOG_STDOUT, 0, "Could not start batch run %d: %s", row + 1, strerror(errno));
+        failed++;
+      } else {
+        pids[row] = pid;
+        running++;
+      }
+      row++;
+      continue;
+    }
+
+    pid = waitpid(-1, &status, 0);
+    if (pid < 0) {
+      if (EINTR == errno) {
+        continue;
+      }
+      errorStreamPrint(LOG_STDOUT, 0, "Lost track of the batch runs: %s", strerror(errno));
+      failed += running;
+      break;
+    }
+    for (i = 0; i < row && pids[i] != pid; i++);
+    if (i == row) {
+      continue;
+    }
+    running--;
+    if (WIFEXITED(status) && 0 == WEXITSTATUS(status)) {
+      infoStreamPrint(LOG_STDOUT, 0, "Batch run %d finished, result %s", i + 1, batchFileName(data, i + 1, NULL));
+    } else {
+      warningStreamPrint(LOG_STDOUT, 0, "Batch run %d failed, see %s", i + 1, batchFileName(data, i + 1, ".log"));
+      failed++;
+    }
+  }
+
+  infoStreamPrint(LOG_STDOUT, 0, "%d of %d batch runs succeeded.", sets->numsteps - failed, sets->numsteps);
+  free(columns);
+  free(pids);
+  omc_free_csv_reader(sets);
+  return failed ? 1 : 0;
+}
+
+#else
+
+int runBatchSimulation(int argc, char **argv, DATA *data, threadData_t *threadData)
+{
+  errorStreamPrint(LOG_STDOUT, 0, "The simulation flag -batch is not supported on this platform.");
+  return 1;
+}
+
+#endif
@@ -0,0 +1,980 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+#include "util/omc_error.h"
+#include "simulation_log_binary.h"
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined(OM_HAVE_PTHREADS)
+#include <pthread.h>
+#endif
+
+/* size of the buffer of one thread, full buffers are handed to the writer */
+#define BINARY_LOG_CHUNK_SIZE (1024*1024)
+/* number of full buffers that can be queued before the threads wait for the writer */
+#define BINARY_LOG_MAX_QUEUED 64
+/* strings in arguments are truncated like formatted messages */
+#define BINARY_LOG_MAX_STRING 2048
+
+static const char BINARY_LOG_MAGIC[8] = {'O','M','C','B','L','O','G','1'};
+static const uint32_t BINARY_LOG_BYTE_ORDER = 0x01020304;
+
+/*
+ * File layout:
+ *   magic, byte order mark, number of streams, names of the streams
+ *   chunks: thread number, number of bytes, records
+ * Records:
+ *   RECORD_FORMAT         format id, length, format string
+ *   RECORD_MESSAGE        type, stream, indentNext, format id, indexes, arguments
+ *   RECORD_CLOSE          stream
+ *   RECORD_CLOSE_WARNING  stream
+ * Format ids are numbered per thread, the format is recorded before its first use.
+ * Integer arguments are stored as 64 bit integers, floating point arguments
+ * as double, strings with their length and pointers as 64 bit integers.
+ */
+enum BINARY_LOG_RECORD
+{
+  RECORD_FORMAT = 1,
+  RECORD_MESSAGE,
+  RECORD_CLOSE,
+  RECORD_CLOSE_WARNING
+};
+
+enum FORMAT_ARG
+{
+  ARG_INT,
+  ARG_UINT,
+  ARG_CHAR,
+  ARG_DOUBLE,
+  ARG_STRING,
+  ARG_POINTER,
+  ARG_COUNT
+};
+
+/* One conversion of a printf format */
+typedef struct format_spec
+{
+  const char *begin;     /* '%' of the conversion */
+  const char *end;       /* after the conversion character */
+  int widthArg;          /* width is given by an argument */
+  int precisionArg;      /* precision is given by an argument */
+  long precision;        /* precision, -1 if not given */
+  char length[3];        /* length modifier */
+  int arg;               /* FORMAT_ARG */
+} format_spec;
+
+/**
+ * @brief Find the next conversion of a printf format.
+ *
+ * @param pos     Position in the format, moved after the conversion.
+ * @param spec    Parsed conversion.
+ * @return int    1 if a conversion was found, 0 at the end of the format
+ *                and -1 for conversions that can't be recorded.
+ */
+static int nextConversion(const char **pos, format_spec *spec)
+{
+  const char *p = *pos;
+  size_t n = 0;
+
+  for (p = strchr(p, '%'); p && p[1] == '%'; p = strchr(p + 2, '%'));
+  if (!p) {
+    return 0;
+  }
+
+  spec->begin = p++;
+  while (*p && strchr("-+ #0'", *p)) {
+    p++;
+  }
+  spec->widthArg = (*p == '*');
+  if (spec->widthArg) {
+    p++;
+  } else {
+    while (isdigit((unsigned char)*p)) p++;
+  }
+  spec->precisionArg = 0;
+  spec->precision = -1;
+  if (*p == '.') {
+    p++;
+    spec->precisionArg = (*p == '*');
+    if (spec->precisionArg) {
+      p++;
+    } else {
+      spec->precision = strtol(p, NULL, 10);
+      while (isdigit((unsigned char)*p)) p++;
+    }
+  }
+
+  if ((p[0] == 'h' && p[1] == 'h') || (p[0] == 'l' && p[1] == 'l')) {
+    n = 2;
+  } else if (*p && strchr("hljztLq", *p)) {
+    n = 1;
+  }
+  memcpy(spec->length, p, n);
+  spec->length[n] = '\0';
+  p += n;
+
+  switch (*p) {
+  case 'd': case 'i':
+    spec->arg = ARG_INT;
+    break;
+  case 'u': case 'o': case 'x': case 'X':
+    spec->arg = ARG_UINT;
+    break;
+  case 'c':
+    if (n) return -1;
+    spec->arg = ARG_CHAR;
+    break;
+  case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+    spec->arg = ARG_DOUBLE;
+    break;
+  case 's':
+    if (n) return -1;
+    spec->arg = ARG_STRING;
+    break;
+  case 'p':
+    spec->arg = ARG_POINTER;
+    break;
+  case 'n':
+    spec->arg = ARG_COUNT;
+    break;
+  default:
+    return -1;
+  }
+
+  spec->end = p + 1;
+  *pos = spec->end;
+  return 1;
+}
+
+/* Bounded writer for one record */
+typedef struct record_writer
+{
+  char *pos;
+  char *end;
+  int ok;
+} record_writer;
+
+static void put(record_writer *w, const void *data, size_t size)
+{
+  if (!w->ok || (size_t)(w->end - w->pos) < size) {
+    w->ok = 0;
+    return;
+  }
+  memcpy(w->pos, data, size);
+  w->pos += size;
+}
+
+template<typename T>
+static void putValue(record_writer *w, T value)
+{
+  put(w, &value, sizeof(T));
+}
+
+static int64_t signedArg(va_list *args, const char *length)
+{
+  if (!strcmp(length, "l")) return va_arg(*args, long);
+  if (!strcmp(length, "ll") || !strcmp(length, "q")) return va_arg(*args, long long);
+  if (!strcmp(length, "j")) return va_arg(*args, intmax_t);
+  if (!strcmp(length, "z") || !strcmp(length, "t")) return va_arg(*args, ptrdiff_t);
+  return va_arg(*args, int);
+}
+
+static uint64_t unsignedArg(va_list *args, const char *length)
+{
+  if (!strcmp(length, "l")) return va_arg(*args, unsigned long);
+  if (!strcmp(length, "ll") || !strcmp(length, "q")) return va_arg(*args, unsigned long long);
+  if (!strcmp(length, "j")) return va_arg(*args, uintmax_t);
+  if (!strcmp(length, "z") || !strcmp(length, "t")) return va_arg(*args, size_t);
+  return va_arg(*args, unsigned int);
+}
+
+/**
+ * @brief Write the arguments of format to w.
+ *
+ * @return int    0 if the format contains conversions that can't be recorded.
+ */
+static int putArguments(record_writer *w, const char *format, va_list *args)
+{
+  format_spec spec;
+  const char *pos = format;
+  int found;
+
+  while ((found = nextConversion(&pos, &spec)) > 0) {
+    if (spec.widthArg) {
+      putValue<int64_t>(w, va_arg(*args, int));
+    }
+    if (spec.precisionArg) {
+      spec.precision = va_arg(*args, int);
+      putValue<int64_t>(w, spec.precision);
+    }
+    switch (spec.arg) {
+    case ARG_INT:
+      putValue<int64_t>(w, signedArg(args, spec.length));
+      break;
+    case ARG_UINT:
+      putValue<uint64_t>(w, unsignedArg(args, spec.length));
+      break;
+    case ARG_CHAR:
+      putValue<int64_t>(w, va_arg(*args, int));
+      break;
+    case ARG_DOUBLE:
+      if (!strcmp(spec.length, "L")) {
+        putValue<double>(w, (double)va_arg(*args, long double));
+      } else {
+        putValue<double>(w, va_arg(*args, double));
+      }
+      break;
+    case ARG_STRING: {
+      const char *str = va_arg(*args, const char*);
+      size_t maxLength = BINARY_LOG_MAX_STRING;
+      uint32_t length;
+      if (!str) {
+        str = "(null)";
+      }
+      if (spec.precision >= 0 && (size_t)spec.precision < maxLength) {
+        maxLength = spec.precision;
+      }
+      for (length = 0; length < maxLength && str[length]; length++);
+      putValue<uint32_t>(w, length);
+      put(w, str, length);
+      break;
+    }
+    case ARG_POINTER:
+      putValue<uint64_t>(w, (uint64_t)(uintptr_t)va_arg(*args, void*));
+      break;
+    case ARG_COUNT:
+      (void)va_arg(*args, void*);
+      break;
+    }
+  }
+  return found == 0;
+}
+
+/* Bounded reader for one record */
+typedef struct record_reader
+{
+  const char *pos;
+  const char *end;
+  int ok;
+} record_reader;
+
+static void get(record_reader *r, void *data, size_t size)
+{
+  if (!r->ok || (size_t)(r->end - r->pos) < size) {
+    r->ok = 0;
+    memset(data, 0, size);
+    return;
+  }
+  memcpy(data, r->pos, size);
+  r->pos += size;
+}
+
+template<typename T>
+static T getValue(record_reader *r)
+{
+  T value;
+  get(r, &value, sizeof(T));
+  return value;
+}
+
+/* Append the output of snprintf to msg */
+template<typename T>
+static void appendFormatted(std::string &msg, const std::string &format, T value)
+{
+  char buffer[BINARY_LOG_MAX_STRING + 64];
+  int n = snprintf(buffer, sizeof(buffer), format.c_str(), value);
+  if (n > 0) {
+    msg.append(buffer, (size_t)n < sizeof(buffer) ? (size_t)n : sizeof(buffer) - 1);
+  }
+}
+
+/**
+ * @brief Format a recorded message, the inverse of putArguments.
+ */
+static std::string formatArguments(record_reader *r, const char *format)
+{
+  std::string msg, conversion;
+  format_spec spec;
+  const char *pos = format, *literal = format;
+  const char *p;
+  char number[32];
+
+  while (nextConversion(&pos, &spec) > 0) {
+    /* the text before the conversion is part of the snprintf format, so %% is handled there */
+    conversion.assign(literal, spec.begin - literal);
+    literal = spec.end;
+
+    p = spec.begin;
+    conversion += *p++;
+    while (*p && strchr("-+ #0'", *p)) conversion += *p++;
+    if (spec.widthArg) {
+      snprintf(number, sizeof(number), "%ld", (long)getValue<int64_t>(r));
+      conversion += number;
+      p++;
+    } else {
+      while (isdigit((unsigned char)*p)) conversion += *p++;
+    }
+    if (*p == '.') {
+      conversion += *p++;
+      if (spec.precisionArg) {
+        snprintf(number, sizeof(number), "%ld", (long)getValue<int64_t>(r));
+        conversion += number;
+        p++;
+      } else {
+        while (isdigit((unsigned char)*p)) conversion += *p++;
+      }
+    }
+
+    switch (spec.arg) {
+    case ARG_INT:
+      conversion += "ll";
+      conversion += spec.end[-1];
+      appendFormatted(msg, conversion, (long long)getValue<int64_t>(r));
+      break;
+    case ARG_UINT:
+      conversion += "ll";
+      conversion += spec.end[-1];
+      appendFormatted(msg, conversion, (unsigned long long)getValue<uint64_t>(r));
+      break;
+    case ARG_CHAR:
+      conversion += 'c';
+      appendFormatted(msg, conversion, (int)getValue<int64_t>(r));
+      break;
+    case ARG_DOUBLE:
+      conversion += spec.end[-1];
+      appendFormatted(msg, conversion, getValue<double>(r));
+      break;
+    case ARG_STRING: {
+      uint32_t length = getValue<uint32_t>(r);
+      std::string str;
+      if (r->ok && (size_t)(r->end - r->pos) >= length) {
+        str.assign(r->pos, length);
+        r->pos += length;
+      } else {
+        r->ok = 0;
+      }
+      conversion += 's';
+      appendFormatted(msg, conversion, str.c_str());
+      break;
+    }
+    case ARG_POINTER:
+      conversion += 'p';
+      appendFormatted(msg, conversion, (void*)(uintptr_t)getValue<uint64_t>(r));
+      break;
+    case ARG_COUNT:
+      conversion.erase(conversion.size() - (p - spec.begin));
+      appendFormatted(msg, conversion + "%s", "");
+      break;
+    }
+  }
+  appendFormatted(msg, std::string(literal) + "%s", "");
+  return msg;
+}
+
+static int isTextStream(int stream)
+{
+  return stream == LOG_UNKNOWN || stream == LOG_STDOUT || stream == LOG_ASSERT || stream == LOG_SUCCESS;
+}
+
+#if defined(OM_HAVE_PTHREADS)
+
+typedef struct log_chunk
+{
+  uint32_t thread;
+  uint32_t used;
+  char data[BINARY_LOG_CHUNK_SIZE];
+} log_chunk;
+
+/* Log state of one thread, only touched by the thread itself */
+typedef struct thread_log
+{
+  uint32_t thread;
+  log_chunk *chunk;
+  std::unordered_map<const char*, uint32_t> formatIds;
+  std::vector<std::string> formats;
+} thread_log;
+
+typedef struct binary_log
+{
+  FILE *file;
+  int failed;
+  int stop;
+  uint32_t nThreads;
+  std::vector<thread_log*> threads;
+  std::vector<log_chunk*> queued;   /* full chunks in the order they were handed over */
+  std::vector<log_chunk*> unused;
+
+  /* backend that prints text messages */
+  void (*textFunction)(int type, int stream, FILE_INFO info, int indentNext, char *msg, int subline, const int *indexes);
+  void (*textClose)(int stream);
+  void (*textCloseWarning)(int stream);
+
+  pthread_key_t key;
+  pthread_t writer;
+  pthread_mutex_t mutex;
+  pthread_cond_t chunkQueued;
+  pthread_cond_t chunkWritten;
+} binary_log;
+
+static binary_log *binaryLog = NULL;
+
+static log_chunk* newChunk(uint32_t thread)
+{
+  log_chunk *chunk;
+
+  pthread_mutex_lock(&binaryLog->mutex);
+  if (binaryLog->unused.empty()) {
+    chunk = (log_chunk*) malloc(sizeof(log_chunk));
+  } else {
+    chunk = binaryLog->unused.back();
+    binaryLog->unused.pop_back();
+  }
+  pthread_mutex_unlock(&binaryLog->mutex);
+
+  if (chunk) {
+    chunk->thread = thread;
+    chunk->used = 0;
+  }
+  return chunk;
+}
+
+/* Hand the chunk of a thread to the writer, waits if the writer is too far behind */
+static void queueChunk(thread_log *log)
+{
+  if (!log->chunk || log->chunk->used == 0) {
+    return;
+  }
+
+  pthread_mutex_lock(&binaryLog->mutex);
+  while (binaryLog->queued.size() >= BINARY_LOG_MAX_QUEUED && !binaryLog->stop) {
+    pthread_cond_wait(&binaryLog->chunkWritten, &binaryLog->mutex);
+  }
+  binaryLog->queued.push_back(log->chunk);
+  pthread_cond_signal(&binaryLog->chunkQueued);
+  pthread_mutex_unlock(&binaryLog->mutex);
+
+  log->chunk = newChunk(log->thread);
+}
+
+static void* binaryLogWriterThread(void *arg)
+{
+  binary_log *out = (binary_log*) arg;
+  log_chunk *chunk;
+
+  pthread_mutex_lock(&out->mutex);
+  while (1) {
+    while (out->queued.empty() && !out->stop) {
+      pthread_cond_wait(&out->chunkQueued, &out->mutex);
+    }
+    if (out->queued.empty()) {
+      break;
+    }
+    chunk = out->queued.front();
+    out->queued.erase(out->queued.begin());
+    pthread_mutex_unlock(&out->mutex);
+
+    if (1 != fwrite(&chunk->thread, sizeof(uint32_t), 1, out->file) ||
+        1 != fwrite(&chunk->used, sizeof(uint32_t), 1, out->file) ||
+        chunk->used != fwrite(chunk->data, 1, chunk->used, out->file)) {
+      out->failed = 1;
+    }
+    fflush(out->file);
+
+    pthread_mutex_lock(&out->mutex);
+    out->unused.push_back(chunk);
+    pthread_cond_broadcast(&out->chunkWritten);
+  }
+  pthread_mutex_unlock(&out->mutex);
+  return NULL;
+}
+
+static void threadLogExit(void *data)
+{
+  thread_log *log = (thread_log*) data;
+  size_t i;
+
+  if (binaryLog) {
+    queueChunk(log);
+    pthread_mutex_lock(&binaryLog->mutex);
+    for (i = 0; i < binaryLog->threads.size(); i++) {
+      if (binaryLog->threads[i] == log) {
+        binaryLog->threads.erase(binaryLog->threads.begin() + i);
+        break;
+      }
+    }
+    if (log->chunk) {
+      binaryLog->unused.push_back(log->chunk);
+    }
+    pthread_mutex_unlock(&binaryLog->mutex);
+  } else {
+    free(log->chunk);
+  }
+  delete log;
+}
+
+static thread_log* getThreadLog()
+{
+  thread_log *log = (thread_log*) pthread_getspecific(binaryLog->key);
+
+  if (!log) {
+    log = new thread_log;
+    pthread_mutex_lock(&binaryLog->mutex);
+    log->thread = binaryLog->nThreads++;
+    binaryLog->threads.push_back(log);
+    pthread_mutex_unlock(&binaryLog->mutex);
+    log->chunk = newChunk(log->thread);
+    pthread_setspecific(binaryLog->key, log);
+  }
+  return log;
+}
+
+/**
+ * @brief Get the id of format for the calling thread.
+ *
+ * Formats are identified by their address, the text is compared as well
+ * so reused buffers get a new id. A new format is recorded in w.
+ */
+static uint32_t formatId(thread_log *log, record_writer *w, const char *format, int *isNew)
+{
+  std::unordered_map<const char*, uint32_t>::iterator it = log->formatIds.find(format);
+  uint32_t id, length;
+
+  if (it != log->formatIds.end() && log->formats[it->second] == format) {
+    *isNew = 0;
+    return it->second;
+  }
+
+  id = (uint32_t) log->formats.size();
+  length = (uint32_t) strlen(format);
+  putValue<uint8_t>(w, RECORD_FORMAT);
+  putValue<uint32_t>(w, id);
+  putValue<uint32_t>(w, length);
+  put(w, format, length);
+  *isNew = 1;
+  return id;
+}
+
+/**
+ * @brief Record one message in the buffer of the calling thread.
+ *
+ * @return int    1 if the message was recorded, 0 if it has to be formatted.
+ */
+static int recordMessage(int type, int stream, int indentNext, const int *indexes, const char *format, va_list args)
+{
+  thread_log *log = getThreadLog();
+  record_writer w;
+  uint32_t id, nIndexes = indexes ? (uint32_t)indexes[0] : 0;
+  int isNew, ok, attempt;
+  va_list argsCopy;
+
+  for (attempt = 0; attempt < 2 && log->chunk; attempt++) {
+    w.pos = log->chunk->data + log->chunk->used;
+    w.end = log->chunk->data + BINARY_LOG_CHUNK_SIZE;
+    w.ok = 1;
+
+    id = formatId(log, &w, format, &isNew);
+    putValue<uint8_t>(&w, RECORD_MESSAGE);
+    putValue<uint8_t>(&w, type);
+    putValue<uint16_t>(&w, stream);
+    putValue<uint8_t>(&w, indentNext ? 1 : 0);
+    putValue<uint32_t>(&w, id);
+    putValue<uint32_t>(&w, nIndexes);
+    if (nIndexes) {
+      put(&w, indexes + 1, nIndexes*sizeof(int));
+    }
+    va_copy(argsCopy, args);
+    ok = putArguments(&w, format, &argsCopy);
+    va_end(argsCopy);
+
+    if (!ok) {
+      return 0;
+    }
+    if (w.ok) {
+      if (isNew) {
+        log->formatIds[format] = id;
+        log->formats.push_back(format);
+      }
+      log->chunk->used = (uint32_t)(w.pos - log->chunk->data);
+      return 1;
+    }
+    /* the record did not fit, try again in an empty chunk */
+    queueChunk(log);
+  }
+  return 0;
+}
+
+static int recordFormatted(int type, int stream, int indentNext, const int *indexes, const char *format, ...)
+{
+  va_list args;
+  int ok;
+
+  va_start(args, format);
+  ok = recordMessage(type, stream, indentNext, indexes, format, args);
+  va_end(args);
+  return ok;
+}
+
+static void recordClose(uint8_t kind, int stream)
+{
+  thread_log *log = getThreadLog();
+  record_writer w;
+  int attempt;
+
+  for (attempt = 0; attempt < 2 && log->chunk; attempt++) {
+    w.pos = log->chunk->data + log->chunk->used;
+    w.end = log->chunk->data + BINARY_LOG_CHUNK_SIZE;
+    w.ok = 1;
+    putValue<uint8_t>(&w, kind);
+    putValue<uint16_t>(&w, stream);
+    if (w.ok) {
+      log->chunk->used = (uint32_t)(w.pos - log->chunk->data);
+      return;
+    }
+    queueChunk(log);
+  }
+}
+
+/* messageDeferred: record info messages of optional streams without formatting them */
+static int messageBinary(int type, int stream, int indentNext, const int *indexes, const char *format, va_list args)
+{
+  char logBuffer[BINARY_LOG_MAX_STRING];
+
+  if (isTextStream(stream)) {
+    return 0;
+  }
+  if (!recordMessage(type, stream, indentNext, indexes, format, args)) {
+    vsnprintf(logBuffer, sizeof(logBuffer), format, args);
+    recordFormatted(type, stream, indentNext, indexes, "%s", logBuffer);
+  }
+  return 1;
+}
+
+/* messageFunction: record formatted messages, warnings, errors and the text streams are printed as well */
+static void messageBinaryText(int type, int stream, FILE_INFO info, int indentNext, char *msg, int subline, const int *indexes)
+{
+  recordFormatted(type, stream, indentNext, indexes, "%s", msg);
+  if (type == LOG_TYPE_ERROR) {
+    queueChunk(getThreadLog());
+  }
+  if (isTextStream(stream) || type != LOG_TYPE_INFO) {
+    binaryLog->textFunction(type, stream, info, indentNext, msg, subline, indexes);
+  }
+}
+
+static void messageCloseBinary(int stream)
+{
+  if (ACTIVE_STREAM(stream)) {
+    recordClose(RECORD_CLOSE, stream);
+    if (isTextStream(stream)) {
+      binaryLog->textClose(stream);
+    }
+  }
+}
+
+static void messageCloseBinaryWarning(int stream)
+{
+  if (ACTIVE_WARNING_STREAM(stream)) {
+    recordClose(RECORD_CLOSE_WARNING, stream);
+    binaryLog->textCloseWarning(stream);
+  }
+}
+
+#endif /* OM_HAVE_PTHREADS */
+
+extern "C" {
+
+/**
+ * @brief Write all further messages to a binary log file.
+ *
+ * The log is written until closeBinaryLog, which is also called at exit.
+ *
+ * @param fileName    Name of the log file.
+ * @return int        0 on success.
+ */
+int openBinaryLog(const char *fileName)
+{
+#if defined(OM_HAVE_PTHREADS)
+  FILE *file;
+  uint32_t i, nStreams = SIM_LOG_MAX;
+  uint16_t length;
+  int failed;
+
+  if (binaryLog) {
+    return 0;
+  }
+
+  file = fopen(fileName, "wb");
+  if (!file) {
+    warningStreamPrint(LOG_STDOUT, 0, "Failed to open binary log file %s.", fileName);
+    return 1;
+  }
+
+  failed = 1 != fwrite(BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC), 1, file) ||
+           1 != fwrite(&BINARY_LOG_BYTE_ORDER, sizeof(uint32_t), 1, file) ||
+           1 != fwrite(&nStreams, sizeof(uint32_t), 1, file);
+  for (i = 0; i < nStreams && !failed; i++) {
+    length = (uint16_t) strlen(LOG_STREAM_NAME[i]);
+    failed = 1 != fwrite(&length, sizeof(uint16_t), 1, file) ||
+             length != fwrite(LOG_STREAM_NAME[i], 1, length, file);
+  }
+  if (failed) {
+    fclose(file);
+    warningStreamPrint(LOG_STDOUT, 0, "Failed to write the header of binary log file %s.", fileName);
+    return 1;
+  }
+
+  binaryLog = new binary_log;
+  binaryLog->file = file;
+  binaryLog->failed = 0;
+  binaryLog->stop = 0;
+  binaryLog->nThreads = 0;
+  binaryLog->textFunction = messageFunction;
+  binaryLog->textClose = messageClose;
+  binaryLog->textCloseWarning = messageCloseWarning;
+  pthread_key_create(&binaryLog->key, threadLogExit);
+  pthread_mutex_init(&binaryLog->mutex, NULL);
+  pthread_cond_init(&binaryLog->chunkQueued, NULL);
+  pthread_cond_init(&binaryLog->chunkWritten, NULL);
+  if (pthread_create(&binaryLog->writer, NULL, binaryLogWriterThread, binaryLog)) {
+    fclose(file);
+    delete binaryLog;
+    binaryLog = NULL;
+    warningStreamPrint(LOG_STDOUT, 0, "Failed to start the writer thread of the binary log.");
+    return 1;
+  }
+
+  messageDeferred = messageBinary;
+  messageFunction = messageBinaryText;
+  messageClose = messageCloseBinary;
+  messageCloseWarning = messageCloseBinaryWarning;
+  atexit(closeBinaryLog);
+  return 0;
+#else
+  warningStreamPrint(LOG_STDOUT, 0, "The binary log is not supported without pthreads.");
+  return 1;
+#endif
+}
+
+/**
+ * @brief Write the buffers of all threads and close the binary log.
+ *
+ * Has to be called when no other thread is logging anymore.
+ */
+void closeBinaryLog(void)
+{
+#if defined(OM_HAVE_PTHREADS)
+  binary_log *out = binaryLog;
+  size_t i;
+
+  if (!out) {
+    return;
+  }
+
+  messageDeferred = NULL;
+  messageFunction = out->textFunction;
+  messageClose = out->textClose;
+  messageCloseWarning = out->textCloseWarning;
+
+  for (i = 0; i < out->threads.size(); i++) {
+    queueChunk(out->threads[i]);
+  }
+
+  pthread_mutex_lock(&out->mutex);
+  out->stop = 1;
+  pthread_cond_signal(&out->chunkQueued);
+  pthread_cond_broadcast(&out->chunkWritten);
+  pthread_mutex_unlock(&out->mutex);
+  pthread_join(out->writer, NULL);
+
+  if (out->failed) {
+    warningStreamPrint(LOG_STDOUT, 0, "Failed to write the binary log.");
+  }
+  fclose(out->file);
+
+  /* thread logs of threads that are still alive are released here */
+  binaryLog = NULL;
+  for (i = 0; i < out->threads.size(); i++) {
+    free(out->threads[i]->chunk);
+    out->threads[i]->chunk = NULL;
+  }
+  for (i = 0; i < out->unused.size(); i++) {
+    free(out->unused[i]);
+  }
+  pthread_setspecific(out->key, NULL);
+  for (i = 0; i < out->threads.size(); i++) {
+    delete out->threads[i];
+  }
+  pthread_key_delete(out->key);
+  pthread_mutex_destroy(&out->mutex);
+  pthread_cond_destroy(&out->chunkQueued);
+  pthread_cond_destroy(&out->chunkWritten);
+  delete out;
+#endif
+}
+
+/**
+ * @brief Print a binary log as text.
+ *
+ * The messages are printed through the usual text backend, so the output
+ * looks like the one of a simulation with -logFormat=text. Messages of
+ * different threads are printed in blocks of one buffer.
+ *
+ * @param fileName    Name of the log file.
+ * @return int        0 on success.
+ */
+int decodeBinaryLog(const char *fileName)
+{
+  FILE *file = fopen(fileName, "rb");
+  char magic[sizeof(BINARY_LOG_MAGIC)];
+  uint32_t byteOrder, nStreams, i, thread, size, lastThread = UINT32_MAX;
+  uint16_t length;
+  std::vector<int> streams;
+  std::unordered_map<uint32_t, std::vector<std::string> > formats;
+  std::vector<char> chunk;
+  std::vector<int> indexes;
+  std::string msg;
+  char name[256];
+  int j, failed = 0;
+
+  if (!file) {
+    errorStreamPrint(LOG_STDOUT, 0, "Failed to open binary log file %s.", fileName);
+    return 1;
+  }
+
+  if (1 != fread(magic, sizeof(magic), 1, file) || memcmp(magic, BINARY_LOG_MAGIC, sizeof(magic)) ||
+      1 != fread(&byteOrder, sizeof(uint32_t), 1, file) || byteOrder != BINARY_LOG_BYTE_ORDER ||
+      1 != fread(&nStreams, sizeof(uint32_t), 1, file)) {
+    errorStreamPrint(LOG_STDOUT, 0, "%s is not a binary log of this platform.", fileName);
+    fclose(file);
+    return 1;
+  }
+
+  /* streams are matched by name, so logs of other versions can be decoded */
+  for (i = 0; i < nStreams && !failed; i++) {
+    if (1 != fread(&length, sizeof(uint16_t), 1, file) || length >= sizeof(name) ||
+        length != fread(name, 1, length, file)) {
+      failed = 1;
+      break;
+    }
+    name[length] = '\0';
+    streams.push_back(LOG_UNKNOWN);
+    for (j = 0; j < SIM_LOG_MAX; j++) {
+      if (!strcmp(name, LOG_STREAM_NAME[j])) {
+        streams.back() = j;
+        break;
+      }
+    }
+  }
+
+  for (j = 0; j < SIM_LOG_MAX; j++) {
+    useStream[j] = 1;
+  }
+
+  while (!failed && 1 == fread(&thread, sizeof(uint32_t), 1, file)) {
+    if (1 != fread(&size, sizeof(uint32_t), 1, file) || size > BINARY_LOG_CHUNK_SIZE) {
+      failed = 1;
+      break;
+    }
+    chunk.resize(size);
+    if (size != fread(chunk.data(), 1, size, file)) {
+      failed = 1;
+      break;
+    }
+    if (thread != lastThread) {
+      infoStreamPrint(LOG_STDOUT, 0, "messages of thread %u", thread);
+      lastThread = thread;
+    }
+
+    std::vector<std::string> &threadFormats = formats[thread];
+    record_reader r = {chunk.data(), chunk.data() + size, 1};
+    while (r.ok && r.pos < r.end) {
+      uint8_t kind = getValue<uint8_t>(&r);
+      if (kind == RECORD_FORMAT) {
+        uint32_t id = getValue<uint32_t>(&r);
+        uint32_t formatLength = getValue<uint32_t>(&r);
+        if (!r.ok || id != threadFormats.size() || (size_t)(r.end - r.pos) < formatLength) {
+          r.ok = 0;
+          break;
+        }
+        threadFormats.push_back(std::string(r.pos, formatLength));
+        r.pos += formatLength;
+      } else if (kind == RECORD_MESSAGE) {
+        int type = getValue<uint8_t>(&r);
+        uint16_t stream = getValue<uint16_t>(&r);
+        int indentNext = getValue<uint8_t>(&r);
+        uint32_t id = getValue<uint32_t>(&r);
+        uint32_t nIndexes = getValue<uint32_t>(&r);
+        if (!r.ok || id >= threadFormats.size() || stream >= streams.size() || type >= LOG_TYPE_MAX ||
+            (size_t)(r.end - r.pos) < nIndexes*sizeof(int)) {
+          r.ok = 0;
+          break;
+        }
+        indexes.resize(nIndexes + 1);
+        indexes[0] = nIndexes;
+        get(&r, indexes.data() + 1, nIndexes*sizeof(int));
+        msg = formatArguments(&r, threadFormats[id].c_str());
+        if (r.ok) {
+          messageFunction(type, streams[stream], omc_dummyFileInfo, indentNext, &msg[0], 0, nIndexes ? indexes.data() : NULL);
+        }
+      } else if (kind == RECORD_CLOSE || kind == RECORD_CLOSE_WARNING) {
+        uint16_t stream = getValue<uint16_t>(&r);
+        if (!r.ok || stream >= streams.size()) {
+          r.ok = 0;
+          break;
+        }
+        if (kind == RECORD_CLOSE) {
+          messageClose(streams[stream]);
+        } else {
+          messageCloseWarning(streams[stream]);
+        }
+      } else {
+        r.ok = 0;
+      }
+    }
+    failed = !r.ok;
+  }
+
+  fclose(file);
+  if (failed) {
+    errorStreamPrint(LOG_STDOUT, 0, "Binary log file %s is corrupted or incomplete.", fileName);
+    return 1;
+  }
+  return 0;
+}
+
+}
@@ -0,0 +1,56 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+/*
+ * Binary log (-logFormat=binary).
+ *
+ * Info messages of the streams activated with -lv are not formatted. Every
+ * thread appends the id of the format string and the raw arguments to its own
+ * buffer, full buffers are written to the log file by a background thread.
+ * Messages to stdout, warnings and errors are printed as text and recorded
+ * as well. The log is turned into text with -decodeLog.
+ */
+
+#ifndef _SIMULATION_LOG_BINARY_H
+#define _SIMULATION_LOG_BINARY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* cplusplus */
+
+int openBinaryLog(const char *fileName);
+void closeBinaryLog(void);
+int decodeBinaryLog(const char *fileName);
+
+#ifdef __cplusplus
+}
+#endif /* cplusplus */
+
+#endif
@@ -80,6 +80,9 @@
 #include "simulation/results/simulation_result_mat4.h"
 #include "simulation/results/simulation_result_wall.h"
 #include "simulation/results/simulation_result_ia.h"
+#include "simulation/results/simulation_result_async.h"
+#include "simulation/simulation_log_binary.h"
+#include "simulation/simulation_batch.h"
 #include "simulation/solver/solver_main.h"
 #include "simulation_info_json.h"
 #include "modelinfo.h"
@@ -735,6 +738,11 @@ int initializeResultData(DATA* simData, threadData_t *threadData, int cpuTime)
     cerr << "Unknown output format: " << simData->simulationInfo->outputFormat << endl;
     return 1;
   }
+#if !defined(OMC_MINIMAL_RUNTIME)
+  if (omc_flag[FLAG_ASYNC_OUTPUT] && !sim_noemit && 0 != strcmp("empty", simData->simulationInfo->outputFormat)) {
+    wrapAsyncResult(&sim_result);
+  }
+#endif
   initializeOutputFilter(simData->modelData, simData->simulationInfo->variableFilter, resultFormatHasCheapAliasesAndParameters);
   sim_result.init(&sim_result, simData, threadData);
   infoStreamPrint(LOG_SOLVER, 0, "Allocated simulation result data storage for method '%s' and file='%s'", (char*) simData->simulationInfo->outputFormat, sim_result.filename);
@@ -1054,6 +1062,16 @@ int initRuntimeAndSimulation(int argc, char**argv, DATA *data, threadData_t *thr
     EXIT(1);
   }
 
+  if(omc_flag[FLAG_DECODE_LOG]) {
+    EXIT(decodeBinaryLog(omc_flagValue[FLAG_DECODE_LOG]));
+  }
+
+  /* all batch runs would write the warm start values to the same file */
+  if(omc_flag[FLAG_BATCH] && omc_flag[FLAG_NLS_WARM_START]) {
+    errorStreamPrint(LOG_STDOUT, 0, "-nlsWarmStart can not be used together with -batch");
+    EXIT(1);
+  }
+
   setGlobalVerboseLevel(argc, argv);
   setGlobalLoggingTime(data->simulationInfo);
   if(omc_flag[FLAG_LV_MAX_WARN]) {
@@ -1311,7 +1329,11 @@ int _main_SimulationRuntime(int argc, char**argv, DATA *data, threadData_t *thre
   signal(SIGUSR1, SimulationRuntime_printStatus);
 #endif
 
-  retVal = startNonInteractiveSimulation(argc, argv, data, threadData);
+  if (omc_flag[FLAG_BATCH]) {
+    retVal = runBatchSimulation(argc, argv, data, threadData);
+  } else {
+    retVal = startNonInteractiveSimulation(argc, argv, data, threadData);
+  }
 
   freeMixedSystems(data, threadData);        /* free mixed system data */
   freeLinearSystems(data, threadData);       /* free linear system data */
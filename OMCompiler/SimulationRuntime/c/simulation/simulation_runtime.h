@@ -55,6 +55,7 @@ extern "C" {
 #endif /* cplusplus */
 
 extern int initializeResultData(DATA* simData, threadData_t *threadData, int cpuTime);
+extern int startNonInteractiveSimulation(int argc, char**argv, DATA* data, threadData_t *threadData);
 
 extern int modelTermination;     /* Becomes non-zero when simulation terminates. */
 extern int terminationTerminate; /* Becomes non-zero when user terminates simulation. */
@@ -49,7 +49,6 @@
 #include "dassl.h"
 #include "epsilon.h"
 #include "external_input.h"
-#include "jacobianSymbolical.h"
 #include "meta/meta_modelica.h"
 #include "model_help.h"
 #include "omc_math.h"
@@ -113,9 +112,6 @@ int jacA_symColored(double *t, double *y, double *yprime,
                    double *deltaD, double *pd, double *cj, double *h,
                    double *wt, double *rpar, int* ipar);
 
-void setJacElementDasslSparse(int l, int k, int nth, double val,
-                                     void* matrixA, int rows);
-
 void  DDASKR(
     int (*res) (double *t, double *y, double *yprime, double* cj, double *delta, int *ires, double *rpar, int* ipar),
     int *neq,
@@ -206,7 +202,7 @@ int dassl_initial(DATA* data, threadData_t *threadData,
   dasslData->newdelta = (double*) malloc(N*sizeof(double));
   dasslData->stateDer = (double*) calloc(N, sizeof(double));
   dasslData->states = (double*) malloc(N*sizeof(double));
-  dasslData->allocatedParMem = 0;   /* false */
+  dasslData->coloredJacobian = NULL;
 
   data->simulationInfo->currentContext = CONTEXT_ALGEBRAIC;
 
@@ -377,17 +373,13 @@ int dassl_initial(DATA* data, threadData_t *threadData,
     case COLOREDSYMJAC:
       data->simulationInfo->jacobianEvals = data->simulationInfo->analyticJacobians[data->callback->INDEX_JAC_A].sparsePattern->maxColors;
       dasslData->jacobianFunction = jacA_symColored;
-#ifdef USE_PARJAC
-      allocateThreadLocalJacobians(data, &(dasslData->jacColumns));
-      dasslData->allocatedParMem = 1;   /* true */
-#endif
+      dasslData->coloredJacobian = allocColoredJacobian(&(data->simulationInfo->analyticJacobians[data->callback->INDEX_JAC_A]),
+                                                        omc_get_max_threads(), TRUE);
       break;
     case SYMJAC:
       dasslData->jacobianFunction = jacA_sym;
-#ifdef USE_PARJAC
-      allocateThreadLocalJacobians(data, &(dasslData->jacColumns));
-      dasslData->allocatedParMem = 1;   /* true */
-#endif
+      dasslData->coloredJacobian = allocColoredJacobian(&(data->simulationInfo->analyticJacobians[data->callback->INDEX_JAC_A]),
+                                                        omc_get_max_threads(), FALSE);
       break;
     case NUMJAC:
       dasslData->jacobianFunction =  jacA_num;
@@ -462,16 +454,10 @@ int dassl_deinitial(DATA* data, DASSL_DATA *dasslData)
   free(dasslData->states);
 
   /* Free Jacobians */
+  freeColoredJacobian(dasslData->coloredJacobian);
   ANALYTIC_JACOBIAN* jacobian = &(data->simulationInfo->analyticJacobians[data->callback->INDEX_JAC_A]);
   freeAnalyticJacobian(jacobian);
 
-#ifdef USE_PARJAC
-  if (dasslData->allocatedParMem) {
-      freeAnalyticalJacobian(&(dasslData->jacColumns));
-      dasslData->allocatedParMem = 0;
-  }
-#endif
-
   free(dasslData);
 
   TRACE_POP
@@ -954,26 +940,6 @@ static int function_ZeroCrossingsDASSL(int *neqm, double *t, double *y, double *
   return 0;
 }
 
-/**
- * @brief Set element of dense Jacobian matrix.
- *
- * Jac(row, column) = val.
- *
- * @param row       Row of matrix element.
- * @param column    Column of matrix element.
- * @param nth       Sparsity pattern lead index, unused.
- * @param value     Value to set in position (i,j)
- * @param Jac       Pointer to double array storing matrix.
- * @param nRows     Number of rows of Jacobian matrix
- */
-void setJacElementDasslSparse(int row, int column, int nth, double value, void* Jac, int nRows)
-{
-  UNUSED(nth);  /* Disables compiler warning */
-
-  double* A = (double*) Jac;
-  A[column*nRows + row] = value;
-}
-
 /* \fn jacA_symColored(double *t, double *y, double *yprime, double *deltaD, double *pd, double *cj, double *h, double *wt,
    double *rpar, int* ipar)
  *
@@ -991,24 +957,13 @@ int jacA_symColored(double *t, double *y, double *yprime, double *delta,
   const int index = data->callback->INDEX_JAC_A;
   ANALYTIC_JACOBIAN* jac = &(data->simulationInfo->analyticJacobians[index]);
 
-#ifdef USE_PARJAC
-  ANALYTIC_JACOBIAN* t_jac = (dasslData->jacColumns);
-#else
-  ANALYTIC_JACOBIAN* t_jac = jac;
-#endif
-
-  unsigned int columns = jac->sizeCols;
-  unsigned int rows = jac->sizeRows;
-  unsigned int sizeTmpVars = jac->sizeTmpVars;
-  SPARSE_PATTERN* spp = jac->sparsePattern;
-
   /* Evaluate constant equations if available */
   if (jac->constantEqns != NULL) {
       jac->constantEqns(data, threadData, jac, NULL);
   }
 
-  genericColoredSymbolicJacobianEvaluation(rows, columns, spp, matrixA, t_jac,
-                                           data, threadData, &setJacElementDasslSparse);
+  evalColoredJacobian(data, threadData, dasslData->coloredJacobian, data->callback->functionJacA_column,
+                      matrixA, &setJacElementDense);
 
   TRACE_POP
   return 0;
@@ -1018,7 +973,7 @@ int jacA_symColored(double *t, double *y, double *yprime, double *delta,
    double *rpar, int* ipar)
  *
  *
- * This function calculates symbolically the jacobian matrix.
+ * This function calculates symbolically the jacobian matrix one column at a time.
  * Can calculate the jacobian in parallel.
  */
 int jacA_sym(double *t, double *y, double *yprime, double *delta,
@@ -1033,52 +988,14 @@ int jacA_sym(double *t, double *y, double *yprime, double *delta,
 
   const int index = data->callback->INDEX_JAC_A;
   ANALYTIC_JACOBIAN* jac = &(data->simulationInfo->analyticJacobians[index]);
-  unsigned int columns = jac->sizeCols;
-  unsigned int rows = jac->sizeRows;
-  unsigned int sizeTmpVars = jac->sizeTmpVars;
-  unsigned int i;
 
   /* Evaluate constant equations if available */
   if (jac->constantEqns != NULL) {
       jac->constantEqns(data, threadData, jac, NULL);
   }
 
-#ifdef USE_PARJAC
-  GC_allow_register_threads();
-#endif
-
-#pragma omp parallel default(none) firstprivate(columns, rows, sizeTmpVars) shared(i, matrixA, data, threadData, dasslData)
-{
-#ifdef USE_PARJAC
-  /* Register omp-thread in GC */
-  if(!GC_thread_is_registered()) {
-     struct GC_stack_base sb;
-     memset (&sb, 0, sizeof(sb));
-     GC_get_stack_base(&sb);
-     GC_register_my_thread (&sb);
-  }
-  // Use thread local analytic Jacobians
-  ANALYTIC_JACOBIAN* t_jac = &(dasslData->jacColumns[omc_get_thread_num()]);
-  //printf("index= %d, t_jac->sizeCols= %d, t_jac->sizeRows = %d, t_jac->sizeTmpVars = %d \n",index, t_jac->sizeCols , t_jac->sizeRows, t_jac->sizeTmpVars);
-#else
-  ANALYTIC_JACOBIAN* t_jac = jac;
-#endif
-  unsigned int j;
-
-#pragma omp for schedule(runtime)
-  for(i=0; i < columns; i++)
-  {
-    t_jac->seedVars[i] = 1.0;
-    data->callback->functionJacA_column(data, threadData, t_jac, NULL);
-
-    for(j = 0; j < rows; j++)
-    {
-      matrixA[i*columns+j] = t_jac->resultVars[j];
-    }
-
-    t_jac->seedVars[i] = 0.0;
-  } // for loop
-} // omp parallel
+  evalColoredJacobian(data, threadData, dasslData->coloredJacobian, data->callback->functionJacA_column,
+                      matrixA, &setJacElementDense);
 
   TRACE_POP
   return 0;
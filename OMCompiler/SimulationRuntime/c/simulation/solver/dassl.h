@@ -32,6 +32,7 @@
 #define DASSL_H
 
 #include "solver_main.h"
+#include "../jacobian_util.h"
 
 #define DDASKR _daskr_ddaskr_
 
@@ -80,10 +81,7 @@ typedef struct DASSL_DATA{
                           double *rpar, int* ipar);
   void* zeroCrossingFunction;
 
-#ifdef USE_PARJAC
-  ANALYTIC_JACOBIAN* jacColumns;    /* thread local analytic jacobians */
-#endif
-  int allocatedParMem; /* indicated if parallel memory was allocated, 0=false, 1=true*/
+  COLORED_JACOBIAN* coloredJacobian;  /* colored, thread parallel evaluation of symbolic jacobian, NULL if not used */
 } DASSL_DATA;
 
 /* main dassl function to make a step */
@@ -46,90 +46,169 @@
 void printDelayBuffer(void* data, int stream, void* elemPointer);
 
 
+/* Number of rows findTime steps forward from the last position before it bisects */
+#define DELAY_CURSOR_MAX_STEPS 4
+
+/* Two consecutive rows with the same time mark an event */
+#define DELAY_EVENT_EPS 1e-12
+
+static int compareTime(const void *key, const void *elem)
+{
+  double time = *(const double*)key;
+  double t = ((const TIME_AND_VALUE*)elem)->t;
+  return time < t ? -1 : (time > t ? 1 : 0);
+}
+
+
 /**
  * @brief Find row with greatest time that is smaller than or equal to 'time'.
  *
+ * Starts at the row found by the previous call, so that monotone increasing
+ * times only need a few steps. Otherwise, e.g. after a rejected solver step,
+ * the ring buffer is bisected.
+ *
  * @param[in] time          Time value to search for.
  * @param[in] delayStruct   Ringbuffer with stored delay values.
  *                          Looks like a matrix with columns of type TIME_AND_VALUE.
+ * @param[in,out] cursor    Search state of delayStruct.
  * @return int              Row with maximum time value smaller equal to time.
  */
-static int findTime(double time, RINGBUFFER *delayStruct)
+static int findTime(double time, RINGBUFFER *delayStruct, DELAY_CURSOR *cursor)
 {
   int end = ringBufferLength(delayStruct);
-  int pos = 0;
-  double curTime, prevTime;
-  TIME_AND_VALUE* bufferElem;
+  int pos = cursor->lastPosition;
+  int lo = 0;
+  int i;
 
   /* Check if ring buffer is valid */
   assertStreamPrint(NULL, ringBufferLength(delayStruct) > 0, "delay: In function findTime\nEmpty ring buffer.");
-  bufferElem = getRingData(delayStruct, pos);
-  curTime = bufferElem->t;
 
   /* If searched time is smaller then first element return first position */
-  if (time < curTime) {
-    return pos;
+  if (time < ((TIME_AND_VALUE*)getRingData(delayStruct, 0))->t) {
+    cursor->lastPosition = 0;
+    return 0;
   }
 
-  /* Search for time starting at begin of ring buffer */
-  while (pos < end-1) {
-    pos++;
-    bufferElem = getRingData(delayStruct, pos);
-    prevTime = curTime;
-    curTime = bufferElem->t;
-
-    if (curTime > time) {
-      pos--;
-      // Found time in previous step
-      break;
+  /* Walk forward from the last position */
+  if (pos >= 0 && pos < end && ((TIME_AND_VALUE*)getRingData(delayStruct, pos))->t <= time) {
+    for (i = 0; i < DELAY_CURSOR_MAX_STEPS; i++) {
+      if (pos == end-1 || ((TIME_AND_VALUE*)getRingData(delayStruct, pos+1))->t > time) {
+        cursor->lastPosition = pos;
+        return pos;
+      }
+      pos++;
     }
+    lo = pos;
   }
-  assertStreamPrint(NULL, pos < end, "delay: In function findTime\nCould not find time");
+
+  pos = bisectRingBuffer(delayStruct, lo, end, &time, compareTime);
+  assertStreamPrint(NULL, 0 <= pos && pos < end, "delay: In function findTime\nCould not find time");
+  cursor->lastPosition = pos;
 
   return pos;
 }
 
 
+/**
+ * @brief Find first row at or after 'start' with the same time as its predecessor.
+ *
+ * @param delayStruct   Ringbuffer with stored delay values.
+ * @param start         First row to check, at least 1.
+ * @return int          Row of first event, -1 if there is none.
+ */
+static int findNextEvent(RINGBUFFER *delayStruct, int start)
+{
+  int end = ringBufferLength(delayStruct);
+  int pos;
+
+  for (pos = start; pos < end; pos++) {
+    if (fabs(((TIME_AND_VALUE*)getRingData(delayStruct, pos-1))->t - ((TIME_AND_VALUE*)getRingData(delayStruct, pos))->t) < DELAY_EVENT_EPS) {
+      return pos;
+    }
+  }
+  return -1;
+}
+
+
+/**
+ * @brief Append row to delay buffer and remember it if it is an event.
+ */
+static void appendDelayRow(RINGBUFFER *delayStruct, DELAY_CURSOR *cursor, TIME_AND_VALUE *tpl)
+{
+  int length = ringBufferLength(delayStruct);
+
+  if (cursor->firstEvent < 0 && length > 0 && fabs(((TIME_AND_VALUE*)getRingData(delayStruct, length-1))->t - tpl->t) < DELAY_EVENT_EPS) {
+    cursor->firstEvent = length;
+  }
+  appendRingData(delayStruct, tpl);
+}
+
+
+/**
+ * @brief Dequeue first n rows of delay buffer and shift cursor accordingly.
+ */
+static void dequeueDelayRows(RINGBUFFER *delayStruct, DELAY_CURSOR *cursor, int n)
+{
+  dequeueNFirstRingDatas(delayStruct, n);
+
+  cursor->lastPosition = cursor->lastPosition > n ? cursor->lastPosition - n : 0;
+  if (cursor->firstEvent >= 0) {
+    cursor->firstEvent -= n;
+    if (cursor->firstEvent < 1) {
+      cursor->firstEvent = findNextEvent(delayStruct, 1);
+    }
+  }
+}
+
+
+/**
+ * @brief Remove last n rows of delay buffer and invalidate cursor positions behind the end.
+ */
+static void removeDelayRows(RINGBUFFER *delayStruct, DELAY_CURSOR *cursor, int n)
+{
+  int length;
+
+  removeLastRingData(delayStruct, n);
+  length = ringBufferLength(delayStruct);
+
+  if (cursor->lastPosition >= length) {
+    cursor->lastPosition = length > 0 ? length-1 : 0;
+  }
+  if (cursor->firstEvent >= length) {
+    cursor->firstEvent = -1;
+  }
+}
+
+
 /**
  * @brief Look for events between `oldTime` and `newTime`
  *
+ * An event is a row with the same time as its predecessor. Checks rows up to
+ * the first one with a time greater than 'time'.
+ *
  * @param[in] time          Time value to search for.
  * @param[in] delayStruct   Ringbuffer with stored delay values.
  *                          Looks like a matrix with columns of type TIME_AND_VALUE.
+ * @param[in,out] cursor    Search state of delayStruct.
  * @return modelica_boolean Boolean indicating if an event was found.
  */
-static modelica_boolean searchEvent(double time, RINGBUFFER *delayStruct)
+static modelica_boolean searchEvent(double time, RINGBUFFER *delayStruct, DELAY_CURSOR *cursor)
 {
   int end = ringBufferLength(delayStruct);
-  int pos = 0;
-  double curTime, prevTime;
-  TIME_AND_VALUE* bufferElem;
-  modelica_boolean foundEvent = FALSE;
-
-  bufferElem = getRingData(delayStruct, pos);
-  curTime = bufferElem->t;
+  int pos;
+  modelica_boolean foundEvent;
 
   /* If searched time is smaller then first element we have no event */
-  if (time < curTime) {
+  if (cursor->firstEvent < 0 || time < ((TIME_AND_VALUE*)getRingData(delayStruct, 0))->t) {
     return FALSE;
   }
 
-  /* Search for time starting at begin of ring buffer */
-  while (pos < end-1) {
-    pos++;
-    bufferElem = getRingData(delayStruct, pos);
-    prevTime = curTime;
-    curTime = bufferElem->t;
-
-    /* Check for an event */
-    if (fabs(prevTime-curTime) < 1e-12) {
-      foundEvent = TRUE;
-      break;
-    }
-    if (curTime > time) {
-      break;
-    }
+  /* Last row to check */
+  pos = findTime(time, delayStruct, cursor) + 1;
+  if (pos > end-1) {
+    pos = end-1;
   }
+  foundEvent = cursor->firstEvent <= pos;
 
   if (foundEvent) {
     printRingBuffer(delayStruct, LOG_DEBUG, printDelayBuffer);
@@ -152,6 +231,7 @@ static modelica_boolean searchEvent(double time, RINGBUFFER *delayStruct)
 void storeDelayedExpression(DATA* data, threadData_t *threadData, int exprNumber, double exprValue, double delayTime, double delayMax)
 {
   RINGBUFFER* delayStruct = data->simulationInfo->delayStructure[exprNumber];
+  DELAY_CURSOR* cursor = &data->simulationInfo->delayCursor[exprNumber];
   int row;
   int length = ringBufferLength(delayStruct);
   double time = data->localData[0]->timeValue;
@@ -165,8 +245,9 @@ void storeDelayedExpression(DATA* data, threadData_t *threadData, int exprNumber
   /* ph: Is this needed because of event search? */
   if (length > 0) {
     lastElem = getRingData(delayStruct, length-1);
-    while (time < lastElem->t && length > 0) {
-      removeLastRingData(delayStruct,1);
+    if (time < lastElem->t) {
+      row = bisectRingBuffer(delayStruct, 0, length, &time, compareTime);
+      removeDelayRows(delayStruct, cursor, length-row-1);
       length = ringBufferLength(delayStruct);
       if (length > 0) {
         lastElem = getRingData(delayStruct, length-1);
@@ -179,9 +260,9 @@ void storeDelayedExpression(DATA* data, threadData_t *threadData, int exprNumber
   if (length > 0) {
     if (fabs(lastElem->t-time) < 1e-10 && fabs(lastElem->value-exprValue) < 1e-10) {
       /* Dequeue no longer needed values from ring buffer */
-      row = findTime(time-delayTime+1e-10, delayStruct);
+      row = findTime(time-delayTime+1e-10, delayStruct, cursor);
       if (row > 0) {
-        dequeueNFirstRingDatas(delayStruct, row);
+        dequeueDelayRows(delayStruct, cursor, row);
       }
       return;
     }
@@ -190,12 +271,12 @@ void storeDelayedExpression(DATA* data, threadData_t *threadData, int exprNumber
   /* Append expression value to delay ring buffer */
   tpl.t = time;
   tpl.value = exprValue;
-  appendRingData(delayStruct, &tpl);
+  appendDelayRow(delayStruct, cursor, &tpl);
 
   /* Dequeue no longer needed values from ring buffer */
-  row = findTime(time-delayTime+DBL_EPSILON, delayStruct);
-  if (row > 0 && !searchEvent(time-delayTime+DBL_EPSILON, delayStruct)) {
-    dequeueNFirstRingDatas(delayStruct, row);
+  row = findTime(time-delayTime+DBL_EPSILON, delayStruct, cursor);
+  if (row > 0 && !searchEvent(time-delayTime+DBL_EPSILON, delayStruct, cursor)) {
+    dequeueDelayRows(delayStruct, cursor, row);
   }
 
   /* Debug print */
@@ -265,7 +346,7 @@ double delayImpl(DATA* data, threadData_t *threadData, int exprNumber, double ex
       time1 = time;
       value1 = exprValue;
     } else {
-      i = findTime(timeStamp, delayStruct);
+      i = findTime(timeStamp, delayStruct, &data->simulationInfo->delayCursor[exprNumber]);
       assertStreamPrint(threadData, i < length, "%d = i < length = %d", i, length);
       time0 = ((TIME_AND_VALUE*)getRingData(delayStruct, i))->t;
       value0 = ((TIME_AND_VALUE*)getRingData(delayStruct, i))->value;
@@ -319,7 +400,7 @@ double delayZeroCrossing(DATA* data, threadData_t *threadData, unsigned int expr
   }
 
   /* Flip sign of ZC if an event was found */
-  if (searchEvent(time - delayTime, delayStruct)) {
+  if (searchEvent(time - delayTime, delayStruct, &data->simulationInfo->delayCursor[exprNumber])) {
     return -zeroCrossingValue;
   } else {
     return zeroCrossingValue;
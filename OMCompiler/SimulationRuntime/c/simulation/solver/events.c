@@ -51,7 +51,20 @@ extern "C" {
 #endif
 
 int maxBisectionIterations = 0;
-void bisection(DATA* data, threadData_t *threadData, double*, double*, double*, double*, LIST*, LIST*);
+
+/* Dense output of the last integrator step [t0, t1]: cubic Hermite
+ * interpolation of the states using the states and state derivatives at both
+ * ends of the step, or linear interpolation if no derivatives are available. */
+typedef struct STEP_INTERPOLANT
+{
+  double t0, t1;
+  const double *y0, *y1;
+  const double *yp0, *yp1;
+  long nStates;
+} STEP_INTERPOLANT;
+
+static void bisection(DATA* data, threadData_t *threadData, const STEP_INTERPOLANT*, double*, double*, LIST*, LIST*);
+static void interpolateStates(const STEP_INTERPOLANT *step, double t, double *states);
 void saveZeroCrossingsAfterEvent(DATA *data, threadData_t *threadData);
 
 /*! \fn checkForSampleEvent
@@ -297,17 +310,26 @@ double findRoot(DATA* data, threadData_t* threadData, LIST* eventList, double ti
   TRACE_PUSH
 
   LIST_NODE* it;
-  fortran_integer i=0;
+  long nStates = data->modelData->nStates;
   LIST *tmpEventList = allocList(eventListAlloc, eventListFree, eventListCopy);
+  STEP_INTERPOLANT step;
 
-  /* static work arrays */
+  /* static work arrays, holding the states followed by the state derivatives */
   double *states_left = data->simulationInfo->states_left;
   double *states_right = data->simulationInfo->states_right;
 
+  /* write states and derivatives to work arrays, the search overwrites realVars */
+  memcpy(states_left,  values_left,  2 * nStates * sizeof(double));
+  memcpy(states_right, values_right, 2 * nStates * sizeof(double));
 
-  /* write states to work arrays */
-  memcpy(states_left,  values_left,  data->modelData->nStates * sizeof(double));
-  memcpy(states_right, values_right, data->modelData->nStates * sizeof(double));
+  step.t0 = time_left;
+  step.t1 = time_right;
+  step.y0 = states_left;
+  step.y1 = states_right;
+  /* in DAE mode the derivatives are not updated for every step */
+  step.yp0 = compiledInDAEMode ? NULL : states_left + nStates;
+  step.yp1 = compiledInDAEMode ? NULL : states_right + nStates;
+  step.nStates = nStates;
 
   for(it=listFirstNode(eventList); it; it=listNextNode(it))
   {
@@ -315,7 +337,7 @@ double findRoot(DATA* data, threadData_t* threadData, LIST* eventList, double ti
   }
 
   /* Search for event time and event_id with bisection method */
-  bisection(data, threadData, &time_left, &time_right, states_left, states_right, tmpEventList, eventList);
+  bisection(data, threadData, &step, &time_left, &time_right, tmpEventList, eventList);
 
   /* what happens here? */
   if(listLen(tmpEventList) == 0)
@@ -353,7 +375,7 @@ double findRoot(DATA* data, threadData_t* threadData, LIST* eventList, double ti
   debugStreamPrint(LOG_EVENTS, 0, "time: %.10e", time_right);
 
   data->localData[0]->timeValue = time_left;
-  memcpy(data->localData[0]->realVars, states_left, data->modelData->nStates * sizeof(double));
+  interpolateStates(&step, time_left, data->localData[0]->realVars);
 
   /* determined continuous system */
   data->callback->updateContinuousSystem(data, threadData);
@@ -361,7 +383,7 @@ double findRoot(DATA* data, threadData_t* threadData, LIST* eventList, double ti
   /*sim_result_emit(data);*/
 
   data->localData[0]->timeValue = time_right;
-  memcpy(data->localData[0]->realVars, states_right, data->modelData->nStates * sizeof(double));
+  interpolateStates(&step, time_right, data->localData[0]->realVars);
 
   freeList(tmpEventList);
 
@@ -369,30 +391,66 @@ double findRoot(DATA* data, threadData_t* threadData, LIST* eventList, double ti
   return time_right;
 }
 
+/*! \fn interpolateStates
+ *
+ *  Evaluates the dense output of the last step at time t.
+ *  The end points of the step are reproduced exactly.
+ *
+ *  \param [in]  [step]
+ *  \param [in]  [t]
+ *  \param [out] [states]
+ */
+static void interpolateStates(const STEP_INTERPOLANT *step, double t, double *states)
+{
+  double h = step->t1 - step->t0;
+  double s = h != 0.0 ? (t - step->t0) / h : 1.0;
+  long i;
+
+  if (step->yp0 == NULL)
+  {
+    for(i=0; i < step->nStates; i++)
+      states[i] = (1.0 - s) * step->y0[i] + s * step->y1[i];
+  }
+  else
+  {
+    double h00 = (1.0 + 2.0*s) * (1.0 - s) * (1.0 - s);
+    double h10 = s * (1.0 - s) * (1.0 - s) * h;
+    double h01 = s * s * (3.0 - 2.0*s);
+    double h11 = s * s * (s - 1.0) * h;
+    for(i=0; i < step->nStates; i++)
+      states[i] = h00 * step->y0[i] + h10 * step->yp0[i] + h01 * step->y1[i] + h11 * step->yp1[i];
+  }
+}
+
 /*! \fn bisection
  *
  *  \param [ref] [data]
+ *  \param [in]  [step]
  *  \param [ref] [a]
  *  \param [ref] [b]
- *  \param [ref] [states_a]
- *  \param [ref] [states_b]
  *  \param [ref] [eventListTmp]
  *  \param [in]  [eventList]
  *
  *  Method to find root in interval [oldTime, timeValue]
+ *
+ *  The zero crossings only provide their sign, so the interval is bisected.
+ *  The states at the midpoint are taken from the dense output of the step.
+ *  All zero crossings are evaluated into zeroCrossingsBackup, but only the
+ *  ones in eventList (the ones that changed their sign over the step) are
+ *  compared and copied to zeroCrossings / zeroCrossingsPre.
  */
-void bisection(DATA* data, threadData_t *threadData, double* a, double* b, double* states_a, double* states_b, LIST *tmpEventList, LIST *eventList)
+static void bisection(DATA* data, threadData_t *threadData, const STEP_INTERPOLANT *step, double* a, double* b, LIST *tmpEventList, LIST *eventList)
 {
   TRACE_PUSH
 
   double TTOL = MINIMAL_STEP_SIZE + MINIMAL_STEP_SIZE*fabs(*b-*a); /* absTol + relTol*abs(b-a) */
   double c;
-  long i=0;
+  long nCandidates;
+  long *candidates = eventListIndices(eventList, &nCandidates);
+  unsigned long iterations = 0;
   /* n >= log(2)/log(2) + log(|b-a|/TOL)/log(2)*/
   unsigned int n = maxBisectionIterations > 0 ? maxBisectionIterations : 1 + ceil(log(fabs(*b - *a)/TTOL)/log(2));
 
-  memcpy(data->simulationInfo->zeroCrossingsBackup, data->simulationInfo->zeroCrossings, data->modelData->nZeroCrossings * sizeof(modelica_real));
-
   infoStreamPrint(LOG_ZEROCROSSINGS, 0, "bisection method starts in interval [%e, %e]", *a, *b);
   infoStreamPrint(LOG_ZEROCROSSINGS, 0, "TTOL is set to %e and maximum number of intersections %d.", TTOL, n);
 
@@ -400,12 +458,10 @@ void bisection(DATA* data, threadData_t *threadData, double* a, double* b, doubl
   {
     c = 0.5 * (*a + *b);
     data->localData[0]->timeValue = c;
+    iterations++;
 
     /*calculates states at time c */
-    for(i=0; i < data->modelData->nStates; i++)
-    {
-      data->localData[0]->realVars[i] = 0.5*(states_a[i] + states_b[i]);
-    }
+    interpolateStates(step, c, data->localData[0]->realVars);
 
     /*calculates Values dependents on new states*/
     /* read input vars */
@@ -414,26 +470,83 @@ void bisection(DATA* data, threadData_t *threadData, double* a, double* b, doubl
     /* eval needed equations*/
     data->callback->function_ZeroCrossingsEquations(data, threadData);
 
-    data->callback->function_ZeroCrossings(data, threadData, data->simulationInfo->zeroCrossings);
+    data->callback->function_ZeroCrossings(data, threadData, data->simulationInfo->zeroCrossingsBackup);
 
-    if(checkZeroCrossings(data, tmpEventList, eventList))  /* If Zerocrossing in left Section */
-    {
-      memcpy(states_b, data->localData[0]->realVars, data->modelData->nStates * sizeof(modelica_real));
+    if(bisectionCheckZeroCrossings(data, candidates, nCandidates, tmpEventList))  /* If Zerocrossing in left Section */
       *b = c;
-      memcpy(data->simulationInfo->zeroCrossingsBackup, data->simulationInfo->zeroCrossings, data->modelData->nZeroCrossings * sizeof(modelica_real));
-    }
     else  /*else Zerocrossing in right Section */
-    {
-      memcpy(states_a, data->localData[0]->realVars, data->modelData->nStates * sizeof(modelica_real));
       *a = c;
-      memcpy(data->simulationInfo->zeroCrossingsPre, data->simulationInfo->zeroCrossings, data->modelData->nZeroCrossings * sizeof(modelica_real));
-      memcpy(data->simulationInfo->zeroCrossings, data->simulationInfo->zeroCrossingsBackup, data->modelData->nZeroCrossings * sizeof(modelica_real));
-    }
   }
 
+  data->simulationInfo->callStatistics.rootFindingEvents++;
+  data->simulationInfo->callStatistics.rootFindingIterations += iterations;
+  infoStreamPrint(LOG_ZEROCROSSINGS, 0, "bisection method finished after %lu iterations in interval [%e, %e]", iterations, *a, *b);
+
+  free(candidates);
   TRACE_POP
 }
 
+/*! \fn eventListIndices
+ *
+ *  \param [in]  [eventList]
+ *  \param [out] [n]
+ *  \return newly allocated array with the zero-crossing indices of eventList
+ */
+long* eventListIndices(LIST *eventList, long *n)
+{
+  LIST_NODE *it;
+  long *indices = (long*) malloc((listLen(eventList) + 1) * sizeof(long));
+  assertStreamPrint(NULL, indices != NULL, "eventListIndices: Out of memory");
+  *n = 0;
+  for(it=listFirstNode(eventList); it; it=listNextNode(it))
+    indices[(*n)++] = *((long*) listNodeData(it));
+  return indices;
+}
+
+/*! \fn bisectionCheckZeroCrossings
+ *
+ *  Compares the zero crossings evaluated at the midpoint of a bisection
+ *  step (stored in zeroCrossingsBackup) with zeroCrossingsPre. Only the
+ *  candidates, i.e. the zero crossings that changed their sign over the
+ *  whole interval, are looked at. If one of them changed its sign in the
+ *  left section, the midpoint values become the right end (zeroCrossings),
+ *  else the left end (zeroCrossingsPre) of the interval.
+ *
+ *  \param [ref] [data]
+ *  \param [in]  [candidates]
+ *  \param [in]  [nCandidates]
+ *  \param [ref] [tmpEventList]  zero crossings that changed in the left section
+ *  \return 1 if there is an event in the left section
+ */
+int bisectionCheckZeroCrossings(DATA *data, const long *candidates, long nCandidates, LIST *tmpEventList)
+{
+  double *zeroCrossingsMid = data->simulationInfo->zeroCrossingsBackup;
+  double *zeroCrossingsEnd;
+  long i;
+
+  listClear(tmpEventList);
+  infoStreamPrint(LOG_ZEROCROSSINGS, 0, "bisection checks for condition changes");
+
+  for(i=0; i<nCandidates; i++)
+  {
+    long ix = candidates[i];
+    double pre = data->simulationInfo->zeroCrossingsPre[ix];
+    /* found event in left section */
+    if((zeroCrossingsMid[ix] == -1 && pre == 1) || (zeroCrossingsMid[ix] == 1 && pre == -1))
+    {
+      infoStreamPrint(LOG_ZEROCROSSINGS, 0, "%ld changed from %s to current %s", ix,
+                      (pre > 0) ? "TRUE" : "FALSE", (zeroCrossingsMid[ix] > 0) ? "TRUE" : "FALSE");
+      listPushFront(tmpEventList, &ix);
+    }
+  }
+
+  zeroCrossingsEnd = listLen(tmpEventList) > 0 ? data->simulationInfo->zeroCrossings : data->simulationInfo->zeroCrossingsPre;
+  for(i=0; i<nCandidates; i++)
+    zeroCrossingsEnd[candidates[i]] = zeroCrossingsMid[candidates[i]];
+
+  return listLen(tmpEventList) > 0;
+}
+
 /*! \fn checkZeroCrossings
  *
  *  Function checks for an event list on events
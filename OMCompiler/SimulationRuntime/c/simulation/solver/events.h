@@ -52,6 +52,8 @@ void handleEvents(DATA* data, threadData_t *threadData, LIST* eventLst, double *
 
 double findRoot(DATA* data, threadData_t* threadData, LIST* eventList, double time_left, double* states_left, double time_right, double* states_right);
 int checkZeroCrossings(DATA *data, LIST *tmpEventList, LIST *eventList);
+long* eventListIndices(LIST *eventList, long *n);
+int bisectionCheckZeroCrossings(DATA *data, const long *candidates, long nCandidates, LIST *tmpEventList);
 
 void* eventListAlloc(const void* data);
 void eventListFree(void* data);
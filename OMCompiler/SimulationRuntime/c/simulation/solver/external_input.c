@@ -121,13 +121,7 @@ void externalInputallocate2(DATA* data, const char *filename){
 
   indx = (int*)malloc(nu*sizeof(int));
   for(i = 0; i < nu; ++i){
-    indx[i] = -1;
-    for(j = 0; j < res->numvars; ++j){
-      if(strcmp(names[i], res->variables[j]) == 0){
-        indx[i] = j;
-        break;
-      }
-    }
+    indx[i] = read_csv_dataset_index(res, names[i]);
   }
 
   for(i = 0, k= 0; i < data->simulationInfo->external_input.n; ++i)
@@ -67,7 +67,9 @@ void bisection_gb(DATA* data, threadData_t *threadData, SOLVER_INFO* solverInfo,
   /* n >= log(2)/log(2) + log(|b-a|/TOL)/log(2)*/
   unsigned int n = maxBisectionIterations > 0 ? maxBisectionIterations : 1 + ceil(log(fabs(*b - *a)/TTOL)/log(2));
 
-  memcpy(data->simulationInfo->zeroCrossingsBackup, data->simulationInfo->zeroCrossings, data->modelData->nZeroCrossings * sizeof(modelica_real));
+  long nCandidates;
+  long *candidates = eventListIndices(eventList, &nCandidates);
+  unsigned long iterations = 0;
 
   infoStreamPrint(LOG_ZEROCROSSINGS, 0, "bisection method starts in interval [%e, %e]", *a, *b);
   infoStreamPrint(LOG_ZEROCROSSINGS, 0, "TTOL is set to %e and maximum number of intersections %d.", TTOL, n);
@@ -76,6 +78,7 @@ void bisection_gb(DATA* data, threadData_t *threadData, SOLVER_INFO* solverInfo,
   {
     c = 0.5 * (*a + *b);
     data->localData[0]->timeValue = c;
+    iterations++;
 
     /*calculates states at time c using interpolation */
     if (isInnerIntegration) {
@@ -100,23 +103,24 @@ void bisection_gb(DATA* data, threadData_t *threadData, SOLVER_INFO* solverInfo,
     /* eval needed equations*/
     data->callback->function_ZeroCrossingsEquations(data, threadData);
 
-    data->callback->function_ZeroCrossings(data, threadData, data->simulationInfo->zeroCrossings);
+    data->callback->function_ZeroCrossings(data, threadData, data->simulationInfo->zeroCrossingsBackup);
 
-    if(checkZeroCrossings(data, tmpEventList, eventList))  /* If Zerocrossing in left Section */
+    if(bisectionCheckZeroCrossings(data, candidates, nCandidates, tmpEventList))  /* If Zerocrossing in left Section */
     {
       memcpy(states_b, data->localData[0]->realVars, data->modelData->nStates * sizeof(modelica_real));
       *b = c;
-      memcpy(data->simulationInfo->zeroCrossingsBackup, data->simulationInfo->zeroCrossings, data->modelData->nZeroCrossings * sizeof(modelica_real));
     }
     else  /*else Zerocrossing in right Section */
     {
       memcpy(states_a, data->localData[0]->realVars, data->modelData->nStates * sizeof(modelica_real));
       *a = c;
-      memcpy(data->simulationInfo->zeroCrossingsPre, data->simulationInfo->zeroCrossings, data->modelData->nZeroCrossings * sizeof(modelica_real));
-      memcpy(data->simulationInfo->zeroCrossings, data->simulationInfo->zeroCrossingsBackup, data->modelData->nZeroCrossings * sizeof(modelica_real));
     }
   }
 
+  data->simulationInfo->callStatistics.rootFindingEvents++;
+  data->simulationInfo->callStatistics.rootFindingIterations += iterations;
+
+  free(candidates);
   TRACE_POP
 }
 
@@ -54,7 +54,6 @@
 #include <string.h>
 
 #include "external_input.h"
-#include "jacobianSymbolical.h"
 #include "kinsolSolver.h"
 #include "model_help.h"
 #include "newtonIteration.h"
@@ -812,6 +811,9 @@ int gbodef_main(DATA *data, threadData_t *threadData, SOLVER_INFO *solverInfo, d
       {
       case GB_NLS_NEWTON:
         ((DATA_NEWTON *)solverData->ordinaryData)->n = gbData->nFastStates;
+        /* Coloring changed with the fast states */
+        freeColoredJacobian(((DATA_NEWTON *)solverData->ordinaryData)->coloredJacobian);
+        ((DATA_NEWTON *)solverData->ordinaryData)->coloredJacobian = NULL;
         break;
       case GB_NLS_KINSOL:
         nlsKinsolFree(solverData->ordinaryData);
@@ -49,7 +49,6 @@
 #include "../../util/varinfo.h"
 #include "../results/simulation_result.h"
 #include "epsilon.h"
-#include "jacobianSymbolical.h"
 #include "kinsolSolver.h"
 #include "model_help.h"
 #include "newtonIteration.h"
@@ -39,7 +39,6 @@
 #include "../../simulation_data.h"
 
 #include "solver_main.h"
-#include "jacobianSymbolical.h"
 #include "kinsolSolver.h"
 #include "model_help.h"
 #include "newtonIteration.h"
@@ -59,7 +59,6 @@
 #include "dassl.h"
 #include "epsilon.h"
 #include "external_input.h"
-#include "jacobianSymbolical.h"
 #include "simulation/jacobian_util.h"
 #include "model_help.h"
 #include "omc_math.h"
@@ -381,6 +380,9 @@ int ida_solver_initial(DATA* data, threadData_t *threadData,
     idaData->jacobianMethod = COLOREDNUMJAC;
   }
 
+  /* Iterative linear solvers use the internal Jacobian, the selected one is still used for the scaling factors */
+  const int selectedJacobianMethod = idaData->jacobianMethod;
+
   /* Set NNZ */
   if (idaData->daeMode) {
     idaData->NNZ = data->simulationInfo->daeModeData->sparsePattern->numberOfNonZeros;
@@ -440,10 +442,16 @@ int ida_solver_initial(DATA* data, threadData_t *threadData,
   checkReturnFlag_SUNDIALS(flag, SUNDIALS_IDALS_FLAG, "IDASetLinearSolver");
   infoStreamPrint(LOG_SOLVER, 0, "IDA linear solver method selected %s", IDA_LS_METHOD_DESC[idaData->linearSolverMethod]);
 
+  /* Colored symbolic Jacobian is evaluated in parallel for dense and sparse matrices */
+  idaData->coloredJacobian = NULL;
+  if (selectedJacobianMethod == COLOREDSYMJAC) {
+    idaData->coloredJacobian = allocColoredJacobian(&(data->simulationInfo->analyticJacobians[data->callback->INDEX_JAC_A]),
+                                                    omc_get_max_threads(), TRUE);
+  }
+
   /* Set Jacobian function */
   /* Use sparse jacobian evaluation */
   if (idaData->linearSolverMethod == IDA_LS_KLU) {
-    idaData->allocatedParMem = 0;   /* FALSE */
 
     /* Set Jacobian function for matrix based linear solvers */
     switch (idaData->jacobianMethod){
@@ -455,8 +463,6 @@ int ida_solver_initial(DATA* data, threadData_t *threadData,
 
       checkReturnFlag_SUNDIALS(flag, SUNDIALS_IDALS_FLAG, "IDASetJacFn");
 #ifdef USE_PARJAC
-      allocateThreadLocalJacobians(data, &(idaData->jacColumns));
-      idaData->allocatedParMem = 1;   /* TRUE */
       if (omc_flag[FLAG_IDA_SCALING]) {
         idaData->scaleMatrix = SUNSparseMatrix(idaData->N, idaData->N, idaData->NNZ + idaData->N, CSC_MAT);
       } else {
@@ -477,10 +483,6 @@ int ida_solver_initial(DATA* data, threadData_t *threadData,
     case COLOREDNUMJAC:
       flag = IDASetJacFn(idaData->ida_mem, callDenseJacobian);
       checkReturnFlag_SUNDIALS(flag, SUNDIALS_IDALS_FLAG, "IDASetJacFn");
-#ifdef USE_PARJAC
-      allocateThreadLocalJacobians(data, &(idaData->jacColumns));
-      idaData->allocatedParMem = 1;   /* TRUE */
-#endif
       break;
     case INTERNALNUMJAC:
       /* TODO: Set a preconditioner if possible */
@@ -642,12 +644,7 @@ void ida_solver_deinitial(IDA_SOLVER *idaData)
   N_VDestroy_Serial(idaData->errwgt);
   N_VDestroy_Serial(idaData->newdelta);
 
-#ifdef USE_PARJAC
-  if (idaData->allocatedParMem) {
-      freeAnalyticalJacobian(&(idaData->jacColumns));
-      idaData->allocatedParMem = 0;
-  }
-#endif
+  freeColoredJacobian(idaData->coloredJacobian);
 
   IDAFree(&idaData->ida_mem);
 
@@ -1461,18 +1458,10 @@ static int jacColoredSymbolicalDense(double currentTime, double cj, N_Vector yy,
   TRACE_PUSH
   DATA* data = idaData->userData->data;
   threadData_t* threadData = idaData->userData->threadData;
-  void* ida_mem = idaData->ida_mem;
-  long int N = idaData->N;
   const int index = data->callback->INDEX_JAC_A;
-  unsigned int i,ii,j, nth;
-  SPARSE_PATTERN* sparsePattern = data->simulationInfo->analyticJacobians[index].sparsePattern;
   ANALYTIC_JACOBIAN* jac = &(data->simulationInfo->analyticJacobians[index]);
   jac->dae_cj = cj;
 
-  /* prepare variables */
-  double *states = N_VGetArrayPointer_Serial(yy);
-  double *yprime = N_VGetArrayPointer_Serial(yp);
-
   setContext(data, currentTime, CONTEXT_SYM_JACOBIAN);      /* Reuse jacobian matrix in KLU solver */
 
   /* Evaluate constant equations if available */
@@ -1480,62 +1469,9 @@ static int jacColoredSymbolicalDense(double currentTime, double cj, N_Vector yy,
       jac->constantEqns(data, threadData, jac, NULL);
   }
 
-#ifdef USE_PARJAC
-  GC_allow_register_threads();
-#endif
-
-#pragma omp parallel default(none) firstprivate(N) shared(i, sparsePattern, idaData, data, threadData, Jac) private(ii, j, nth)
-{
-#ifdef USE_PARJAC
-  /* Register omp-thread in GC */
-  if(!GC_thread_is_registered()) {
-     struct GC_stack_base sb;
-     memset (&sb, 0, sizeof(sb));
-     GC_get_stack_base(&sb);
-     GC_register_my_thread (&sb);
-  }
-  // ToDo Use always a thread local analyticJacobians (replace simulationInfo->analyticaJacobians)
-  // These are not the Jacobians of the linear systems! (SimulationInfo->linearSystemData[idx].jacobian)
-  ANALYTIC_JACOBIAN* t_jac = &(idaData->jacColumns[omc_get_thread_num()]);
-#else
-  ANALYTIC_JACOBIAN* t_jac = jac;
-#endif
-
-#pragma omp for
-  for(i = 0; i < sparsePattern->maxColors; i++)
-  {
-    for(ii=0; ii < N; ii++)
-    {
-      if(sparsePattern->colorCols[ii]-1 == i)
-      {
-        t_jac->seedVars[ii] = 1;
-      }
-    }
-
-    data->callback->functionJacA_column(data, threadData, t_jac, NULL);
-    increaseJacContext(data);
-
-    for(ii = 0; ii < N; ii++)
-    {
-      if(sparsePattern->colorCols[ii]-1 == i)
-      {
-        nth = sparsePattern->leadindex[ii];
-        while(nth < sparsePattern->leadindex[ii+1])
-        {
-          j  =  sparsePattern->index[nth];
-          infoStreamPrint(LOG_JAC, 0, "### symbolical jacobian  at [%d,%d] = %f ###", j, ii, t_jac->resultVars[j]);
-          SM_ELEMENT_D(Jac, j, ii) = t_jac->resultVars[j];
-          nth++;
-        };
-      }
-    }
-
-    for(ii=0; ii < idaData->N; ii++)
-    {
-      t_jac->seedVars[ii] = 0;
-    }
-  } // for column
-} // omp parallel
+  /* SUNDIALS dense matrices are stored column-major */
+  evalColoredJacobian(data, threadData, idaData->coloredJacobian, data->callback->functionJacA_column,
+                      SM_DATA_D(Jac), &setJacElementDense);
 
   unsetContext(data);
 
@@ -1577,13 +1513,16 @@ static int callDenseJacobian(realtype tt, realtype cj, N_Vector yy,
   if (measure_time_flag) rt_accumulate(SIM_TIMER_SOLVER);
   rt_tick(SIM_TIMER_JACOBIAN);
 
-  if (idaData->jacobianMethod == COLOREDNUMJAC || idaData->jacobianMethod == NUMJAC)
+  /* iterative linear solvers (INTERNALNUMJAC) only get here for the scaling factors */
+  if (idaData->jacobianMethod == COLOREDSYMJAC || idaData->jacobianMethod == SYMJAC ||
+      (idaData->jacobianMethod == INTERNALNUMJAC && idaData->coloredJacobian != NULL))
   {
-    retVal = jacColoredNumericalDense(tt, cj, yy, yp, rr, Jac, idaData);
+    retVal = jacColoredSymbolicalDense(tt, cj, yy, yp, rr, Jac, idaData);
   }
-  else if (idaData->jacobianMethod == COLOREDSYMJAC || idaData->jacobianMethod == SYMJAC)
+  else if (idaData->jacobianMethod == COLOREDNUMJAC || idaData->jacobianMethod == NUMJAC ||
+           idaData->jacobianMethod == INTERNALNUMJAC)
   {
-    retVal = jacColoredSymbolicalDense(tt, cj, yy, yp, rr, Jac, idaData);
+    retVal = jacColoredNumericalDense(tt, cj, yy, yp, rr, Jac, idaData);
   }
   else
   {
@@ -1795,15 +1734,7 @@ int jacColoredSymbolicalSparse(double currentTime, N_Vector yy, N_Vector yp,
   double *states = N_VGetArrayPointer_Serial(yy);
   double *yprime = N_VGetArrayPointer_Serial(yp);
 
-#ifdef USE_PARJAC
-  ANALYTIC_JACOBIAN* t_jac = (idaData->jacColumns);
-#else
-  ANALYTIC_JACOBIAN* t_jac = jac;
-#endif
-  unsigned int columns = jac->sizeCols;
-  unsigned int rows = jac->sizeRows;
   SPARSE_PATTERN* sparsePattern = jac->sparsePattern;
-  int maxColors = sparsePattern->maxColors;
 
   /* Reset Jacobian matrix */
   SUNMatZero(Jac);
@@ -1815,8 +1746,8 @@ int jacColoredSymbolicalSparse(double currentTime, N_Vector yy, N_Vector yp,
       jac->constantEqns(data, threadData, jac, NULL);
   }
 
-  genericColoredSymbolicJacobianEvaluation(rows, columns, sparsePattern, Jac, t_jac,
-                                           data, threadData, &setJacElementSundialsSparse);
+  evalColoredJacobian(data, threadData, idaData->coloredJacobian, data->callback->functionJacA_column,
+                      Jac, &setJacElementSundialsSparse);
 
   finishSparseColPtr(Jac, sparsePattern->numberOfNonZeros);
   unsetContext(data);
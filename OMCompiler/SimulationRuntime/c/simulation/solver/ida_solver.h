@@ -38,6 +38,7 @@
 #include "simulation_data.h"
 #include "util/simulation_options.h"
 #include "simulation/solver/solver_main.h"
+#include "simulation/jacobian_util.h"
 #include "omc_config.h" /* for WITH_SUNDIALS */
 
 #ifdef WITH_SUNDIALS
@@ -115,10 +116,7 @@ typedef struct IDA_SOLVER
   N_Vector* ySp;            /* Array of sensitfity vectors of state derivatives */
   N_Vector* ySResult;
 
-#ifdef USE_PARJAC
-  ANALYTIC_JACOBIAN* jacColumns;
-#endif
-  int allocatedParMem; /* indicated if parallel memory was allocated, 0=false, 1=true*/
+  COLORED_JACOBIAN* coloredJacobian;  /* colored, thread parallel evaluation of symbolic jacobian, NULL if not used */
 } IDA_SOLVER;
 
 /* initialize main ida Data */
@@ -258,6 +258,9 @@ NLS_KINSOL_DATA* nlsKinsolAllocate(int size, NLS_USERDATA* userData, modelica_bo
   }
   /* Scaled Jacobian is allocated with J */
   kinsolData->scaledJ = NULL;
+  /* Colored Jacobian evaluation is allocated on first use */
+  kinsolData->coloredJacobian = NULL;
+  kinsolData->fdJacobian = NULL;
 
   kinsolData->kinsolMemory = NULL;
   kinsolData->userData = userData;
@@ -291,6 +294,13 @@ void nlsKinsolFree(NLS_KINSOL_DATA* kinsolData) {
     N_VDestroy_Serial(kinsolData->tmp1);
     N_VDestroy_Serial(kinsolData->tmp2);
   }
+  freeColoredJacobian(kinsolData->coloredJacobian);
+  if (kinsolData->fdJacobian != NULL) {
+    free(kinsolData->fdJacobian->jacobian.seedVars);
+    free(kinsolData->fdJacobian->jacobian.tmpVars);
+    free(kinsolData->fdJacobian->jacobian.resultVars);
+    free(kinsolData->fdJacobian);
+  }
 
   freeNlsUserData(kinsolData->userData);
   free(kinsolData);
@@ -453,6 +463,112 @@ static void finishSparseColPtr(SUNMatrix A, int nnz) {
   }
 }
 
+/**
+ * @brief Get colored evaluation of Jacobian.
+ *
+ * (Re-)allocates the colored Jacobian if it was made for a different Jacobian.
+ * The colors are evaluated sequentially, the residual and column functions
+ * of the non-linear systems are not thread safe.
+ *
+ * @param kinsolData          KINSOL data.
+ * @param jacobian            Jacobian with sparsity pattern.
+ * @return COLORED_JACOBIAN*  Colored Jacobian for jacobian.
+ */
+static COLORED_JACOBIAN* nlsKinsolColoredJacobian(NLS_KINSOL_DATA *kinsolData, ANALYTIC_JACOBIAN *jacobian) {
+  if (kinsolData->coloredJacobian == NULL || kinsolData->coloredJacobian->jacobian != jacobian) {
+    freeColoredJacobian(kinsolData->coloredJacobian);
+    kinsolData->coloredJacobian = allocColoredJacobian(jacobian, 1, TRUE);
+  }
+  return kinsolData->coloredJacobian;
+}
+
+/**
+ * @brief Scale columns of sparse Jacobian.
+ *
+ * Jac(:, col) = Jac(:, col) * factor[col] / xScaling[col] for all colored columns.
+ *
+ * @param Jac         CSC matrix with sparsity pattern of coloredJac.
+ * @param coloredJac  Colored Jacobian Jac was evaluated with.
+ * @param factor      Column factors, can be NULL.
+ * @param xScaling    Column divisors, can be NULL.
+ */
+static void nlsKinsolScaleColumns(SUNMatrix Jac, const COLORED_JACOBIAN *coloredJac,
+                                  const double *factor, const double *xScaling) {
+  const SPARSE_PATTERN *sparsePattern = coloredJac->jacobian->sparsePattern;
+  double *values = SM_DATA_S(Jac);
+  unsigned int k, col, nth;
+
+  for (k = 0; k < coloredJac->colorStart[coloredJac->nColors]; k++) {
+    col = coloredJac->columns[k];
+    for (nth = sparsePattern->leadindex[col]; nth < sparsePattern->leadindex[col + 1]; nth++) {
+      if (factor != NULL) {
+        values[nth] *= factor[col];
+      }
+      if (xScaling != NULL) {
+        values[nth] /= xScaling[col];
+      }
+    }
+  }
+}
+
+/**
+ * @brief Finite differences for the columns of the current seed vector.
+ *
+ * Column function for evalColoredJacobian. All seeded columns are perturbed
+ * at once and the residual is evaluated once. Result is the difference
+ * f(x+h)-f(x), the division by the step size of each column is done by
+ * nlsSparseJac after the colors are scattered.
+ *
+ * @param data            Runtime data struct, unused.
+ * @param threadData      Thread data for error handling, unused.
+ * @param thisJacobian    Member jacobian of a NLS_KINSOL_FD_JACOBIAN.
+ * @param parentJacobian  Unused.
+ * @return int            Return 0 on success.
+ */
+static int nlsKinsolFiniteDifferenceColumn(DATA *data, threadData_t *threadData,
+                                           ANALYTIC_JACOBIAN *thisJacobian, ANALYTIC_JACOBIAN *parentJacobian) {
+  NLS_KINSOL_FD_JACOBIAN *fdJacobian = (NLS_KINSOL_FD_JACOBIAN *)thisJacobian;
+  NONLINEAR_SYSTEM_DATA *nlsData = fdJacobian->userData->nlsData;
+  NLS_KINSOL_DATA *kinsolData = (NLS_KINSOL_DATA *)nlsData->solverData;
+  double *x = N_VGetArrayPointer(fdJacobian->x);
+  double *fx = N_VGetArrayPointer(fdJacobian->fx);
+  double *fRes = NV_DATA_S(kinsolData->fRes);
+  double *xsave = fdJacobian->xsave;
+  double *delta_hh = fdJacobian->delta_hh;
+
+  const double delta_h = sqrt(DBL_EPSILON * 2e1);
+  unsigned int i;
+
+  for (i = 0; i < thisJacobian->sizeCols; i++) {
+    if (thisJacobian->seedVars[i] == 1.0) {
+      xsave[i] = x[i];
+      delta_hh[i] = delta_h * (fabs(xsave[i]) + 1.0);
+      if ((xsave[i] + delta_hh[i] >= nlsData->max[i])) {
+        delta_hh[i] *= -1;
+      }
+      x[i] += delta_hh[i];
+
+      /* Calculate scaled difference quotient */
+      delta_hh[i] = 1. / delta_hh[i];
+    }
+  }
+
+  /* Evaluate residual function */
+  nlsKinsolResiduals(fdJacobian->x, kinsolData->fRes, fdJacobian->userData);
+
+  for (i = 0; i < thisJacobian->sizeRows; i++) {
+    thisJacobian->resultVars[i] = fRes[i] - fx[i];
+  }
+
+  for (i = 0; i < thisJacobian->sizeCols; i++) {
+    if (thisJacobian->seedVars[i] == 1.0) {
+      x[i] = xsave[i];
+    }
+  }
+
+  return 0;
+}
+
 /**
  * @brief Colored numeric Jacobian evaluation.
  *
@@ -476,6 +592,8 @@ static int nlsSparseJac(N_Vector vecX, N_Vector vecFX, SUNMatrix Jac,
   NONLINEAR_SYSTEM_DATA *nlsData;
   NLS_KINSOL_DATA *kinsolData;
   SPARSE_PATTERN *sparsePattern;
+  NLS_KINSOL_FD_JACOBIAN *fdJacobian;
+  COLORED_JACOBIAN *coloredJac;
 
   if (SUNMatGetID(Jac) != SUNMATRIX_SPARSE || SM_SPARSETYPE_S(Jac) == CSR_MAT) {
     errorStreamPrint(LOG_STDOUT, 0,
@@ -483,18 +601,6 @@ static int nlsSparseJac(N_Vector vecX, N_Vector vecFX, SUNMatrix Jac,
     return -1;
   }
 
-  double *x;
-  double *fx;
-  double *xsave;
-  double *delta_hh;
-  double *xScaling;
-  double *fRes;
-
-  const double delta_h = sqrt(DBL_EPSILON * 2e1);
-
-  long int i, j, ii;
-  int nth;
-
   /* Access userData and nonlinear system data */
   kinsolUserData = (NLS_USERDATA *)userData;
   data = kinsolUserData->data;
@@ -503,15 +609,19 @@ static int nlsSparseJac(N_Vector vecX, N_Vector vecFX, SUNMatrix Jac,
   kinsolData = (NLS_KINSOL_DATA *)nlsData->solverData;
   sparsePattern = nlsData->sparsePattern;
 
-  /* Access N_Vector variables */
-  x = N_VGetArrayPointer(vecX);
-  fx = N_VGetArrayPointer(vecFX);
-  xsave = N_VGetArrayPointer(tmp1);
-  delta_hh = N_VGetArrayPointer(tmp2);
-  xScaling = NV_DATA_S(kinsolData->xScale);
-  fRes = NV_DATA_S(kinsolData->fRes);
+  if (kinsolData->fdJacobian == NULL) {
+    kinsolData->fdJacobian = (NLS_KINSOL_FD_JACOBIAN *)malloc(sizeof(NLS_KINSOL_FD_JACOBIAN));
+    initAnalyticJacobian(&kinsolData->fdJacobian->jacobian, kinsolData->size, kinsolData->size, 0, NULL, sparsePattern);
+    kinsolData->fdJacobian->userData = kinsolUserData;
+  }
+  fdJacobian = kinsolData->fdJacobian;
+  coloredJac = nlsKinsolColoredJacobian(kinsolData, &fdJacobian->jacobian);
 
-  nth = 0;
+  /* Access N_Vector variables */
+  fdJacobian->x = vecX;
+  fdJacobian->fx = vecFX;
+  fdJacobian->xsave = N_VGetArrayPointer(tmp1);
+  fdJacobian->delta_hh = N_VGetArrayPointer(tmp2);
 
   /* performance measurement */
   rt_ext_tp_tick(&nlsData->jacobianTimeClock);
@@ -520,43 +630,16 @@ static int nlsSparseJac(N_Vector vecX, N_Vector vecFX, SUNMatrix Jac,
   SUNMatZero(Jac);
 
   /* Approximate Jacobian */
-  for (i = 0; i < sparsePattern->maxColors; i++) {
-    for (ii = 0; ii < kinsolData->size; ii++) {
-      if (sparsePattern->colorCols[ii] - 1 == i) {
-        xsave[ii] = x[ii];
-        delta_hh[ii] = delta_h * (fabs(xsave[ii]) + 1.0);
-        if ((xsave[ii] + delta_hh[ii] >= nlsData->max[ii])) {
-          delta_hh[ii] *= -1;
-        }
-        x[ii] += delta_hh[ii];
+  evalColoredJacobian(data, threadData, coloredJac, &nlsKinsolFiniteDifferenceColumn,
+                      Jac, &setJacElementSundialsSparse);
 
-        /* Calculate scaled difference quotient */
-        delta_hh[ii] = 1. / delta_hh[ii];
-      }
-    }
-    /* Evaluate residual function */
-    nlsKinsolResiduals(vecX, kinsolData->fRes, userData);
-
-    /* Save column in Jac and unset seed variables */
-    for (ii = 0; ii < kinsolData->size; ii++) {
-      if (sparsePattern->colorCols[ii] - 1 == i) {
-        nth = sparsePattern->leadindex[ii];
-        while (nth < sparsePattern->leadindex[ii + 1]) {
-          j = sparsePattern->index[nth];
-          if (kinsolData->nominalJac) {
-            setJacElementSundialsSparse(j, ii, nth, (fRes[j] - fx[j]) * delta_hh[ii] / xScaling[ii], Jac, SM_CONTENT_S(Jac)->M);
-          } else {
-            setJacElementSundialsSparse(j, ii, nth, (fRes[j] - fx[j]) * delta_hh[ii], Jac, SM_CONTENT_S(Jac)->M);
-          }
-          nth++;
-        }
-        x[ii] = xsave[ii];
-      }
-    }
-  }
   /* Finish sparse matrix */
   finishSparseColPtr(Jac, sparsePattern->numberOfNonZeros);
 
+  /* Divide differences by step size */
+  nlsKinsolScaleColumns(Jac, coloredJac, fdJacobian->delta_hh,
+                        kinsolData->nominalJac ? NV_DATA_S(kinsolData->xScale) : NULL);
+
   /* Debug print */
   if (ACTIVE_STREAM(LOG_NLS_JAC)) {
     infoStreamPrint(LOG_NLS_JAC, 1, "KINSOL: Sparse Matrix.");
@@ -596,13 +679,7 @@ int nlsSparseSymJac(N_Vector vecX, N_Vector vecFX, SUNMatrix Jac,
   NLS_KINSOL_DATA *kinsolData;
   SPARSE_PATTERN *sparsePattern;
   ANALYTIC_JACOBIAN *analyticJacobian;
-
-  double *x;
-  double *fx;
-  double *xScaling;
-
-  long int i, j, ii;
-  int nth;
+  COLORED_JACOBIAN *coloredJac;
 
   if (SUNMatGetID(Jac) != SUNMATRIX_SPARSE || SM_SPARSETYPE_S(Jac) == CSR_MAT) {
     errorStreamPrint(LOG_STDOUT, 0,
@@ -618,12 +695,7 @@ int nlsSparseSymJac(N_Vector vecX, N_Vector vecFX, SUNMatrix Jac,
   analyticJacobian = kinsolUserData->analyticJacobian;
   kinsolData = (NLS_KINSOL_DATA *)nlsData->solverData;
   sparsePattern = nlsData->sparsePattern;
-
-  /* Access N_Vector variables */
-  x = N_VGetArrayPointer(vecX);
-  xScaling = NV_DATA_S(kinsolData->xScale);
-
-  nth = 0;
+  coloredJac = nlsKinsolColoredJacobian(kinsolData, analyticJacobian);
 
   /* performance measurement */
   rt_ext_tp_tick(&nlsData->jacobianTimeClock);
@@ -637,37 +709,16 @@ int nlsSparseSymJac(N_Vector vecX, N_Vector vecFX, SUNMatrix Jac,
   }
 
   /* Evaluate Jacobian */
-  for (i = 0; i < sparsePattern->maxColors; i++) {
-    /* Set seed variables */
-    for (ii = 0; ii < kinsolData->size; ii++) {
-      if (sparsePattern->colorCols[ii] - 1 == i) {
-        analyticJacobian->seedVars[ii] = 1.0;
-      }
-    }
-    /* Evaluate Jacobian column */
-    ((nlsData->analyticalJacobianColumn))(data, threadData, analyticJacobian, NULL);
-
-    /* Save column in Jac and unset seed variables */
-    for (ii = 0; ii < kinsolData->size; ii++) {
-      if (sparsePattern->colorCols[ii] - 1 == i) {
-        nth = sparsePattern->leadindex[ii];
-        while (nth < sparsePattern->leadindex[ii + 1]) {
-          j = sparsePattern->index[nth];
-          if (kinsolData->nominalJac) {
-            setJacElementSundialsSparse(j, ii, nth, analyticJacobian->resultVars[j] / xScaling[ii], Jac, SM_CONTENT_S(Jac)->M);
-          } else {
-            setJacElementSundialsSparse(j, ii, nth, analyticJacobian->resultVars[j], Jac, SM_CONTENT_S(Jac)->M);
-          }
-          nth++;
-        }
-        analyticJacobian->seedVars[ii] = 0;
-      }
-    }
-  }
+  evalColoredJacobian(data, threadData, coloredJac, nlsData->analyticalJacobianColumn,
+                      Jac, &setJacElementSundialsSparse);
 
   /* Finish sparse matrix and do a cheap check for singularity */
   finishSparseColPtr(Jac, sparsePattern->numberOfNonZeros);
 
+  if (kinsolData->nominalJac) {
+    nlsKinsolScaleColumns(Jac, coloredJac, NULL, NV_DATA_S(kinsolData->xScale));
+  }
+
   /* Debug print */
   if (ACTIVE_STREAM(LOG_NLS_JAC)) {
     infoStreamPrint(LOG_NLS_JAC, 1, "KINSOL: Sparse Matrix.");
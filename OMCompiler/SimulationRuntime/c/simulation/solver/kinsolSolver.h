@@ -43,6 +43,7 @@ extern "C" {
 #include "sundials_error.h"
 #include "simulation_data.h"
 #include "util/simulation_options.h"
+#include "simulation/jacobian_util.h"
 
 #include <kinsol/kinsol.h>
 #include <nvector/nvector_serial.h>
@@ -66,6 +67,16 @@ typedef enum scalingMode {
   SCALING_JACOBIAN                     /* Scale jacobian */
 } scalingMode;
 
+/* Finite difference Jacobian evaluated with evalColoredJacobian */
+typedef struct NLS_KINSOL_FD_JACOBIAN {
+  ANALYTIC_JACOBIAN jacobian;          /* Seed and result vectors, has to be the first member */
+  NLS_USERDATA* userData;              /* User data for residual evaluation */
+  N_Vector x;                          /* Point x the Jacobian is evaluated at */
+  N_Vector fx;                         /* Residual f(x) */
+  double* xsave;                       /* Unperturbed values of perturbed columns */
+  double* delta_hh;                    /* Inverse step size of each column */
+} NLS_KINSOL_FD_JACOBIAN;
+
 typedef struct NLS_KINSOL_DATA {
   /* ### configuration  ### */
   NLS_LS linearSolverMethod;           /* specifies the method to solve the
@@ -109,6 +120,8 @@ typedef struct NLS_KINSOL_DATA {
 
   N_Vector tmp1, tmp2;                  /* Work arrays for nlsSparseJac */
   SUNMatrix scaledJ;                    /* Scaled jacobian used for sparse Jacobian */
+  COLORED_JACOBIAN* coloredJacobian;    /* Colored evaluation of sparse Jacobian, allocated on first use */
+  NLS_KINSOL_FD_JACOBIAN* fdJacobian;   /* Finite differences for nlsSparseJac, allocated on first use */
 
   /* Properties of non-linear system */
   int size;                             /* Size of non-linear problem */
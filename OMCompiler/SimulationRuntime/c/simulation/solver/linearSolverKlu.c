@@ -263,8 +263,8 @@ int solveKlu(DATA *data, threadData_t *threadData, int sysNumber, double* aux_x)
     solverData->symbolic = klu_analyze(solverData->n_col, solverData->Ap, solverData->Ai, &solverData->common);
   }
 
-  /* if reuseMatrixJac use also previous factorization */
-  if (!reuseMatrixJac)
+  /* if A is unchanged or reuseMatrixJac use also previous factorization */
+  if (!reuseLinearSystemFactorization(systemData, reuseMatrixJac, solverData->Ax, solverData->nnz))
   {
     /* compute the LU factorization of A */
     if (0 == solverData->common.status){
@@ -285,6 +285,10 @@ int solveKlu(DATA *data, threadData_t *threadData, int sysNumber, double* aux_x)
     }
   }
 
+  if (0 != solverData->common.status){
+    invalidateLinearSystemFactorization(systemData);
+  }
+
   if (0 == solverData->common.status){
     if (1 == systemData->method){
       if (klu_solve(solverData->symbolic, solverData->numeric, solverData->n_col, 1, systemData->parDynamicData[omc_get_thread_num()].b, &solverData->common)){
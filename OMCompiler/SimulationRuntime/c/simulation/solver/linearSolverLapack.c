@@ -50,8 +50,8 @@
   #include <omp.h>
 #endif
 
-extern int dgesv_(int *n, int *nrhs, double *a, int *lda,
-                  int *ipiv, double *b, int *ldb, int *info);
+extern int dgetrf_(int *m, int *n, double *a, int *lda,
+                   int *ipiv, int *info);
 
 extern int dgetrs_(char* tran, int *n, int *nrhs, double *a, int *lda,
                   int *ipiv, double *b, int *ldb, int *info);
@@ -71,6 +71,7 @@ int allocateLapackData(int size, void** voiddata)
   data->x = _omc_createVector(size, NULL);
   data->b = _omc_createVector(size, NULL);
   data->A = _omc_createMatrix(size, size, NULL);
+  data->LU = _omc_allocateMatrixData(size, size);
 
   *voiddata = (void*)data;
   return 0;
@@ -89,6 +90,7 @@ int freeLapackData(void **voiddata)
   _omc_destroyVector(data->x);
   _omc_destroyVector(data->b);
   _omc_destroyMatrix(data->A);
+  _omc_deallocateMatrixData(data->LU);
 
   free(data);
   voiddata[0] = NULL;
@@ -234,28 +236,30 @@ int solveLapack(DATA *data, threadData_t *threadData, int sysNumber, double* aux
 
   rt_ext_tp_tick(&(solverData->timeClock));
 
-  /* if reuseMatrixJac use also previous factorization */
-  if (!reuseMatrixJac)
+  /* factorize A, if A is unchanged or reuseMatrixJac use previous factorization */
+  if (reuseLinearSystemFactorization(systemData, reuseMatrixJac, solverData->A->data, systemData->size*systemData->size))
   {
-    /* Solve system */
-    dgesv_((int*) &systemData->size,
-           (int*) &solverData->nrhs,
-           solverData->A->data,
-           (int*) &systemData->size,
-           solverData->ipiv,
-           solverData->b->data,
-           (int*) &systemData->size,
-           &solverData->info);
-
-  } /* further Jacobian evaluations */
+    solverData->info = 0;
+  }
   else
+  {
+    memcpy(solverData->LU->data, solverData->A->data, (systemData->size)*(systemData->size)*sizeof(double));
+    dgetrf_((int*) &systemData->size,
+            (int*) &systemData->size,
+            solverData->LU->data,
+            (int*) &systemData->size,
+            solverData->ipiv,
+            &solverData->info);
+  }
+
+  /* Solve system */
+  if (0 == solverData->info)
   {
     char trans = 'N';
-    /* Solve system */
     dgetrs_(&trans,
             (int*) &systemData->size,
             (int*) &solverData->nrhs,
-            solverData->A->data,
+            solverData->LU->data,
             (int*) &systemData->size,
             solverData->ipiv,
             solverData->b->data,
@@ -269,6 +273,7 @@ int solveLapack(DATA *data, threadData_t *threadData, int sysNumber, double* aux
   if(solverData->info < 0)
   {
     warningStreamPrint(LOG_LS, 0, "Error solving linear system of equations (no. %d) at time %f. Argument %d illegal.", (int)systemData->equationIndex, data->localData[0]->timeValue, (int)solverData->info);
+    invalidateLinearSystemFactorization(systemData);
     success = 0;
   }
   else if(solverData->info > 0)
@@ -277,11 +282,12 @@ int solveLapack(DATA *data, threadData_t *threadData, int sysNumber, double* aux
                                 "Failed to solve linear system of equations (no. %d) at time %f, system is singular for U[%d, %d].",
                                 (int)systemData->equationIndex, data->localData[0]->timeValue, (int)solverData->info+1, (int)solverData->info+1);
 
+    invalidateLinearSystemFactorization(systemData);
     success = 0;
 
     /* debug output */
     if (ACTIVE_STREAM(LOG_LS)){
-      _omc_printMatrix(solverData->A, "Matrix U", LOG_LS);
+      _omc_printMatrix(solverData->LU, "Matrix U", LOG_LS);
 
       _omc_printVector(solverData->b, "Output vector x", LOG_LS);
     }
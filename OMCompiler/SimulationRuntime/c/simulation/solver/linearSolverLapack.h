@@ -47,6 +47,7 @@ typedef struct DATA_LAPACK
   _omc_vector* x;
   _omc_vector* b;
   _omc_matrix* A;
+  _omc_matrix* LU;           /* LU factorization of A, reused while A is unchanged */
 
   rtclock_t timeClock;             /* time clock */
 
@@ -271,12 +271,13 @@ solveUmfPack(DATA *data, threadData_t *threadData, int sysNumber, double* aux_x)
   }
 
   /* compute the LU factorization of A */
-  /* if reuseMatrixJac use also previous factorization */
-  if (!reuseMatrixJac)
+  /* if A is unchanged or reuseMatrixJac use also previous factorization */
+  if (0 == status && !reuseLinearSystemFactorization(systemData, reuseMatrixJac, solverData->Ax, solverData->nnz))
   {
-    if (0 == status){
-      umfpack_di_free_numeric(&(solverData->numeric));
-      status = umfpack_di_numeric(solverData->Ap, solverData->Ai, solverData->Ax, solverData->symbolic, &(solverData->numeric), solverData->control, solverData->info);
+    umfpack_di_free_numeric(&(solverData->numeric));
+    status = umfpack_di_numeric(solverData->Ap, solverData->Ai, solverData->Ax, solverData->symbolic, &(solverData->numeric), solverData->control, solverData->info);
+    if (UMFPACK_OK != status) {
+      invalidateLinearSystemFactorization(systemData);
     }
   }
 
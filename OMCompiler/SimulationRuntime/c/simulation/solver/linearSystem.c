@@ -329,9 +329,17 @@ int initializeLinearSystems(DATA *data, threadData_t *threadData)
  */
 int allocLinSystThreadData(LINEAR_SYSTEM_DATA *linsys)
 {
+  int i;
+
   linsys->parDynamicData = (LINEAR_SYSTEM_THREAD_DATA*) malloc(omc_get_max_threads()*sizeof(LINEAR_SYSTEM_THREAD_DATA));
   if (!linsys->parDynamicData)
     return -1;
+  for (i=0; i<omc_get_max_threads(); ++i) {
+    linsys->parDynamicData[i].factorizedA = NULL;
+    linsys->parDynamicData[i].sizeFactorizedA = 0;
+    linsys->parDynamicData[i].numberOfFactorizations = 0;
+    linsys->parDynamicData[i].numberOfFactorizationsAvoided = 0;
+  }
   return 0;
 }
 
@@ -344,9 +352,69 @@ int allocLinSystThreadData(LINEAR_SYSTEM_DATA *linsys)
  */
 void freeLinSystThreadData(LINEAR_SYSTEM_DATA *linsys)
 {
+  int i;
+
+  for (i=0; i<omc_get_max_threads(); ++i) {
+    free(linsys->parDynamicData[i].factorizedA);
+  }
   free(linsys->parDynamicData);
 }
 
+/**
+ * @brief Check if the factorization of the previous call can be reused.
+ *
+ * Compares the values of matrix A with the values at the last factorization
+ * of the calling thread. Between events the coefficients of many linear systems
+ * are constant, so A is reassembled with the same values and the factorization
+ * can be reused for the new right hand side.
+ * If A changed the values are stored and the caller has to factorize A.
+ * Inside a symbolic Jacobian evaluation the matrix is not reassembled
+ * (reuseMatrixJac) and the stored factorization is used as well.
+ *
+ * @param linsys          Linear system.
+ * @param reuseMatrixJac  True if A was not reassembled for this call.
+ * @param values          Values of matrix A, e.g. dense matrix or non-zeros of a sparse matrix.
+ * @param nValues         Number of values.
+ * @return modelica_boolean  True if the previous factorization can be reused, false if A has to be factorized.
+ */
+modelica_boolean reuseLinearSystemFactorization(LINEAR_SYSTEM_DATA *linsys, modelica_boolean reuseMatrixJac, const double *values, size_t nValues)
+{
+  LINEAR_SYSTEM_THREAD_DATA *parData = &(linsys->parDynamicData[omc_get_thread_num()]);
+
+  if (parData->sizeFactorizedA == nValues &&
+      (reuseMatrixJac || 0 == memcmp(parData->factorizedA, values, nValues*sizeof(double))))
+  {
+    parData->numberOfFactorizationsAvoided++;
+    return 1 /* true */;
+  }
+
+  if (parData->factorizedA == NULL || parData->sizeFactorizedA != nValues) {
+    free(parData->factorizedA);
+    parData->factorizedA = (double*) malloc(nValues*sizeof(double));
+    if (parData->factorizedA == NULL) {
+      parData->sizeFactorizedA = 0;
+      parData->numberOfFactorizations++;
+      return 0 /* false */;
+    }
+  }
+  memcpy(parData->factorizedA, values, nValues*sizeof(double));
+  parData->sizeFactorizedA = nValues;
+  parData->numberOfFactorizations++;
+  return 0 /* false */;
+}
+
+/**
+ * @brief Forget the stored factorization of the calling thread.
+ *
+ * Has to be called if the factorization failed, so the next call factorizes A again.
+ *
+ * @param linsys    Linear system.
+ */
+void invalidateLinearSystemFactorization(LINEAR_SYSTEM_DATA *linsys)
+{
+  linsys->parDynamicData[omc_get_thread_num()].sizeFactorizedA = 0;
+}
+
 /**
  * @brief Set min, max, nominal for linear systems.
  *
@@ -392,12 +460,22 @@ int updateStaticDataOfLinearSystems(DATA *data, threadData_t *threadData)
 void printLinearSystemSolvingStatistics(DATA *data, int sysNumber, int logLevel)
 {
   LINEAR_SYSTEM_DATA* linsys = data->simulationInfo->linearSystemData;
+  unsigned long numberOfFactorizations = 0, numberOfFactorizationsAvoided = 0;
+  int i;
+
+  /* the factorizations are counted by each thread */
+  for (i=0; i<omc_get_max_threads(); ++i) {
+    numberOfFactorizations += linsys[sysNumber].parDynamicData[i].numberOfFactorizations;
+    numberOfFactorizationsAvoided += linsys[sysNumber].parDynamicData[i].numberOfFactorizationsAvoided;
+  }
   infoStreamPrint(logLevel, 1, "Linear system %d with (size = %d, nonZeroElements = %d, density = %.2f %%) solver statistics:",
                                (int)linsys[sysNumber].equationIndex, (int)linsys[sysNumber].size, (int)linsys[sysNumber].nnz,
                                (((double) linsys[sysNumber].nnz) / ((double)(linsys[sysNumber].size*linsys[sysNumber].size)))*100 );
   infoStreamPrint(logLevel, 0, " number of calls                : %ld", linsys[sysNumber].numberOfCall);
   infoStreamPrint(logLevel, 0, " average time per call          : %g", linsys[sysNumber].totalTime/linsys[sysNumber].numberOfCall);
   infoStreamPrint(logLevel, 0, " time of jacobian evaluations   : %g", linsys[sysNumber].jacobianTime);
+  infoStreamPrint(logLevel, 0, " number of factorizations       : %lu", numberOfFactorizations);
+  infoStreamPrint(logLevel, 0, " factorizations avoided         : %lu", numberOfFactorizationsAvoided);
   infoStreamPrint(logLevel, 0, " total time                     : %g", linsys[sysNumber].totalTime);
   messageClose(logLevel);
 }
@@ -55,6 +55,8 @@ int freeLinearSystems(DATA *data, threadData_t *threadData);
 int solve_linear_system(DATA *data, threadData_t *threadData, int sysNumber, double* aux_x);
 int check_linear_solutions(DATA *data, int printFailingSystems);
 void printLinearSystemSolvingStatistics(DATA *data, int sysNumber, int logLevel);
+modelica_boolean reuseLinearSystemFactorization(LINEAR_SYSTEM_DATA *linsys, modelica_boolean reuseMatrixJac, const double *values, size_t nValues);
+void invalidateLinearSystemFactorization(LINEAR_SYSTEM_DATA *linsys);
 
 #ifdef __cplusplus
 }
@@ -1088,8 +1088,8 @@ void initializeDataStruc(DATA *data, threadData_t *threadData)
   /* initialize zeroCrossingsIndex with corresponding index is used by events lists */
   for(i=0; i<data->modelData->nZeroCrossings; i++)
     data->simulationInfo->zeroCrossingIndex[i] = (long)i;
-  data->simulationInfo->states_left = (modelica_real*) malloc(data->modelData->nStates * sizeof(modelica_real));
-  data->simulationInfo->states_right = (modelica_real*) malloc(data->modelData->nStates * sizeof(modelica_real));
+  data->simulationInfo->states_left = (modelica_real*) malloc(2 * data->modelData->nStates * sizeof(modelica_real));
+  data->simulationInfo->states_right = (modelica_real*) malloc(2 * data->modelData->nStates * sizeof(modelica_real));
 
   /* buffer for old values */
   data->simulationInfo->realVarsOld = (modelica_real*) calloc(data->modelData->nVariablesReal, sizeof(modelica_real));
@@ -1196,6 +1196,8 @@ void initializeDataStruc(DATA *data, threadData_t *threadData)
   data->simulationInfo->callStatistics.functionZeroCrossingsEquations = 0;
   data->simulationInfo->callStatistics.functionZeroCrossings = 0;
   data->simulationInfo->callStatistics.functionAlgebraics = 0;
+  data->simulationInfo->callStatistics.rootFindingEvents = 0;
+  data->simulationInfo->callStatistics.rootFindingIterations = 0;
 
   data->simulationInfo->lambda = 1.0;
 
@@ -1218,12 +1220,16 @@ void initializeDataStruc(DATA *data, threadData_t *threadData)
 #if !defined(OMC_NDELAY_EXPRESSIONS) || OMC_NDELAY_EXPRESSIONS>0
   data->simulationInfo->delayStructure = (RINGBUFFER**)malloc(data->modelData->nDelayExpressions * sizeof(RINGBUFFER*));
   assertStreamPrint(threadData, 0 == data->modelData->nDelayExpressions || 0 != data->simulationInfo->delayStructure, "out of memory");
+  data->simulationInfo->delayCursor = (DELAY_CURSOR*)malloc(data->modelData->nDelayExpressions * sizeof(DELAY_CURSOR));
+  assertStreamPrint(threadData, 0 == data->modelData->nDelayExpressions || 0 != data->simulationInfo->delayCursor, "out of memory");
 
   for(i=0; i<data->modelData->nDelayExpressions; i++)
   {
     // TODO: Calculate how big ringbuffer should be for each delay expression
     // can be estimated by lower bound delayMax/stepSize
     data->simulationInfo->delayStructure[i] = allocRingBuffer(1024, sizeof(TIME_AND_VALUE));
+    data->simulationInfo->delayCursor[i].lastPosition = 0;
+    data->simulationInfo->delayCursor[i].firstEvent = -1;
   }
 #endif
 
@@ -1380,6 +1386,7 @@ void deInitializeDataStruc(DATA *data)
     freeRingBuffer(data->simulationInfo->delayStructure[i]);
 
   free(data->simulationInfo->delayStructure);
+  free(data->simulationInfo->delayCursor);
 
 #if !defined(OMC_NO_STATESELECTION)
   /* free stateset data */
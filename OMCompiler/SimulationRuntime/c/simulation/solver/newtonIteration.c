@@ -100,6 +100,7 @@ DATA_NEWTON* allocateNewtonData(int size, NLS_USERDATA* userData)
   newtonData->maxfev = size*100;
   newtonData->epsfcn = DBL_EPSILON;
   newtonData->fjac = (double*) malloc((size*(size+1))*sizeof(double));
+  newtonData->coloredJacobian = NULL;
 
   newtonData->rwork = (double*) malloc((size)*sizeof(double));
   newtonData->iwork = (int*) malloc(size*sizeof(int));
@@ -134,6 +135,7 @@ void freeNewtonData(DATA_NEWTON* newtonData)
   free(newtonData->x);
   free(newtonData->fvec);
   free(newtonData->fjac);
+  freeColoredJacobian(newtonData->coloredJacobian);
   free(newtonData->rwork);
   free(newtonData->iwork);
 
@@ -37,6 +37,7 @@
 #include "nonlinearSolverNewton.h"
 #include "nonlinearSystem.h"
 #include "simulation_data.h"
+#include "../jacobian_util.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -63,6 +64,7 @@ typedef struct DATA_NEWTON
   int info;
   double epsfcn;
   double* fjac;           /** Jacobian matrix in row-major format */
+  COLORED_JACOBIAN* coloredJacobian;  /** colored evaluation of analytic Jacobian, allocated on first use */
   double* rwork;
   int* iwork;
   int calculate_jacobian;
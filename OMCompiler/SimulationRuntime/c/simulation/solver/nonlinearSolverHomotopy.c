@@ -54,6 +54,7 @@
 #endif
 
 #include "nonlinearSystem.h"
+#include "../jacobian_util.h"
 #include "nonlinearSolverHomotopy.h"
 #include "nonlinearSolverHybrd.h"
 
@@ -155,6 +156,8 @@ typedef struct DATA_HOMOTOPY
 
   DATA_HYBRD* dataHybrid;
 
+  COLORED_JACOBIAN* coloredJacobian; /* colored evaluation of analytic Jacobian, allocated on first use */
+
 } DATA_HOMOTOPY;
 
 /**
@@ -227,6 +230,7 @@ DATA_HOMOTOPY* allocateHomotopyData(size_t size, NLS_USERDATA* userData)
   homotopyData->userData = userData;
 
   homotopyData->dataHybrid = allocateHybrdData(size, userData);
+  homotopyData->coloredJacobian = NULL;
 
   return homotopyData;
 }
@@ -279,6 +283,7 @@ void freeHomotopyData(DATA_HOMOTOPY* homotopyData)
 
   /* Don't free userData here, it's done in freeHybrdData */
   freeHybrdData(homotopyData->dataHybrid);
+  freeColoredJacobian(homotopyData->coloredJacobian);
 
   free(homotopyData);
   return;
@@ -833,11 +838,17 @@ void swapPointer(double* *p1, double* *p2)
  */
 int getAnalyticalJacobianHomotopy(DATA_HOMOTOPY* solverData, double* jac)
 {
-  int i,j,k,l,ii;
+  unsigned int j, nth;
   DATA* data = solverData->userData->data;
   threadData_t *threadData = solverData->userData->threadData;
   NONLINEAR_SYSTEM_DATA* systemData = solverData->userData->nlsData;
   ANALYTIC_JACOBIAN* jacobian = solverData->userData->analyticJacobian;
+  const SPARSE_PATTERN* spp = jacobian->sparsePattern;
+
+  if (solverData->coloredJacobian == NULL || solverData->coloredJacobian->jacobian != jacobian) {
+    freeColoredJacobian(solverData->coloredJacobian);
+    solverData->coloredJacobian = allocColoredJacobian(jacobian, 1, TRUE);
+  }
 
   memset(jac, 0, (solverData->n)*(solverData->n)*sizeof(double));
 
@@ -845,32 +856,15 @@ int getAnalyticalJacobianHomotopy(DATA_HOMOTOPY* solverData, double* jac)
     jacobian->constantEqns(data, threadData, jacobian, NULL);
   }
 
-  for(i=0; i < jacobian->sparsePattern->maxColors; i++)
-  {
-    /* activate seed variable for the corresponding color */
-    for(ii=0; ii < jacobian->sizeCols; ii++)
-      if(jacobian->sparsePattern->colorCols[ii]-1 == i)
-        jacobian->seedVars[ii] = 1;
-
-    ((systemData->analyticalJacobianColumn))(data, threadData, jacobian, NULL);
+  evalColoredJacobian(data, threadData, solverData->coloredJacobian, systemData->analyticalJacobianColumn,
+                      jac, &setJacElementDense);
 
-    for(j = 0; j < jacobian->sizeCols; j++)
+  /* Calculate scaled difference quotient */
+  for(j = 0; j < jacobian->sizeCols; j++)
+  {
+    for(nth = spp->leadindex[j]; nth < spp->leadindex[j+1]; nth++)
     {
-      if(jacobian->seedVars[j] == 1)
-      {
-        ii = jacobian->sparsePattern->leadindex[j];
-        while(ii < jacobian->sparsePattern->leadindex[j+1])
-        {
-          l  = jacobian->sparsePattern->index[ii];
-          k  = j*jacobian->sizeRows + l;
-          /* Calculate scaled difference quotient */
-          jac[k] = jacobian->resultVars[l] * solverData->xScaling[j];
-          ii++;
-        };
-      }
-      /* de-activate seed variable for the corresponding color */
-      if(jacobian->sparsePattern->colorCols[j]-1 == i)
-        jacobian->seedVars[j] = 0;
+      jac[j*jacobian->sizeRows + spp->index[nth]] *= solverData->xScaling[j];
     }
   }
 
@@ -91,6 +91,7 @@ DATA_HYBRD* allocateHybrdData(size_t size, NLS_USERDATA* userData)
   hybrdData->njev = 0;
   hybrdData->fjac = (double*) calloc((size*(size+1)), sizeof(double));
   hybrdData->fjacobian = (double*) calloc((size*(size+1)), sizeof(double));
+  hybrdData->coloredJacobian = NULL;
   hybrdData->ldfjac = size;
   hybrdData->r__ = (double*) malloc(((size*(size+1))/2)*sizeof(double));
   hybrdData->lr = (size*(size + 1)) / 2;
@@ -127,6 +128,7 @@ void freeHybrdData(DATA_HYBRD* hybrdData)
   free(hybrdData->diagres);
   free(hybrdData->fjac);
   free(hybrdData->fjacobian);
+  freeColoredJacobian(hybrdData->coloredJacobian);
   free(hybrdData->r__);
   free(hybrdData->qtf);
   free(hybrdData->wa1);
@@ -250,6 +252,8 @@ static int getNumericalJacobian(NLS_USERDATA* hybrdUserData, double* jac, const
  * @brief Calculate analytic Jacobian J(x).
  *
  * Using symbolic Jacobian and sparsity + coloring.
+ * The colors are evaluated sequentially, the column functions of the
+ * non-linear systems are not thread safe.
  * x has to be set before calling this function.
  *
  * @param hybrdUserData   Pointer to hybrid solver user data.
@@ -258,48 +262,27 @@ static int getNumericalJacobian(NLS_USERDATA* hybrdUserData, double* jac, const
  */
 static int getAnalyticalJacobian(NLS_USERDATA* hybrdUserData, double* jac)
 {
-  int i, j, k, l, ii;
   DATA *data = hybrdUserData->data;
   threadData_t *threadData = hybrdUserData->threadData;
   NONLINEAR_SYSTEM_DATA* systemData = hybrdUserData->nlsData;
   DATA_HYBRD* solverData = (DATA_HYBRD*)(systemData->solverData);
-  const int index = systemData->jacobianIndex;
   ANALYTIC_JACOBIAN* jacobian = hybrdUserData->analyticJacobian;
 
+  if (solverData->coloredJacobian == NULL || solverData->coloredJacobian->jacobian != jacobian) {
+    freeColoredJacobian(solverData->coloredJacobian);
+    solverData->coloredJacobian = allocColoredJacobian(jacobian, 1, TRUE);
+  }
+
   memset(jac, 0, (solverData->n)*(solverData->n)*sizeof(double));
-  memset(solverData->fjacobian, 0, (solverData->n)*(solverData->n)*sizeof(double));
 
   if (jacobian->constantEqns != NULL) {
     jacobian->constantEqns(data, threadData, jacobian, NULL);
   }
 
-  for(i=0; i < jacobian->sparsePattern->maxColors; i++)
-  {
-    /* activate seed variable for the corresponding color */
-    for(ii=0; ii < jacobian->sizeCols; ii++)
-      if(jacobian->sparsePattern->colorCols[ii]-1 == i)
-        jacobian->seedVars[ii] = 1;
+  evalColoredJacobian(data, threadData, solverData->coloredJacobian, systemData->analyticalJacobianColumn,
+                      jac, &setJacElementDense);
 
-    ((systemData->analyticalJacobianColumn))(data, threadData, jacobian, NULL);
-
-    for(j=0; j<jacobian->sizeCols; j++)
-    {
-      if(jacobian->seedVars[j] == 1)
-      {
-        ii = jacobian->sparsePattern->leadindex[j];
-        while(ii < jacobian->sparsePattern->leadindex[j+1])
-        {
-          l  = jacobian->sparsePattern->index[ii];
-          k  = j*jacobian->sizeRows + l;
-          solverData->fjacobian[k] = jac[k] = jacobian->resultVars[l];
-          ii++;
-        };
-      }
-      /* de-activate seed variable for the corresponding color */
-      if(jacobian->sparsePattern->colorCols[j]-1 == i)
-        jacobian->seedVars[j] = 0;
-    }
-  }
+  memcpy(solverData->fjacobian, jac, (solverData->n)*(solverData->n)*sizeof(double));
 
   return 0;
 }
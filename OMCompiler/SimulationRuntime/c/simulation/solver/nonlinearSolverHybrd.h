@@ -37,6 +37,7 @@
 #include "../../openmodelica_types.h"
 #include "../../simulation_data.h"
 #include "nonlinearSystem.h"
+#include "../jacobian_util.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -71,6 +72,7 @@ typedef struct DATA_HYBRD
   integer njev;
   double* fjac;         /* Jacobian matrix in row-major order */
   double* fjacobian;
+  COLORED_JACOBIAN* coloredJacobian;   /* colored evaluation of analytic Jacobian, allocated on first use */
   integer ldfjac;
   double* r__;
   integer lr;
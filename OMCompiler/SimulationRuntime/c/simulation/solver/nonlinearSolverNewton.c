@@ -48,6 +48,7 @@ extern "C" {
 #include "nonlinearSystem.h"
 #include "nonlinearSolverNewton.h"
 #include "newtonIteration.h"
+#include "simulation/jacobian_util.h"
 
 #include "external_input.h"
 
@@ -65,6 +66,8 @@ extern int dgesv_(int *n, int *nrhs, doublereal *a, int *lda, int *ipiv, doubler
  * @brief Compute analytical Jacobian for Newton solver.
  *
  * Using coloring and sparsity pattern.
+ * The colors are evaluated sequentially, the column functions of the
+ * non-linear systems (e.g. the stage systems of gbode) are not thread safe.
  *
  * @param data        Pointer to data.
  * @param threadData  Pointer to thread data.
@@ -75,38 +78,17 @@ extern int dgesv_(int *n, int *nrhs, doublereal *a, int *lda, int *ipiv, doubler
  */
 int getAnalyticalJacobianNewton(DATA* data, threadData_t *threadData, double* jac, NONLINEAR_SYSTEM_DATA* nlsData, ANALYTIC_JACOBIAN* jacobian)
 {
-  int i,j,k,l,ii;
   DATA_NEWTON* solverData = (DATA_NEWTON*)(nlsData->solverData);
 
-  memset(jac, 0, (solverData->n)*(solverData->n)*sizeof(double));
-
-  for(i=0; i < jacobian->sparsePattern->maxColors; i++)
-  {
-    /* activate seed variable for the corresponding color */
-    for(ii=0; ii < jacobian->sizeCols; ii++)
-      if(jacobian->sparsePattern->colorCols[ii]-1 == i)
-        jacobian->seedVars[ii] = 1;
+  if (solverData->coloredJacobian == NULL || solverData->coloredJacobian->jacobian != jacobian) {
+    freeColoredJacobian(solverData->coloredJacobian);
+    solverData->coloredJacobian = allocColoredJacobian(jacobian, 1, TRUE);
+  }
 
-    nlsData->analyticalJacobianColumn(data, threadData, jacobian, NULL);
+  memset(jac, 0, (solverData->n)*(solverData->n)*sizeof(double));
 
-    for(j = 0; j < jacobian->sizeCols; j++)
-    {
-      if(jacobian->seedVars[j] == 1)
-      {
-        ii = jacobian->sparsePattern->leadindex[j];
-        while(ii < jacobian->sparsePattern->leadindex[j+1])
-        {
-          l  = jacobian->sparsePattern->index[ii];
-          k  = j*jacobian->sizeRows + l;
-          jac[k] = jacobian->resultVars[l];
-          ii++;
-        };
-      }
-      /* de-activate seed variable for the corresponding color */
-      if(jacobian->sparsePattern->colorCols[j]-1 == i)
-        jacobian->seedVars[j] = 0;
-    }
-  }
+  evalColoredJacobian(data, threadData, solverData->coloredJacobian, nlsData->analyticalJacobianColumn,
+                      jac, &setJacElementDense);
 
   return 0;
 }
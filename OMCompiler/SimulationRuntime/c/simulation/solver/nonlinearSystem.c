@@ -57,6 +57,11 @@
 #include "../../meta/meta_modelica.h"
 
 int check_nonlinear_solution(DATA *data, int printFailingSystems, int sysNumber);
+int getWarmStartGuess(NONLINEAR_SYSTEM_DATA *nonlinsys, double time);
+#if !defined(OMC_MINIMAL_RUNTIME)
+void readNlsWarmStart(DATA *data, const char *fileName);
+void writeNlsWarmStart(DATA *data, const char *fileName);
+#endif
 
 extern int init_lambda_steps;
 
@@ -426,7 +431,14 @@ void initializeNonlinearSystemData(DATA *data, threadData_t *threadData, NONLINE
   nonlinsys->resValues = (double*) malloc(size*sizeof(double));
 
   /* allocate value list*/
-  nonlinsys->oldValueList = allocValueList(1, nonlinsys->size);
+  nonlinsys->oldValueList = allocValueList(VALUES_LIST_CAPACITY, nonlinsys->size);
+  if (omc_flag[FLAG_NLS_WARM_START]) {
+    nonlinsys->warmStartValues = allocValueList(WARM_START_CAPACITY, nonlinsys->size);
+    nonlinsys->recordedValues = allocValueList(WARM_START_CAPACITY, nonlinsys->size);
+  } else {
+    nonlinsys->warmStartValues = NULL;
+    nonlinsys->recordedValues = NULL;
+  }
 
   nonlinsys->lastTimeSolved = 0.0;
 
@@ -619,6 +631,12 @@ int initializeNonlinearSystems(DATA *data, threadData_t *threadData)
     initializeNonlinearSystemData(data, threadData, &nonlinsys[i], i, &someSmallDensity, &someBigSize);
   }
 
+#if !defined(OMC_MINIMAL_RUNTIME)
+  if (omc_flag[FLAG_NLS_WARM_START]) {
+    readNlsWarmStart(data, omc_flagValue[FLAG_NLS_WARM_START]);
+  }
+#endif
+
   /* print relevant flag information */
   if (someSmallDensity) {
     if (someBigSize) {
@@ -692,7 +710,9 @@ void freeNonlinearSyst(DATA* data, threadData_t* threadData, NONLINEAR_SYSTEM_DA
   free(nonlinsys->max);
   nonlinsys->freeStaticNLSData(data, threadData, nonlinsys);
 
-  freeValueList(nonlinsys->oldValueList, 1);
+  freeValueList(nonlinsys->oldValueList);
+  freeValueList(nonlinsys->warmStartValues);
+  freeValueList(nonlinsys->recordedValues);
   freeNonlinearPattern(nonlinsys->nonlinearPattern);
 
   /* Free CSV data */
@@ -770,6 +790,11 @@ void freeNonlinearSystems(DATA *data, threadData_t *threadData)
   NONLINEAR_SYSTEM_DATA* nonlinsys = data->simulationInfo->nonlinearSystemData;
 
   infoStreamPrint(LOG_NLS, 1, "free non-linear system solvers");
+#if !defined(OMC_MINIMAL_RUNTIME)
+  if (omc_flag[FLAG_NLS_WARM_START]) {
+    writeNlsWarmStart(data, omc_flagValue[FLAG_NLS_WARM_START]);
+  }
+#endif
   for(i=0; i<data->modelData->nNonLinearSystems; ++i)
   {
     freeNonlinearSyst(data, threadData, &nonlinsys[i]);
@@ -874,23 +899,49 @@ void printNonLinearFinishInfo(int logName, DATA* data, NONLINEAR_SYSTEM_DATA *no
 int getInitialGuess(NONLINEAR_SYSTEM_DATA *nonlinsys, double time)
 {
   /* value extrapolation */
-  printValuesListTimes(nonlinsys->oldValueList->valueList);
+  printValuesListTimes(nonlinsys->oldValueList);
   /* if list is empty use current start values */
-  if (listLen(nonlinsys->oldValueList->valueList)==0)
+  if (nonlinsys->oldValueList->length == 0)
   {
-    /* use old value if no values are stored in the list */
-    memcpy(nonlinsys->nlsx, nonlinsys->nlsxOld, nonlinsys->size*(sizeof(double)));
+    /* use solutions of a previous run or old value if no values are stored in the list */
+    if (!getWarmStartGuess(nonlinsys, time))
+    {
+      memcpy(nonlinsys->nlsx, nonlinsys->nlsxOld, nonlinsys->size*(sizeof(double)));
+    }
   }
   else
   {
     /* get extrapolated values */
-    getValues(nonlinsys->oldValueList->valueList, time, nonlinsys->nlsxExtrapolation, nonlinsys->nlsxOld);
+    getValues(nonlinsys->oldValueList, time, nonlinsys->nlsxExtrapolation, nonlinsys->nlsxOld);
     memcpy(nonlinsys->nlsx, nonlinsys->nlsxOld, nonlinsys->size*(sizeof(double)));
   }
 
   return 0;
 }
 
+/*! \fn getWarmStartGuess
+ *
+ *  This function writes the solution of a previous run, read with
+ *  -nlsWarmStart, to nonlinsys->nlsx and nonlinsys->nlsxOld.
+ *
+ *  \param [in]  [nonlinsys]
+ *  \param [in]  [time] time for interpolation
+ *  \return 1 if a solution of a previous run is available, 0 otherwise
+ */
+int getWarmStartGuess(NONLINEAR_SYSTEM_DATA *nonlinsys, double time)
+{
+  if (nonlinsys->warmStartValues == NULL || nonlinsys->warmStartValues->length == 0)
+  {
+    return 0;
+  }
+
+  infoStreamPrint(LOG_NLS_EXTRAPOLATE, 0, "use solutions of previous run");
+  getValues(nonlinsys->warmStartValues, time, nonlinsys->nlsxExtrapolation, nonlinsys->nlsxOld);
+  memcpy(nonlinsys->nlsx, nonlinsys->nlsxOld, nonlinsys->size*(sizeof(double)));
+
+  return 1;
+}
+
 /*! \fn updateInitialGuessDB
  *
  *  This function writes new values to solution list.
@@ -902,39 +953,149 @@ int getInitialGuess(NONLINEAR_SYSTEM_DATA *nonlinsys, double time)
  */
 int updateInitialGuessDB(NONLINEAR_SYSTEM_DATA *nonlinsys, double time, EVAL_CONTEXT context)
 {
-  /* Variables */
-  VALUE* tmpNode;
-
   /* write solution to oldValue list for extrapolation */
   if (nonlinsys->solved == NLS_SOLVED)
   {
     /* do not use solution of jacobian for next extrapolation */
     if (context == CONTEXT_ODE || context == CONTEXT_ALGEBRAIC || context == CONTEXT_EVENTS)
     {
-      tmpNode = createValueElement(nonlinsys->size, time, nonlinsys->nlsx);
-      addListElement(nonlinsys->oldValueList->valueList,
-                     tmpNode);
-      freeValue(tmpNode);
+      addListElement(nonlinsys->oldValueList, time, nonlinsys->nlsx);
+    }
+    /* record solution for the warm start of the next run, including initialization */
+    if (nonlinsys->recordedValues && context != CONTEXT_JACOBIAN && context != CONTEXT_SYM_JACOBIAN)
+    {
+      recordListElement(nonlinsys->recordedValues, time, nonlinsys->nlsx);
     }
   }
   else if (nonlinsys->solved == NLS_SOLVED_LESS_ACCURACY)
   {
-    if (listLen((nonlinsys->oldValueList)->valueList)>0)
-    {
-      cleanValueList(nonlinsys->oldValueList->valueList, NULL);
-    }
+    cleanValueList(nonlinsys->oldValueList);
     /* do not use solution of jacobian for next extrapolation */
     if (context == CONTEXT_ODE || context == CONTEXT_ALGEBRAIC || context == CONTEXT_EVENTS)
     {
-      tmpNode = createValueElement(nonlinsys->size, time, nonlinsys->nlsx);
-      addListElement(nonlinsys->oldValueList->valueList,
-                     tmpNode);
-      freeValue(tmpNode);
+      addListElement(nonlinsys->oldValueList, time, nonlinsys->nlsx);
     }
   }
   return 0;
 }
 
+#if !defined(OMC_MINIMAL_RUNTIME)
+#define NLS_WARM_START_MAGIC "OMNLSWS1"
+
+/*! \fn readNlsWarmStart
+ *
+ *  This function reads the solutions written by writeNlsWarmStart.
+ *  Systems are matched by equation index and size, systems of a
+ *  different model are ignored. A missing file is not an error.
+ *
+ *  \param [in]  [data]
+ *  \param [in]  [fileName] file given with -nlsWarmStart
+ */
+void readNlsWarmStart(DATA *data, const char *fileName)
+{
+  NONLINEAR_SYSTEM_DATA* nonlinsys = data->simulationInfo->nonlinearSystemData;
+  FILE *pFile = omc_fopen(fileName, "rb");
+  char magic[8];
+  long i;
+  modelica_integer nSystems, equationIndex, size;
+  unsigned int length;
+  int found = 0, failed = 0;
+
+  if (pFile == NULL)
+  {
+    infoStreamPrint(LOG_NLS, 0, "no warm start values for non-linear systems in file %s", fileName);
+    return;
+  }
+
+  if (1 != fread(magic, sizeof(magic), 1, pFile) || 0 != memcmp(magic, NLS_WARM_START_MAGIC, sizeof(magic)) ||
+      1 != fread(&nSystems, sizeof(modelica_integer), 1, pFile))
+  {
+    warningStreamPrint(LOG_STDOUT, 0, "Ignoring file %s, it does not contain warm start values for non-linear systems.", fileName);
+    fclose(pFile);
+    return;
+  }
+
+  while (nSystems-- > 0 && !failed)
+  {
+    if (1 != fread(&equationIndex, sizeof(modelica_integer), 1, pFile) || 1 != fread(&size, sizeof(modelica_integer), 1, pFile))
+    {
+      failed = 1;
+      break;
+    }
+
+    for (i=0; i<data->modelData->nNonLinearSystems; ++i)
+    {
+      if (nonlinsys[i].equationIndex == equationIndex && nonlinsys[i].size == size)
+      {
+        break;
+      }
+    }
+
+    if (i < data->modelData->nNonLinearSystems)
+    {
+      cleanValueList(nonlinsys[i].warmStartValues);
+      failed = readValueList(pFile, nonlinsys[i].warmStartValues);
+      found++;
+    }
+    else
+    {
+      /* skip values of an unknown system */
+      if (1 != fread(&length, sizeof(unsigned int), 1, pFile) ||
+          0 != fseek(pFile, (long)length*(size+1)*sizeof(double), SEEK_CUR))
+      {
+        failed = 1;
+      }
+    }
+  }
+
+  if (failed)
+  {
+    warningStreamPrint(LOG_STDOUT, 0, "Failed to read warm start values for non-linear systems from file %s.", fileName);
+  }
+  infoStreamPrint(LOG_NLS, 0, "read warm start values of %d non-linear systems from file %s", found, fileName);
+  fclose(pFile);
+}
+
+/*! \fn writeNlsWarmStart
+ *
+ *  This function writes the solutions recorded during this run. Systems
+ *  without any solution keep the values of the previous run.
+ *
+ *  \param [in]  [data]
+ *  \param [in]  [fileName] file given with -nlsWarmStart
+ */
+void writeNlsWarmStart(DATA *data, const char *fileName)
+{
+  NONLINEAR_SYSTEM_DATA* nonlinsys = data->simulationInfo->nonlinearSystemData;
+  FILE *pFile = omc_fopen(fileName, "wb");
+  long i;
+  modelica_integer nSystems = data->modelData->nNonLinearSystems;
+  int failed = 0;
+
+  if (pFile == NULL)
+  {
+    warningStreamPrint(LOG_STDOUT, 0, "Failed to open file %s for warm start values of non-linear systems.", fileName);
+    return;
+  }
+
+  failed = 1 != fwrite(NLS_WARM_START_MAGIC, 8, 1, pFile) ||
+           1 != fwrite(&nSystems, sizeof(modelica_integer), 1, pFile);
+
+  for (i=0; i<nSystems && !failed; ++i)
+  {
+    failed = 1 != fwrite(&nonlinsys[i].equationIndex, sizeof(modelica_integer), 1, pFile) ||
+             1 != fwrite(&nonlinsys[i].size, sizeof(modelica_integer), 1, pFile) ||
+             writeValueList(pFile, nonlinsys[i].recordedValues->length > 0 ? nonlinsys[i].recordedValues : nonlinsys[i].warmStartValues);
+  }
+
+  if (failed)
+  {
+    warningStreamPrint(LOG_STDOUT, 0, "Failed to write warm start values for non-linear systems to file %s.", fileName);
+  }
+  fclose(pFile);
+}
+#endif
+
 /*! \fn updateInnerEquation
  *
  *  This function updates inner equation with the current x.
@@ -1516,7 +1677,7 @@ void cleanUpOldValueListAfterEvent(DATA *data, double time)
   NONLINEAR_SYSTEM_DATA* nonlinsys = data->simulationInfo->nonlinearSystemData;
 
   for(i=0; i<data->modelData->nNonLinearSystems; ++i) {
-    cleanValueListbyTime(nonlinsys[i].oldValueList->valueList, time);
+    cleanValueListbyTime(nonlinsys[i].oldValueList, time);
   }
 }
 
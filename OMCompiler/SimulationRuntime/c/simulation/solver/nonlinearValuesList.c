@@ -29,359 +29,389 @@
 *
 */
 
-/*! \file nonlinearValuesList.h
+/*! \file nonlinearValuesList.c
  * Description: This is a C implementation of a value database
- *              based on a list. It's purpose is to be used by a
- *              a non-linear solver in OpenModelica in order to
- *              guess next value by extrapolation or interpolation.
- *              Assuming time passes forward.
+ *              based on a ring of contiguous value blocks. It's
+ *              purpose is to be used by a non-linear solver in
+ *              OpenModelica in order to guess next value by
+ *              extrapolation or interpolation.
+ *              The elements are kept sorted by time, so the
+ *              elements around a time are found by bisection.
  *
  */
 
 #include "epsilon.h"
 #include "nonlinearValuesList.h"
 
-#include "../../util/list.h"
 #include "../../util/omc_error.h"
 
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 
-#define UNUSED(x) (void)(x)
-
 /* Forward extrapolate function definition */
 double extrapolateValues(const double, const double, const double, const double, const double);
-void* valueListAlloc(const void* data);
-void valueListFree(void* data);
-void valueListCopy(void* dest, const void* src);
 
 /**
- * @brief Allocate value lists.
- *
- * @param numberOfList    Number of lists to allocate.
- * @param valueSize       Length of array double* values
- * @return VALUES_LIST*   Array of value lists.
+ * @brief Ring position of element i, element 0 is the oldest.
  */
-VALUES_LIST* allocValueList(unsigned int numberOfList, unsigned int valueSize)
+static inline unsigned int valuePos(const VALUES_LIST* valueList, unsigned int i)
 {
-  unsigned int i = 0;
-  VALUES_LIST* valueList = (VALUES_LIST*) malloc(numberOfList*sizeof(VALUES_LIST));
+  return (valueList->first + i) % valueList->capacity;
+}
 
-  for(i=0; i<numberOfList; i++) {
-    valueList[i].valueList = allocList(valueListAlloc, valueListFree, valueListCopy);
-  }
+static inline double valueTime(const VALUES_LIST* valueList, unsigned int i)
+{
+  return valueList->time[valuePos(valueList, i)];
+}
 
-  return valueList;
+static inline double* valueBlock(const VALUES_LIST* valueList, unsigned int i)
+{
+  return valueList->values + (size_t)valuePos(valueList, i)*valueList->size;
 }
 
 /**
- * @brief Free array of value lists.
+ * @brief Find the first element with time not smaller than time.
  *
- * @param valueList       Array of value lists.
- * @param numberOfList    Length of array valueList.
+ * @param valueList       Value list.
+ * @param time            Time to search for.
+ * @return unsigned int   Index of the element, length if all elements are older.
  */
-void freeValueList(VALUES_LIST* valueList, unsigned int numberOfList)
+static unsigned int lowerBound(const VALUES_LIST* valueList, double time)
 {
-  unsigned int i = 0;
-
-  for(i=0; i<numberOfList; i++) {
-    freeList(valueList[i].valueList);
+  unsigned int lo = 0, hi = valueList->length, mid;
+
+  while (lo < hi) {
+    mid = lo + (hi - lo)/2;
+    if (valueTime(valueList, mid) < time) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
   }
-  free(valueList);
+  return lo;
 }
 
 /**
- * @brief Removes all nodes after startNode from valueList.
- *        If startNode = NULL then clear the whole list.
- *
- * @param valueList    Pointer to value list
- * @param startNode    Pointer to list node, following nodes will be deleted
+ * @brief Copy time and values into element i.
  */
-void cleanValueList(LIST* valueList, LIST_NODE *startNode)
+static void setElement(VALUES_LIST* valueList, unsigned int i, double time, const double* values)
 {
-  int len;
-  if(startNode)
+  valueList->time[valuePos(valueList, i)] = time;
+  memcpy(valueBlock(valueList, i), values, valueList->size*sizeof(double));
+}
+
+static void printValueElement(const VALUES_LIST* valueList, unsigned int i)
+{
+  /* debug output */
+  if(ACTIVE_STREAM(LOG_NLS_EXTRAPOLATE))
   {
-    listClearAfterNode(valueList, startNode);
+    unsigned int j;
+    const double* values = valueBlock(valueList, i);
+    infoStreamPrint(LOG_NLS_EXTRAPOLATE, 1, "Element(size %d) at time %g ", valueList->size, valueTime(valueList, i));
+    for(j = 0; j < valueList->size; j++) {
+      infoStreamPrint(LOG_NLS_EXTRAPOLATE, 0, " oldValues[%d] = %g", j, values[j]);
+    }
+    messageClose(LOG_NLS_EXTRAPOLATE);
   }
-  else listClear(valueList);
 }
 
 /**
- * @brief Removes all nodes except the one just before or at time.
+ * @brief Allocate value list.
  *
- * @param valueList    Pointer to value list
- * @param time         time
+ * @param capacity        Maximal number of elements.
+ * @param valueSize       Length of the values of one element.
+ * @return VALUES_LIST*   Empty value list.
  */
-void cleanValueListbyTime(LIST *valueList, double time)
+VALUES_LIST* allocValueList(unsigned int capacity, unsigned int valueSize)
 {
-  LIST_NODE *next, *it;
-  VALUE* elem;
+  VALUES_LIST* valueList = (VALUES_LIST*) malloc(sizeof(VALUES_LIST));
+  assertStreamPrint(NULL, valueList != NULL, "allocValueList: Out of memory");
+
+  valueList->capacity = capacity > 0 ? capacity : 1;
+  valueList->size = valueSize;
+  valueList->first = 0;
+  valueList->length = 0;
+  valueList->minSpacing = 0.0;
+  valueList->time = (double*) malloc(valueList->capacity*sizeof(double));
+  valueList->values = (double*) malloc((size_t)valueList->capacity*valueSize*sizeof(double));
+  assertStreamPrint(NULL, valueList->time != NULL && (valueList->values != NULL || valueSize == 0), "allocValueList: Out of memory");
 
-  printValuesListTimes(valueList);
-  // need to get first node at each iteration since head is removed
-  for(it = listFirstNode(valueList); it; it = listFirstNode(valueList))
-  {
-    assert(it != NULL);
-    elem = (VALUE*)listNodeData(it);
-    if (elem->time <= time)
-    {
-      cleanValueList(valueList, it);
-      infoStreamPrint(LOG_NLS_EXTRAPOLATE, 0, "New list length %d: ", listLen(valueList));
-      printValuesListTimes(valueList);
-      infoStreamPrint(LOG_NLS_EXTRAPOLATE, 0, "Done!");
-      break;
-    }
-    /* debug output */
-    infoStreamPrint(LOG_NLS_EXTRAPOLATE, 0, "cleanValueListbyTime %g check element: ", time);
-    printValueElement(elem);
+  return valueList;
+}
 
-    listRemoveFront(valueList);
+/**
+ * @brief Free value list allocated with allocValueList.
+ *
+ * @param valueList       Value list, can be NULL.
+ */
+void freeValueList(VALUES_LIST* valueList)
+{
+  if (!valueList) {
+    return;
   }
+  free(valueList->time);
+  free(valueList->values);
+  free(valueList);
 }
 
 /**
- * @brief Create new value element for value list.
+ * @brief Removes all elements from valueList.
  *
- * @param size      Length of values array.
- * @param time      Time
- * @param values    Array of values
+ * @param valueList    Pointer to value list
  */
-VALUE* createValueElement(unsigned int size, double time, double* values)
+void cleanValueList(VALUES_LIST* valueList)
 {
-  VALUE* elem = calloc(1, sizeof(VALUE));
-  elem->values = calloc(size, sizeof(double));
-  elem->time = time;
-  elem->size = size;
-
-  memcpy(elem->values, values, size*sizeof(double));
-
-  /* debug output */
-  infoStreamPrint(LOG_NLS_EXTRAPOLATE, 0, "Create Element");
-
-  return elem;
+  valueList->first = 0;
+  valueList->length = 0;
+  valueList->minSpacing = 0.0;
 }
 
 /**
- * @brief Free value element allocated with createValueElement
+ * @brief Removes all elements except the one just before or at time.
  *
- * @param elem    Value element to free.
+ * @param valueList    Pointer to value list
+ * @param time         time
  */
-void freeValue(VALUE* elem)
+void cleanValueListbyTime(VALUES_LIST* valueList, double time)
 {
-  free(elem->values);
-  free(elem);
+  unsigned int i;
+
+  printValuesListTimes(valueList);
+  /* number of elements at or before time */
+  i = lowerBound(valueList, nextafter(time, INFINITY));
+  if (i == 0) {
+    cleanValueList(valueList);
+  } else {
+    valueList->first = valuePos(valueList, i-1);
+    valueList->length = 1;
+  }
+  infoStreamPrint(LOG_NLS_EXTRAPOLATE, 0, "New list length %d: ", valueList->length);
 }
 
 /**
  * @brief Adds copy of new element to list.
  *
- * @param valuesList    List
- * @param newElem       New element to add to list.
+ * An element with the same time is replaced. If the list is full the
+ * oldest element is dropped, so the usual case of increasing time
+ * costs one copy of the values.
+ *
+ * @param valueList     List
+ * @param time          Time of the new element.
+ * @param values        Values of the new element.
  */
-void addListElement(LIST* valuesList, VALUE* newElem)
+void addListElement(VALUES_LIST* valueList, double time, const double* values)
 {
-  LIST_NODE *node, *next;
-  VALUE* elem;
-  int replace = 0, i = 0;
+  unsigned int i, j;
 
   /* debug output */
-  infoStreamPrint(LOG_NLS_EXTRAPOLATE, 1, "Adding element in a list of size %d", listLen(valuesList));
-  printValueElement(newElem);
+  infoStreamPrint(LOG_NLS_EXTRAPOLATE, 0, "Adding element at time %g in a list of size %d", time, valueList->length);
 
-  /*  if it's empty, just push it in */
-  if (listLen(valuesList) == 0)
-  {
-    infoStreamPrint(LOG_NLS_EXTRAPOLATE, 0, "List is empty add new element.");
-    listPushFront(valuesList, (void*) newElem);
+  i = lowerBound(valueList, time - MINIMAL_STEP_SIZE);
 
-    messageClose(LOG_NLS_EXTRAPOLATE);
+  /* replace element with the same time */
+  if (i < valueList->length && fabs(valueTime(valueList, i) - time) <= MINIMAL_STEP_SIZE) {
+    setElement(valueList, i, time, values);
     return;
   }
 
-  /*  if the element at begin is earlier than current
-   *  push the element just in front and if the end element
-   *  is later than current push it just back.*/
-  node = listFirstNode(valuesList);
-  if ( fabs( ((VALUE*)listNodeData(node))->time - newElem->time ) > MINIMAL_STEP_SIZE )
-  {
-    infoStreamPrint(LOG_NLS_EXTRAPOLATE, 0, "First Value list element is:");
-    printValueElement(((VALUE*)listNodeData(node)));
-    infoStreamPrint(LOG_NLS_EXTRAPOLATE, 0, "so new element is added before.");
-    listPushFront(valuesList, (void*) newElem);
-
-    messageClose(LOG_NLS_EXTRAPOLATE);
-    return;
-  }
-
-  infoStreamPrint(LOG_NLS_EXTRAPOLATE, 0, "Search position of new element");
-  /* search correct position */
-  next = node;
-  do
-  {
-    /*  if next node is empty */
-    if (!next)
-    {
-      infoStreamPrint(LOG_NLS_EXTRAPOLATE, 0, "Search finished last element reached");
-      break;
+  if (valueList->length == valueList->capacity) {
+    /* a full list keeps the newest elements */
+    if (i == 0) {
+      return;
     }
+    valueList->first = valuePos(valueList, 1);
+    valueList->length--;
+    i--;
+  }
 
-    elem = ((VALUE*)listNodeData(next));
-
-    /* debug output */
-    infoStreamPrint(LOG_NLS_EXTRAPOLATE, 0, "Next node of list is element:");
-    printValueElement(elem);
+  /* move newer elements one position up */
+  for (j = valueList->length; j > i; j--) {
+    setElement(valueList, j, valueTime(valueList, j-1), valueBlock(valueList, j-1));
+  }
+  setElement(valueList, i, time, values);
+  valueList->length++;
+}
 
+/**
+ * @brief Records new element for the warm start of a later simulation.
+ *
+ * Only elements after the last recorded element are added. If the list
+ * is full every second element is dropped and the minimal distance of new
+ * elements is increased accordingly, so the recorded elements stay evenly
+ * distributed over the whole simulation. The newest element is replaced
+ * until the minimal distance is reached, so the end of the simulation is
+ * always covered.
+ *
+ * @param valueList     List
+ * @param time          Time of the new element.
+ * @param values        Values of the new element.
+ */
+void recordListElement(VALUES_LIST* valueList, double time, const double* values)
+{
+  unsigned int i, last;
 
-    if (fabs(elem->time - newElem->time)<=MINIMAL_STEP_SIZE)
-    {
-      replace = 1;
-      break;
+  if (valueList->length > 0) {
+    last = valueList->length - 1;
+    if (fabs(valueTime(valueList, last) - time) <= MINIMAL_STEP_SIZE) {
+      setElement(valueList, last, time, values);
+      return;
     }
-    else if (elem->time < newElem->time)
-    {
-      break;
+    if (time < valueTime(valueList, last)) {
+      return;
+    }
+    /* the newest element is kept until the next one is far enough away */
+    if (last > 0 && time < valueTime(valueList, last-1) + valueList->minSpacing) {
+      setElement(valueList, last, time, values);
+      return;
     }
-    node = next;
-    next = listNextNode(node);
-    i++; /* count insert or replace place */
-  }while(1);
-
-  /* add element before currect node */
-  if (!replace){
-    infoStreamPrint(LOG_NLS_EXTRAPOLATE, 0, "Insert element before last output element.");
-    listInsert(valuesList, node, (void*) newElem);
-  }
-  else
-  {
-    infoStreamPrint(LOG_NLS_EXTRAPOLATE, 0, "replace element.");
-    updateNodeData(valuesList, next, (void*) newElem);
   }
-  /*  clean list if too full */
-  if (i < 3 && listLen(valuesList)>10)
-  {
-    while(i < 4)
-    {
-      next = listNextNode(next);
-      i++;
+
+  if (valueList->length == valueList->capacity && valueList->length > 1) {
+    for (i = 1; 2*i < valueList->length; i++) {
+      setElement(valueList, i, valueTime(valueList, 2*i), valueBlock(valueList, 2*i));
     }
-    cleanValueList(valuesList, next);
+    valueList->length = i;
+    valueList->minSpacing = (valueTime(valueList, i-1) - valueTime(valueList, 0)) / (i > 1 ? i-1 : 1);
+  }
+  if (valueList->length == valueList->capacity) {
+    cleanValueList(valueList);
   }
 
-  messageClose(LOG_NLS_EXTRAPOLATE);
-  return;
+  setElement(valueList, valueList->length, time, values);
+  valueList->length++;
 }
 
 /**
  * @brief Gets extrapolated values for time from value list.
  *
- * @param valuesList            Pointer to value list
+ * @param valueList             Pointer to value list
  * @param time                  time
  * @param extrapolatedValues    values extrapolated (overwritten)
  * @param oldOutput             old values just before time
  */
-void getValues(LIST* valuesList, double time, double* extrapolatedValues, double* oldOutput)
+void getValues(VALUES_LIST* valueList, double time, double* extrapolatedValues, double* oldOutput)
 {
-  LIST_NODE *it;
-  LIST_NODE *old = NULL;
-  LIST_NODE *old2 = NULL;
-  VALUE *oldValues, *old2Values, *elem;
+  unsigned int i, j;
+  const double *oldValues, *old2Values;
 
-  infoStreamPrint(LOG_NLS_EXTRAPOLATE, 1, "Get values for time %g in a list of size %d", time, listLen(valuesList));
+  infoStreamPrint(LOG_NLS_EXTRAPOLATE, 1, "Get values for time %g in a list of size %d", time, valueList->length);
 
-  /* find corresponding values */
-  for(it = listFirstNode(valuesList); it; it = listNextNode(it))
-  {
-    elem = (VALUE*)listNodeData(it);
-    infoStreamPrint(LOG_NLS_EXTRAPOLATE, 0, "Searching current element:");
-    printValueElement(elem);
+  assertStreamPrint(NULL, valueList->length > 0, "getValues failed, no elements!");
 
-    old = it;
-    if(fabs(elem->time - time) <= MINIMAL_STEP_SIZE)
-    {
-      infoStreamPrint(LOG_NLS_EXTRAPOLATE, 0, "take element with the same time.");
-      break;
-    }
-    else if(elem->time < time)
-    {
-      old2 = listNextNode(old);
-      infoStreamPrint(LOG_NLS_EXTRAPOLATE, 0, "found element to use for extrapolation.");
-      break;
-    }
-  }
+  i = lowerBound(valueList, time - MINIMAL_STEP_SIZE);
 
-  /* if the list is empty old never gets set */
-  assertStreamPrint(NULL, NULL != old, "getValues failed, no elements!");
-
-  if(it == NULL)
+  if (i < valueList->length && fabs(valueTime(valueList, i) - time) <= MINIMAL_STEP_SIZE)
   {
-    infoStreamPrint(LOG_NLS_EXTRAPOLATE, 0, "reached end of list.");
+    infoStreamPrint(LOG_NLS_EXTRAPOLATE, 0, "take element with the same time.");
+    printValueElement(valueList, i);
+    memcpy(extrapolatedValues, valueBlock(valueList, i), valueList->size*sizeof(double));
+    memcpy(oldOutput, valueBlock(valueList, i), valueList->size*sizeof(double));
   }
-
-  /*  get next values */
-  if (old2 == NULL)
+  else if (i < 2)
   {
-    oldValues = (VALUE*) listNodeData(old);
-    memcpy(extrapolatedValues, oldValues->values, oldValues->size*sizeof(double));
-    memcpy(oldOutput, oldValues->values, oldValues->size*sizeof(double));
+    /* only one element before time or all elements after time */
+    i = (i == 0) ? 0 : i-1;
     infoStreamPrint(LOG_NLS_EXTRAPOLATE, 0, "take just old values.");
+    printValueElement(valueList, i);
+    memcpy(extrapolatedValues, valueBlock(valueList, i), valueList->size*sizeof(double));
+    memcpy(oldOutput, valueBlock(valueList, i), valueList->size*sizeof(double));
   }
   else
   {
-    int i;
-    oldValues = (VALUE*) listNodeData(old);
-    old2Values = (VALUE*) listNodeData(old2);
+    oldValues = valueBlock(valueList, i-1);
+    old2Values = valueBlock(valueList, i-2);
     infoStreamPrint(LOG_NLS_EXTRAPOLATE, 0, "Use following elements for calculation:");
-    printValueElement(oldValues);
-    printValueElement(old2Values);
-    for(i = 0; i < oldValues->size; ++i)
+    printValueElement(valueList, i-1);
+    printValueElement(valueList, i-2);
+    for(j = 0; j < valueList->size; ++j)
     {
-      extrapolatedValues[i] = extrapolateValues(time, oldValues->values[i], oldValues->time, old2Values->values[i], old2Values->time);
+      extrapolatedValues[j] = extrapolateValues(time, oldValues[j], valueTime(valueList, i-1), old2Values[j], valueTime(valueList, i-2));
     }
-    memcpy(oldOutput, oldValues->values, oldValues->size*sizeof(double));
+    memcpy(oldOutput, oldValues, valueList->size*sizeof(double));
   }
   messageClose(LOG_NLS_EXTRAPOLATE);
   return;
 }
 
-void printValueElement(VALUE* elem)
+/**
+ * @brief Write elements of value list to binary file.
+ *
+ * Writes the number of elements followed by time and values
+ * of every element, oldest first.
+ *
+ * @param file        File opened for binary writing.
+ * @param valueList   Value list.
+ * @return int        0 on success, 1 on write error.
+ */
+int writeValueList(FILE* file, const VALUES_LIST* valueList)
 {
-  /* debug output */
-  if(ACTIVE_STREAM(LOG_NLS_EXTRAPOLATE))
-  {
-    int i;
-    infoStreamPrint(LOG_NLS_EXTRAPOLATE, 1, "Element(size %d) at time %g ", elem->size, elem->time);
-    for(i = 0; i < elem->size; i++) {
-      infoStreamPrint(LOG_NLS_EXTRAPOLATE, 0, " oldValues[%d] = %g",i, elem->values[i]);
+  unsigned int i;
+  double time;
+
+  if (1 != fwrite(&valueList->length, sizeof(unsigned int), 1, file)) {
+    return 1;
+  }
+  for (i = 0; i < valueList->length; i++) {
+    time = valueTime(valueList, i);
+    if (1 != fwrite(&time, sizeof(double), 1, file) ||
+        valueList->size != fwrite(valueBlock(valueList, i), sizeof(double), valueList->size, file)) {
+      return 1;
     }
-    messageClose(LOG_NLS_EXTRAPOLATE);
   }
+  return 0;
 }
 
 /**
- * @brief Print function for printValuesListTimes
+ * @brief Read elements written with writeValueList.
+ *
+ * The elements are recorded with recordListElement, so a file with more
+ * elements than the capacity of valueList is thinned out.
  *
- * @param data      Data of node of type VALUE*
- * @param stream    Stream to output to.
- * @param unused    Unused
+ * @param file        File opened for binary reading.
+ * @param valueList   Value list with the same value size as the written one.
+ * @return int        0 on success, 1 on read error.
  */
-static void printElemTimes(void* data, int stream, void* unused) {
-  UNUSED(unused);
-  VALUE* elem = (VALUE*) data;
+int readValueList(FILE* file, VALUES_LIST* valueList)
+{
+  unsigned int i, length;
+  double time;
+  double* values = (double*) malloc(valueList->size*sizeof(double));
+  int ret = 0;
 
-  unsigned int i;
-  for(i=0; i<elem->size; i++) {
-    infoStreamPrint(stream, 0, "Element %d at time %g", i, elem->time);
+  assertStreamPrint(NULL, values != NULL, "readValueList: Out of memory");
+
+  if (1 != fread(&length, sizeof(unsigned int), 1, file)) {
+    ret = 1;
+    length = 0;
+  }
+  for (i = 0; i < length; i++) {
+    if (1 != fread(&time, sizeof(double), 1, file) ||
+        valueList->size != fread(values, sizeof(double), valueList->size, file)) {
+      ret = 1;
+      break;
+    }
+    recordListElement(valueList, time, values);
   }
+  free(values);
+  return ret;
 }
 
 /**
  * @brief Print value times of value list.
  *
- * @param list    Value list.
+ * @param valueList   Value list.
  */
-void printValuesListTimes(LIST* list) {
-  printList(list, LOG_NLS_EXTRAPOLATE, printElemTimes);
+void printValuesListTimes(VALUES_LIST* valueList)
+{
+  unsigned int i;
+
+  if(ACTIVE_STREAM(LOG_NLS_EXTRAPOLATE))
+  {
+    for(i = 0; i < valueList->length; i++) {
+      infoStreamPrint(LOG_NLS_EXTRAPOLATE, 0, "Element %d at time %g", i, valueTime(valueList, i));
+    }
+  }
 }
 
 /*! \fn extraPolateValues
@@ -408,44 +438,3 @@ double extrapolateValues(const double time, const double old1, const double time
 
   return retValue;
 }
-
-/**
- * @brief Allocate memory for valueList elements.
- *
- * @param data      value list element, containing size of array values
- *                  Has to be of type VALUE*;
- * @return void*    Allocated memory for LIST_NODE data.
- */
-void* valueListAlloc(const void* data) {
-  const VALUE* valueElem = (VALUE*) data;
-  VALUE* newElem = malloc(sizeof(VALUE));
-  assertStreamPrint(NULL, newElem != NULL, "valueListAlloc: Out of memory");
-  newElem->values = malloc(valueElem->size*sizeof(double));
-  assertStreamPrint(NULL, newElem->values != NULL, "valueListAlloc: Out of memory");
-  return (void*) newElem;
-}
-
-/**
- * @brief Free memory allocated with valueListAlloc.
- *
- * @param data      Void pointer, representing index for new list element.
- */
-void valueListFree(void* data) {
-  VALUE* valueElem = (VALUE*) data;
-  free(valueElem->values);
-  free(valueElem);
-}
-
-/**
- * @brief Copy data of valueList elements.
- *
- * @param dest    Void pointer of destination data, representing VALUE.
- * @param src     Void pointer of source data, representing VALUE.
- */
-void valueListCopy(void* dest, const void* src) {
-  VALUE* destValue = (VALUE*) dest;
-  VALUE* srcValue = (VALUE*) src;
-  destValue->size = srcValue->size;
-  destValue->time = srcValue->time;
-  memcpy(destValue->values, srcValue->values, srcValue->size*sizeof(double));
-}
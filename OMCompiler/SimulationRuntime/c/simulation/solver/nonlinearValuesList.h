@@ -37,31 +37,47 @@
 #ifndef _OMC_VALUE_LIST_H
 #define _OMC_VALUE_LIST_H
 
-#include "../../util/list.h"
+#include <stdio.h>
 
+/* number of old solutions used for extrapolation of the initial guess */
+#ifndef VALUES_LIST_CAPACITY
+#define VALUES_LIST_CAPACITY 16
+#endif
+
+/* number of recorded solutions per system for -nlsWarmStart */
+#ifndef WARM_START_CAPACITY
+#define WARM_START_CAPACITY 1024
+#endif
+
+/**
+ * @brief Fixed size ring of solutions sorted by time.
+ *
+ * The values of all elements are stored in one contiguous block,
+ * element i (0 is the oldest) is located at ring position (first+i)%capacity.
+ */
 typedef struct VALUES_LIST {
-  LIST* valueList;
+  unsigned int capacity;  /* maximal number of elements */
+  unsigned int size;      /* length of the values of one element */
+  unsigned int first;     /* ring position of the oldest element */
+  unsigned int length;    /* number of stored elements */
+  double minSpacing;      /* minimal time distance of recorded elements, see recordListElement */
+  double *time;           /* time of the elements, capacity entries */
+  double *values;         /* values of the elements, capacity*size entries */
 } VALUES_LIST;
 
-typedef struct VALUE {
-  double time;            /* Time value */
-  unsigned int size;      /* Length of array values */
-  double *values;         /* Array with values */
-} VALUE;
+VALUES_LIST* allocValueList(unsigned int capacity, unsigned int valueSize);
+void freeValueList(VALUES_LIST* valueList);
 
-VALUES_LIST* allocValueList(unsigned int numberOfList, unsigned int valueSize);
-void freeValueList(VALUES_LIST* valueList, unsigned int numberOfLists);
+void cleanValueList(VALUES_LIST* valueList);
+void cleanValueListbyTime(VALUES_LIST* valueList, double time);
 
-VALUE* createValueElement(unsigned int size, double time, double* values);
-void freeValue(VALUE* elem);
-void cleanValueList(LIST* valueList, LIST_NODE *startNode);
-void cleanValueListbyTime(LIST *valueList, double time);
-void removeListNodes(LIST* list, LIST_NODE *node);
+void addListElement(VALUES_LIST* valueList, double time, const double* values);
+void recordListElement(VALUES_LIST* valueList, double time, const double* values);
+void getValues(VALUES_LIST* valueList, double time, double* extrapolatedValues, double* oldOutput);
 
-void addListElement(LIST* valueList, VALUE* elem);
-void getValues(LIST* valueList, double time, double* values, double* oldOutput);
+int writeValueList(FILE* file, const VALUES_LIST* valueList);
+int readValueList(FILE* file, VALUES_LIST* valueList);
 
-void printValueElement(VALUE* elem);
-void printValuesListTimes(LIST* list);
+void printValuesListTimes(VALUES_LIST* valueList);
 
 #endif
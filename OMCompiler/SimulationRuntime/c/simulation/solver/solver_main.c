@@ -34,6 +34,9 @@
 #include "omc_config.h"
 #include "simulation/simulation_runtime.h"
 #include "simulation/results/simulation_result.h"
+#if !defined(OMC_MINIMAL_RUNTIME)
+#include "simulation/results/simulation_result_async.h"
+#endif
 #include "solver_main.h"
 #include "openmodelica_func.h"
 #include "initialization/initialization.h"
@@ -227,6 +230,8 @@ int initializeSolverData(DATA* data, threadData_t *threadData, SOLVER_INFO* solv
   solverInfo->sampleEvents = 0;
   resetSolverStats(&solverInfo->solverStats);
   resetSolverStats(&solverInfo->solverStatsTmp);
+  solverInfo->outputCallsBeforeRows = 0;
+  solverInfo->outputTimeBeforeRows = 0;
 
   /* if FLAG_NOEQUIDISTANT_GRID is set, choose integrator step method */
   if (omc_flag[FLAG_NOEQUIDISTANT_GRID])
@@ -582,6 +587,11 @@ int finishSimulation(DATA* data, threadData_t *threadData, SOLVER_INFO* solverIn
     writeOutputVars(strdup(outputVariablesAtEnd), data);
   }
 
+#if !defined(OMC_MINIMAL_RUNTIME)
+  /* the output thread uses the timers as well */
+  syncAsyncResult(&sim_result, threadData);
+#endif
+
   if(ACTIVE_STREAM(LOG_STATS))
   {
     rt_accumulate(SIM_TIMER_TOTAL);
@@ -598,6 +608,11 @@ int finishSimulation(DATA* data, threadData_t *threadData, SOLVER_INFO* solverIn
     infoStreamPrint(LOG_STATS, 0, "%12gs [%5.1f%%] steps", rt_accumulated(SIM_TIMER_STEP), rt_accumulated(SIM_TIMER_STEP)/total100);
     infoStreamPrint(LOG_STATS, 0, "%12gs [%5.1f%%] solver (excl. callbacks)", rt_accumulated(SIM_TIMER_SOLVER), rt_accumulated(SIM_TIMER_SOLVER)/total100);
     infoStreamPrint(LOG_STATS, 0, "%12gs [%5.1f%%] creating output-file", rt_accumulated(SIM_TIMER_OUTPUT), rt_accumulated(SIM_TIMER_OUTPUT)/total100);
+    if (rt_ncall(SIM_TIMER_OUTPUT) > solverInfo->outputCallsBeforeRows)
+    {
+      unsigned int rows = rt_ncall(SIM_TIMER_OUTPUT) - solverInfo->outputCallsBeforeRows;
+      infoStreamPrint(LOG_STATS, 0, "%12gs          per output point (%u points)", (rt_accumulated(SIM_TIMER_OUTPUT) - solverInfo->outputTimeBeforeRows)/rows, rows);
+    }
     infoStreamPrint(LOG_STATS, 0, "%12gs [%5.1f%%] event-handling", rt_accumulated(SIM_TIMER_EVENT), rt_accumulated(SIM_TIMER_EVENT)/total100);
     infoStreamPrint(LOG_STATS, 0, "%12gs [%5.1f%%] overhead", rt_accumulated(SIM_TIMER_OVERHEAD), rt_accumulated(SIM_TIMER_OVERHEAD)/total100);
 
@@ -610,6 +625,9 @@ int finishSimulation(DATA* data, threadData_t *threadData, SOLVER_INFO* solverIn
     infoStreamPrint(LOG_STATS, 1, "events");
     infoStreamPrint(LOG_STATS, 0, "%5ld state events", solverInfo->stateEvents);
     infoStreamPrint(LOG_STATS, 0, "%5ld time events", solverInfo->sampleEvents);
+    if (data->simulationInfo->callStatistics.rootFindingEvents > 0)
+      infoStreamPrint(LOG_STATS, 0, "%5ld root finding iterations (%.1f per located event)", data->simulationInfo->callStatistics.rootFindingIterations,
+                      (double) data->simulationInfo->callStatistics.rootFindingIterations / data->simulationInfo->callStatistics.rootFindingEvents);
     messageClose(LOG_STATS);
 
     if(S_OPTIMIZATION == solverInfo->solverMethod || /* skip solver statistics for optimization */
@@ -783,6 +801,8 @@ int solver_main(DATA* data, threadData_t *threadData, const char* init_initMetho
   if (0 == retVal){
     retVal = initializeModel(data, threadData, init_initMethod, init_file, init_time);
     omc_alloc_interface.collect_a_little();
+    solverInfo.outputCallsBeforeRows = rt_ncall(SIM_TIMER_OUTPUT);
+    solverInfo.outputTimeBeforeRows = rt_accumulated(SIM_TIMER_OUTPUT);
   }
 
 #if !defined(OMC_MINIMAL_RUNTIME)
@@ -80,6 +80,8 @@ typedef struct SOLVER_INFO
   /* integrator stats */
   SOLVERSTATS solverStats;            /* Statistic for integrator */
   SOLVERSTATS solverStatsTmp;         /* tmp solver stats to update solverStats with */
+  unsigned int outputCallsBeforeRows; /* output timer calls and time spent before the first row, i.e. opening the */
+  double outputTimeBeforeRows;        /* result file and writing the parameters; excluded from the per row stats */
 
   /* further options */
   int integratorSteps;              /* 1 => stepSizeControl; 0 => equidistant grid */
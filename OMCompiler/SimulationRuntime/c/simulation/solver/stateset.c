@@ -32,6 +32,7 @@
 
 #include "stateset.h"
 #include "../../util/omc_error.h"
+#include "../jacobian_util.h"
 
 /*! \fn printStateSelectionInfo
  *
@@ -100,6 +101,7 @@ void initializeStateSetJacobians(DATA *data, threadData_t *threadData)
     {
       throwStreamPrint(threadData, "can not initialze Jacobians for dynamic state selection");
     }
+    set->coloredJacobian = allocColoredJacobian(jacobian, 1, TRUE);
   }
   initializeStateSetPivoting(data);
   TRACE_POP
@@ -166,6 +168,7 @@ void freeStateSetData(DATA *data)
      free(set->rowPivot);
      free(set->colPivot);
      free(set->J);
+     freeColoredJacobian(set->coloredJacobian);
   }
   TRACE_POP
 }
@@ -182,7 +185,7 @@ void freeStateSetData(DATA *data)
 static void getAnalyticalJacobianSet(DATA* data, threadData_t *threadData, unsigned int index)
 {
   TRACE_PUSH
-  unsigned int i, j, k, l, ii;
+  unsigned int i, j;
   unsigned int jacIndex = data->simulationInfo->stateSetData[index].jacobianIndex;
   ANALYTIC_JACOBIAN* jacobian = &(data->simulationInfo->analyticJacobians[jacIndex]);
 
@@ -197,45 +200,10 @@ static void getAnalyticalJacobianSet(DATA* data, threadData_t *threadData, unsig
   if (jacobian->constantEqns != NULL) {
     jacobian->constantEqns(data, threadData, jacobian, NULL);
   }
-  for(i=0; i < jacobian->sparsePattern->maxColors; i++)
-  {
-    for(ii=0; ii < jacobian->sizeCols; ii++)
-      if(jacobian->sparsePattern->colorCols[ii]-1 == i)
-        jacobian->seedVars[ii] = 1;
 
-/*
-    if(ACTIVE_STREAM(LOG_DSS_JAC))
-    {
-      infoStreamPrint(LOG_DSS_JAC, 1, "Caluculate one col:");
-      for(l=0; l < jacobian->sizeCols; l++)
-        infoStreamPrint(LOG_DSS_JAC, 0, "seed: data->simulationInfo->analyticJacobians[index].seedVars[%d]= %f", l, jacobian->seedVars[l]);
-      messageClose(LOG_DSS_JAC);
-    }
-*/
-    (data->simulationInfo->stateSetData[index].analyticalJacobianColumn)(data, threadData, jacobian, NULL);
-
-    for(j=0; j < jacobian->sizeCols; j++)
-    {
-      if(jacobian->seedVars[j] == 1)
-      {
-        ii = jacobian->sparsePattern->leadindex[j];
-
-        /* infoStreamPrint(LOG_DSS_JAC, 0, "take for %d -> %d\n", j, ii); */
-
-        while(ii < jacobian->sparsePattern->leadindex[j+1])
-        {
-          l  = jacobian->sparsePattern->index[ii];
-          k  = j*jacobian->sizeRows + l;
-          jac[k] = jacobian->resultVars[l];
-          /* infoStreamPrint(LOG_DSS_JAC, 0, "write %d. in jac[%d]-[%d, %d]=%f from col[%d]=%f", ii, k, l, j, jac[k], l, jacobian->resultVars[l]); */
-          ii++;
-        };
-      }
-    }
-    for(ii=0; ii < jacobian->sizeCols; ii++)
-      if(jacobian->sparsePattern->colorCols[ii]-1 == i)
-        jacobian->seedVars[ii] = 0;
-  }
+  evalColoredJacobian(data, threadData, data->simulationInfo->stateSetData[index].coloredJacobian,
+                      data->simulationInfo->stateSetData[index].analyticalJacobianColumn,
+                      jac, &setJacElementDense);
 
   if(ACTIVE_STREAM(LOG_DSS_JAC))
   {
@@ -110,6 +110,13 @@ typedef struct CHATTERING_INFO
   int messageEmitted;
 } CHATTERING_INFO;
 
+/* Search state of a delay ring buffer, indices are relative to its first element */
+typedef struct DELAY_CURSOR
+{
+  int lastPosition;  /* row found by the last time lookup, start of the next search */
+  int firstEvent;    /* first row with the same time as its predecessor, -1 if there is none */
+} DELAY_CURSOR;
+
 typedef struct CALL_STATISTICS
 {
   long functionODE;
@@ -118,6 +125,8 @@ typedef struct CALL_STATISTICS
   long functionZeroCrossings;
   long functionEvalDAE;
   long functionAlgebraics;
+  long rootFindingEvents;       /* events located by the bisection of the runtime */
+  long rootFindingIterations;   /* bisection steps needed for them */
 } CALL_STATISTICS;
 
 typedef enum
@@ -352,6 +361,8 @@ typedef struct NONLINEAR_SYSTEM_DATA
   modelica_real *nlsxExtrapolation;    /* extrapolated values for x from old and old2 - used as initial guess */
 
   VALUES_LIST *oldValueList;           /* old values organized in a sorted list for extrapolation and interpolate, respectively */
+  VALUES_LIST *warmStartValues;        /* solutions of a previous run read with -nlsWarmStart, NULL if not used */
+  VALUES_LIST *recordedValues;         /* solutions of this run written with -nlsWarmStart, NULL if not used */
   modelica_real *resValues;            /* memory space for evaluated residual values */
 
   NLS_SOLVER_STATUS solved;            /* Specifiex if the NLS could be solved (with less accuracy) or failed */
@@ -388,10 +399,15 @@ typedef struct LINEAR_SYSTEM_THREAD_DATA
   ANALYTIC_JACOBIAN* parentJacobian;   /* if != NULL then it's the parent jacobian matrix */
   ANALYTIC_JACOBIAN* jacobian;         /* jacobian */
 
+  modelica_real *factorizedA;          /* values of matrix A at the last factorization, see reuseLinearSystemFactorization */
+  size_t sizeFactorizedA;              /* number of values in factorizedA, 0 if no factorization is stored */
+
   /* Statistics for each thread */
   unsigned long numberOfCall;          /* number of solving calls of this system */
   unsigned long numberOfFailures;      /* number of times solving calls of this system failed */
   unsigned long numberOfJEval;         /* number of jacobian evaluations of this system */
+  unsigned long numberOfFactorizations;         /* number of LU factorizations of matrix A */
+  unsigned long numberOfFactorizationsAvoided;  /* number of solves reusing the previous factorization */
   double totalTime;                    /* save the totalTime */
   rtclock_t totalTimeClock;            /* time clock for the totalTime */
   double jacobianTime;                 /* save the time to calculate jacobians */
@@ -501,6 +517,7 @@ typedef struct STATE_SET_DATA
   analyticalJacobianColumn_func_ptr analyticalJacobianColumn;
   int (*initialAnalyticalJacobian)(DATA* data, threadData_t* threadData, ANALYTIC_JACOBIAN* jacobian);
   modelica_integer jacobianIndex;
+  struct COLORED_JACOBIAN* coloredJacobian;  /* colored evaluation of analytic Jacobian, see jacobian_util.h */
 } STATE_SET_DATA;
 #else
 typedef void* STATE_SET_DATA;
@@ -752,14 +769,14 @@ typedef struct SIMULATION_INFO
 
   modelica_real* zeroCrossings;
   modelica_real* zeroCrossingsPre;
-  modelica_real* zeroCrossingsBackup;  /* used by bisection in event.c */
+  modelica_real* zeroCrossingsBackup;  /* zero crossings at the midpoint of a bisection step in event.c */
   modelica_boolean* relations;
   modelica_boolean* relationsPre;
   modelica_boolean* storedRelations;   /* this array contains a copy of relations each time the event iteration starts */
   modelica_real* mathEventsValuePre;
   long* zeroCrossingIndex;             /* := {0, 1, 2, ..., data->modelData->nZeroCrossings-1}; pointer for a list events at event instants */
-  modelica_real* states_left;          /* work array for findRoot in event.c */
-  modelica_real* states_right;         /* work array for findRoot in event.c */
+  modelica_real* states_left;          /* work array for findRoot in event.c, states followed by their derivatives */
+  modelica_real* states_right;         /* work array for findRoot in event.c, states followed by their derivatives */
 
   /* old vars for event handling */
   modelica_real timeValueOld;
@@ -807,6 +824,7 @@ typedef struct SIMULATION_INFO
 
   /* delay vars */
   RINGBUFFER **delayStructure;         /* Array of ring buffers for delay expressions */
+  DELAY_CURSOR *delayCursor;           /* Search state for each ring buffer in delayStructure */
   const char *OPENMODELICAHOME;
 
   CHATTERING_INFO chatteringInfo;
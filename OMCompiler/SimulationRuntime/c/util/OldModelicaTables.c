@@ -41,6 +41,7 @@
 #include "omc_msvc.h"
 #endif
 #include "omc_numbers.h"
+#include "read_csv.h"
 
 /* Definition to get some Debug information if interface is called */
 /* #define INFOS */
@@ -744,13 +745,13 @@ static void Mat_readTable(MAT_FILE *f, double *buf, size_t rows, size_t cols)
 
 /*
   CSV File implementation
+  The whole file is read (or mapped) once using the csv reader of the runtime.
 */
 typedef struct CSV_FILE
 {
-  FILE *fp;
+  struct csv_buffer buffer;
   char *filename;
-  long int data;
-  size_t line;
+  size_t data; /* offset of the first row of the table found by csv_findTable */
 } CSV_FILE;
 
 static CSV_FILE *csv_open(const char *filename)
@@ -761,21 +762,12 @@ static CSV_FILE *csv_open(const char *filename)
   }
   else
   {
-    size_t l = strlen(filename);
-    f->filename = (char*)malloc((l+1)*sizeof(char));
+    f->filename = strdup(filename);
     if (!f->filename) {
       ModelicaFormatError("Not enough memory for Filename %s",filename);
     }
-    else
-    {
-      size_t i;
-      for(i=0;i<=l;i++) {
-        f->filename[i] = filename[i];
-      }
-      f->fp = omc_fopen(filename,"r");
-      if (!f->fp) {
-        ModelicaFormatError("Cannot open File %s",filename);
-      }
+    else if (read_csv_buffer(filename, &f->buffer)) {
+      ModelicaFormatError("Cannot open File %s",filename);
     }
   }
   return f;
@@ -787,151 +779,93 @@ static void csv_close(CSV_FILE *f)
   {
     if(f->filename)
       free(f->filename);
-    fclose(f->fp);
+    free_csv_buffer(&f->buffer);
     free(f);
   }
 }
 
-static size_t csv_readLine(CSV_FILE *f, char **data, size_t *size)
+/* Returns the end of the line starting at pos, excluding a trailing '\r' */
+static const char *csv_lineEnd(const char *pos, const char *end, const char **next)
 {
-  size_t col = 0;
-  size_t i = 0;
-  char *buf = *data;
-  memset(*data, 0, sizeof(char)*(*size));
-
-  /* read whole line */
-  while(!feof(f->fp))
-  {
-    int ch;
-    if(col >= *size)
-    {
-      size_t s = *size * 2 + 1024;
-      char *tmp = (char*)calloc(s, sizeof(char));
-      if (!tmp) {
-        ModelicaFormatError("Not enough memory for loading file %s",f->filename);
-      }
-      for(i = 0; i < *size; i++)
-        tmp[i] = buf[i];
-      if(buf)
-        free(buf);
-      *data = tmp;
-      buf = *data;
-      *size = s;
-    }
-    ch = fgetc(f->fp);
-    if(ferror(f->fp))
-    {
-      fclose(f->fp);
-      ModelicaFormatError("In file `%s': parsing error at line %lu and col %lu.", f->filename, (unsigned long)f->line, (unsigned long)col);
-    }
-    if(ch == '\n')
-      break;
-    buf[col] = ch;
-    col++;
-  }
-  return col;
+  const char *eol = (const char*)memchr(pos, '\n', end - pos);
+  if (!eol)
+    eol = end;
+  *next = eol < end ? eol + 1 : end;
+  if (eol > pos && eol[-1] == '\r')
+    eol--;
+  return eol;
 }
 
 static char csv_findTable(CSV_FILE *f, const char *tableName, size_t *cols, size_t *rows)
 {
-  char *strLn=0;
-  size_t buflen=0;
-  size_t i=0;
-  size_t _cols = 1;
-  char stop=0;
+  const char *pos = f->buffer.data;
+  const char *end = pos + f->buffer.size;
+  size_t nameLen = strlen(tableName);
   *cols=0;
   *rows=0;
-  while(!feof(f->fp))
+  while(pos < end)
   {
-    size_t col;
-    /* start new line, update counters */
-    ++f->line;
-    /* read whole line */
-    col = csv_readLine(f,&strLn,&buflen);
-
-    if(strcmp(strLn,tableName)==0)
+    const char *next;
+    const char *eol = csv_lineEnd(pos, end, &next);
+    if((size_t)(eol - pos) == nameLen && strncmp(pos,tableName,nameLen) == 0)
     {
-      f->data = ftell (f->fp);
-      if(ferror(f->fp))
-      {
-        perror ("The following error occurred");
-        ModelicaFormatError("Cannot get File Position! from File %s",f->filename);
-      }
-      while(!feof(f->fp) && (stop==0))
+      f->data = next - f->buffer.data;
+      /* the table ends at the first line that is empty or not a list of numbers */
+      for(pos = next; pos < end; pos = next)
       {
-        col = csv_readLine(f,&strLn,&buflen);
-        for(i = 0; i<buflen;i++)
+        size_t _cols = 1;
+        const char *c;
+        eol = csv_lineEnd(pos, end, &next);
+        if(eol == pos)
+          break;
+        for(c = pos; c < eol; c++)
         {
-          if(strLn[i]== ',')
-          {
+          if(*c == ',')
             _cols++;
-            continue;
-          }
-          if(strLn[i]== 0)
+          else if(!isdigit((unsigned char)*c) && !strchr(".eE+- \t", *c))
             break;
-          if(isdigit(strLn[i]) == 0)
-          {
-            if(strLn[i] != 'e')
-              if(strLn[i] != 'E')
-                if(strLn[i] != '+')
-                  if(strLn[i] != '-')
-                    stop = 1;
-          }
         }
+        if(c < eol)
+          break;
         (*rows)++;
-        *cols = fmax(_cols,*cols);
-        _cols = 1;
+        *cols = _cols > *cols ? _cols : *cols;
       }
-      if(strLn)
-        free(strLn);
       return 1;
     }
+    pos = next;
   }
-  if(strLn)
-    free(strLn);
   return 0;
 }
 
-static void csv_readTable(CSV_FILE *f, const char *tableName, double *data, size_t rows, size_t cols)
+static void csv_readTable(CSV_FILE *f, double *data, size_t rows, size_t cols)
 __attribute__((nonnull));
 
-static void csv_readTable(CSV_FILE *f, const char *tableName, double *data, size_t rows, size_t cols)
+static void csv_readTable(CSV_FILE *f, double *data, size_t rows, size_t cols)
 {
-  char *strLn=NULL;
-  size_t buflen=0;
-  size_t row=0;
-  size_t lh=0;
-  char *number=NULL;
-  char *entp=NULL;
-  fseek ( f->fp , 0 , SEEK_SET );
-  /* WHY DOES THIS NOT WORK
-  if(fseek ( f->fp , f->data , SEEK_CUR ))
+  const char *pos = f->buffer.data + f->data;
+  const char *end = f->buffer.data + f->buffer.size;
+  size_t row, col;
+  for(row=0;row<rows && pos<end;row++)
   {
-    throwStreamPrint("Cannot set File Position! from File %s, no data is readed",f->filename);
-  }
-  */
-  while(!feof(f->fp))
-  {
-    size_t col = csv_readLine(f,&strLn,&buflen);
-
-    if(strcmp(strLn,tableName)==0)
+    const char *next;
+    const char *eol = csv_lineEnd(pos, end, &next);
+    /* missing cells keep the value 0 */
+    for(col=0;col<cols && pos<eol;col++)
     {
-      for(row=0;row<rows;row++)
+      char *entp = NULL;
+      while(pos < eol && (*pos == ' ' || *pos == '\t'))
+        pos++;
+      if(pos < eol && *pos != ',')
       {
-        size_t c = csv_readLine(f,&strLn,&buflen);
-        number = strLn;
-        for(col=0;col<cols;col++)
-        {
-          data[row*cols+col] = om_strtod(number,&entp);
-          trim((const char**)&entp,&lh);
-          number = entp+1;
-        }
+        data[row*cols+col] = om_strtod(pos,&entp);
+        pos = entp > pos ? entp : pos + 1;
       }
-      break;
+      while(pos < eol && *pos != ',')
+        pos++;
+      pos++;
     }
+    pos = next;
   }
-  if(strLn)
-    free(strLn);
 }
 
 /*
@@ -959,7 +893,7 @@ static void openFile(const char *filename, const char* tableName, size_t *rows,
       if (!*data) {
         ModelicaFormatError("Not enough memory for Table: %s",tableName);
       }
-      csv_readTable(f,tableName,*data,*rows,*cols);
+      csv_readTable(f,*data,*rows,*cols);
       csv_close(f);
       return;
     }
@@ -0,0 +1,162 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+#include "matrix_kernels.h"
+#include <string.h>
+
+#if defined(USE_BLAS)
+extern int dgemm_(char *transa, char *transb, int *m, int *n, int *k, double *alpha, double *a, int *lda,
+                  double *b, int *ldb, double *beta, double *c, int *ldc);
+extern int dgemv_(char *trans, int *m, int *n, double *alpha, double *a, int *lda, double *x, int *incx,
+                  double *beta, double *y, int *incy);
+#endif
+
+/* Block sizes of the matrix product: a block of B (BLOCK_K x BLOCK_N) stays in
+ * the L2 cache, BLOCK_K rows of it in L1 while a row of C is updated. */
+#define BLOCK_M 64
+#define BLOCK_N 256
+#define BLOCK_K 128
+
+static inline size_t min_size(size_t a, size_t b)
+{
+  return a < b ? a : b;
+}
+
+/* c[0:n] += a0*b0[0:n] + a1*b1[0:n] */
+static inline void axpy2(size_t n, double a0, const double *b0, double a1, const double *b1, double *c)
+{
+  size_t j;
+  for (j = 0; j < n; j++) {
+    c[j] += a0*b0[j] + a1*b1[j];
+  }
+}
+
+/* c[0:n] += a0*b0[0:n] */
+static inline void axpy1(size_t n, double a0, const double *b0, double *c)
+{
+  size_t j;
+  for (j = 0; j < n; j++) {
+    c[j] += a0*b0[j];
+  }
+}
+
+void omc_matrix_product(size_t m, size_t n, size_t k, const double *a, const double *b, double *c)
+{
+  size_t i0, j0, k0, i, l, nb, kb;
+
+#if defined(USE_BLAS)
+  if (m*n*k >= OMC_BLAS_GEMM_THRESHOLD) {
+    /* BLAS is column-major: C^T = B^T*A^T, where the row-major arrays are the transposed matrices */
+    char trans = 'N';
+    int im = (int) m, in = (int) n, ik = (int) k;
+    double one = 1.0, zero = 0.0;
+    dgemm_(&trans, &trans, &in, &im, &ik, &one, (double*) b, &in, (double*) a, &ik, &zero, c, &in);
+    return;
+  }
+#endif
+
+  memset(c, 0, m*n*sizeof(double));
+  for (k0 = 0; k0 < k; k0 += BLOCK_K) {
+    kb = min_size(BLOCK_K, k - k0);
+    for (i0 = 0; i0 < m; i0 += BLOCK_M) {
+      for (j0 = 0; j0 < n; j0 += BLOCK_N) {
+        nb = min_size(BLOCK_N, n - j0);
+        for (i = i0; i < min_size(i0 + BLOCK_M, m); i++) {
+          const double *arow = a + i*k + k0;
+          double *crow = c + i*n + j0;
+          const double *bblock = b + k0*n + j0;
+          /* two rows of B per pass halve the loads and stores of the row of C */
+          for (l = 0; l + 1 < kb; l += 2) {
+            axpy2(nb, arow[l], bblock + l*n, arow[l+1], bblock + (l+1)*n, crow);
+          }
+          if (l < kb) {
+            axpy1(nb, arow[l], bblock + l*n, crow);
+          }
+        }
+      }
+    }
+  }
+}
+
+void omc_matrix_vector_product(size_t m, size_t n, const double *a, const double *x, double *y)
+{
+  size_t i, j;
+
+#if defined(USE_BLAS)
+  if (m*n >= OMC_BLAS_GEMV_THRESHOLD) {
+    /* the row-major A is the column-major A^T */
+    char trans = 'T';
+    int im = (int) m, in = (int) n, inc = 1;
+    double one = 1.0, zero = 0.0;
+    dgemv_(&trans, &in, &im, &one, (double*) a, &in, (double*) x, &inc, &zero, y, &inc);
+    return;
+  }
+#endif
+
+  /* four independent sums per row break the dependency chain of the additions */
+  for (i = 0; i < m; i++) {
+    const double *arow = a + i*n;
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (j = 0; j + 3 < n; j += 4) {
+      s0 += arow[j]*x[j];
+      s1 += arow[j+1]*x[j+1];
+      s2 += arow[j+2]*x[j+2];
+      s3 += arow[j+3]*x[j+3];
+    }
+    for (; j < n; j++) {
+      s0 += arow[j]*x[j];
+    }
+    y[i] = (s0 + s1) + (s2 + s3);
+  }
+}
+
+void omc_vector_matrix_product(size_t m, size_t n, const double *x, const double *a, double *y)
+{
+  size_t i;
+
+#if defined(USE_BLAS)
+  if (m*n >= OMC_BLAS_GEMV_THRESHOLD) {
+    char trans = 'N';
+    int im = (int) m, in = (int) n, inc = 1;
+    double one = 1.0, zero = 0.0;
+    dgemv_(&trans, &in, &im, &one, (double*) a, &in, (double*) x, &inc, &zero, y, &inc);
+    return;
+  }
+#endif
+
+  /* y is updated with one row of A after the other, walking A in memory order */
+  memset(y, 0, n*sizeof(double));
+  for (i = 0; i + 1 < m; i += 2) {
+    axpy2(n, x[i], a + i*n, x[i+1], a + (i+1)*n, y);
+  }
+  if (i < m) {
+    axpy1(n, x[i], a + i*n, y);
+  }
+}
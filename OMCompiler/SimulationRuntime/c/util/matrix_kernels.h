@@ -0,0 +1,75 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+#ifndef _MATRIX_KERNELS_H_
+#define _MATRIX_KERNELS_H_
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Dense kernels for the real matrix operators of the array library.
+ * All matrices are stored row-major, the result must not overlap the operands.
+ * Small problems use cache-blocked loops whose innermost loop runs over
+ * contiguous memory, so the compiler can vectorize it. If the runtime is built
+ * with USE_BLAS, problems above a size threshold are passed to dgemm/dgemv.
+ */
+
+/* problems with at least this many multiply-adds are passed to BLAS */
+#ifndef OMC_BLAS_GEMM_THRESHOLD
+#define OMC_BLAS_GEMM_THRESHOLD (64*64*64)
+#endif
+#ifndef OMC_BLAS_GEMV_THRESHOLD
+#define OMC_BLAS_GEMV_THRESHOLD (128*128)
+#endif
+
+/**
+ * @brief C = A*B with A of size m x k, B of size k x n and C of size m x n.
+ */
+void omc_matrix_product(size_t m, size_t n, size_t k, const double *a, const double *b, double *c);
+
+/**
+ * @brief y = A*x with A of size m x n, x of size n and y of size m.
+ */
+void omc_matrix_vector_product(size_t m, size_t n, const double *a, const double *x, double *y);
+
+/**
+ * @brief y = x*A with x of size m, A of size m x n and y of size n.
+ */
+void omc_vector_matrix_product(size_t m, size_t n, const double *x, const double *a, double *y);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
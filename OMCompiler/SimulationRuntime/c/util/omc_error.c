@@ -401,6 +401,12 @@ void (*messageClose)(int stream) = messageCloseText;
  * See messageCloseTextWarning() for more info.
  */
 void (*messageCloseWarning)(int stream) = messageCloseTextWarning;
+/**
+ * @brief Deferred formatting of info messages.
+ * Set by a backend that stores the format and the arguments instead of the
+ * formatted message, e.g. the binary log. NULL formats every message.
+ */
+int (*messageDeferred)(int type, int stream, int indentNext, const int *indexes, const char *format, va_list args) = NULL;
 
 #define SIZE_LOG_BUFFER 2048
 
@@ -409,29 +415,41 @@ void va_infoStreamPrint(int stream, int indentNext, const char *format, va_list
 {
   if (useStream[stream]) {
     char logBuffer[SIZE_LOG_BUFFER];
+    if (messageDeferred && messageDeferred(LOG_TYPE_INFO, stream, indentNext, NULL, format, args)) {
+      return;
+    }
     vsnprintf(logBuffer, SIZE_LOG_BUFFER, format, args);
     messageFunction(LOG_TYPE_INFO, stream, omc_dummyFileInfo, indentNext, logBuffer, 0, NULL);
   }
 }
 
-void infoStreamPrintWithEquationIndexes(int stream, FILE_INFO info, int indentNext, const int *indexes, const char *format, ...)
+void (infoStreamPrintWithEquationIndexes)(int stream, FILE_INFO info, int indentNext, const int *indexes, const char *format, ...)
 {
   if (useStream[stream]) {
     char logBuffer[SIZE_LOG_BUFFER];
     va_list args;
     va_start(args, format);
+    if (messageDeferred && !(info.filename && *info.filename) &&
+        messageDeferred(LOG_TYPE_INFO, stream, indentNext, indexes, format, args)) {
+      va_end(args);
+      return;
+    }
     vsnprintf(logBuffer, SIZE_LOG_BUFFER, format, args);
     va_end(args);
     messageFunction(LOG_TYPE_INFO, stream, info, indentNext, logBuffer, 0, indexes);
   }
 }
 
-void infoStreamPrint(int stream, int indentNext, const char *format, ...)
+void (infoStreamPrint)(int stream, int indentNext, const char *format, ...)
 {
   if (useStream[stream]) {
     char logBuffer[SIZE_LOG_BUFFER];
     va_list args;
     va_start(args, format);
+    if (messageDeferred && messageDeferred(LOG_TYPE_INFO, stream, indentNext, NULL, format, args)) {
+      va_end(args);
+      return;
+    }
     vsnprintf(logBuffer, SIZE_LOG_BUFFER, format, args);
     va_end(args);
     messageFunction(LOG_TYPE_INFO, stream, omc_dummyFileInfo, indentNext, logBuffer, 0, NULL);
@@ -199,6 +199,14 @@ extern void warningStreamPrintWithLimit(int stream, int indentNext, unsigned lon
 extern void errorStreamPrint(int stream, int indentNext, const char *format, ...) __attribute__ ((format (printf, 3, 4)));
 extern void va_errorStreamPrint(int stream, int indentNext, const char *format, va_list ap);
 extern void va_errorStreamPrintWithEquationIndexes(int stream, FILE_INFO info, int indentNext, const int *indexes, const char *format,va_list ap);
+extern int (*messageDeferred)(int type, int stream, int indentNext, const int *indexes, const char *format, va_list args);
+
+/* Check the stream before the call, so messages of inactive streams
+ * cost neither the call nor the evaluation of their arguments. */
+#define infoStreamPrint(stream, indentNext, ...) \
+  (useStream[stream] ? (infoStreamPrint)((stream), (indentNext), __VA_ARGS__) : (void)0)
+#define infoStreamPrintWithEquationIndexes(stream, info, indentNext, indexes, ...) \
+  (useStream[stream] ? (infoStreamPrintWithEquationIndexes)((stream), (info), (indentNext), (indexes), __VA_ARGS__) : (void)0)
 #else
 static inline void infoStreamPrint(int stream, int indentNext, const char *format, ...) {}
 static inline void va_infoStreamPrint(int stream, int indentNext, const char *format, va_list ap) {}
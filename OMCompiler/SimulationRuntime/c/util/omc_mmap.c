@@ -89,6 +89,23 @@ omc_mmap_write_unix omc_mmap_open_write_unix(const char *fileName, size_t size)
   return res;
 }
 
+omc_mmap_read_unix omc_mmap_open_read_file_unix(FILE *file)
+{
+  struct stat s;
+  omc_mmap_read_unix res = {0};
+  int fd = file ? fileno(file) : -1;
+  if (fd < 0 || fstat(fd, &s) < 0 || s.st_size == 0) {
+    return res;
+  }
+  res.data = (const char*) mmap(0, s.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  if (res.data == MAP_FAILED) {
+    res.data = NULL;
+    return res;
+  }
+  res.size = s.st_size;
+  return res;
+}
+
 void omc_mmap_close_read_unix(omc_mmap_read_unix map)
 {
   munmap((void*)map.data, map.size);
@@ -93,6 +93,8 @@ omc_mmap_read_unix omc_mmap_open_read_unix(const char *filename);
 omc_mmap_write_unix omc_mmap_open_write_unix(const char *filename, size_t size);
 void omc_mmap_close_read_unix(omc_mmap_read_unix map);
 void omc_mmap_close_write_unix(omc_mmap_write_unix map);
+/* Maps an already opened file read-only. Does not throw; returns data == NULL on failure. */
+omc_mmap_read_unix omc_mmap_open_read_file_unix(FILE *file);
 
 typedef omc_mmap_read_unix omc_mmap_read;
 typedef omc_mmap_write_unix omc_mmap_write;
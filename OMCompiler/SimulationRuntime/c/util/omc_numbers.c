@@ -3,6 +3,7 @@
 #define _GNU_SOURCE 1
 
 #include <stdlib.h>
+#include <stdint.h>
 
 #if (defined(_MSC_VER) && _MSC_VER >= 1400)
 
@@ -20,7 +21,7 @@ _locale_t getCLocale()
   return loc;
 }
 
-double om_strtod(const char *nptr, char **endptr)
+static double om_strtod_locale(const char *nptr, char **endptr)
 {
   return _strtod_l(nptr, endptr, getCLocale());
 }
@@ -45,17 +46,110 @@ locale_t getCLocale()
   return loc;
 }
 
-double om_strtod(const char *nptr, char **endptr)
+static double om_strtod_locale(const char *nptr, char **endptr)
 {
   return strtod_l(nptr, endptr, getCLocale());
 }
 
 #else
 
-double om_strtod(const char *nptr, char **endptr)
+static double om_strtod_locale(const char *nptr, char **endptr)
 {
   /* Default to just assuming we have the correct locale */
   return strtod(nptr, endptr);
 }
 
 #endif
+
+/* Powers of ten that are exactly representable as double */
+static const double om_exact_powers_of_ten[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* Locale-independent strtod.
+ * Plain decimal numbers whose significant digits fit into 53 bits and whose
+ * decimal exponent is at most 22 are converted without calling into the C
+ * library: both the digits and the power of ten are exact doubles, so a
+ * single multiplication or division gives the correctly rounded result.
+ * Anything else (more digits, large exponents, inf, nan, hex, leading
+ * whitespace) is passed to strtod in the C locale.
+ */
+double om_strtod(const char *nptr, char **endptr)
+{
+  const char *p = nptr;
+  uint64_t mantissa = 0;
+  int digits = 0, fracDigits = 0, exponent = 0, negative = 0, anyDigit = 0;
+
+  if (*p == '-' || *p == '+') {
+    negative = *p == '-';
+    p++;
+  }
+  if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+    return om_strtod_locale(nptr, endptr);
+  }
+  while (*p == '0') {
+    p++;
+    anyDigit = 1;
+  }
+  while (*p >= '0' && *p <= '9') {
+    mantissa = mantissa * 10 + (*p - '0');
+    digits++;
+    p++;
+  }
+  if (*p == '.') {
+    p++;
+    if (digits == 0) {
+      while (*p == '0') {
+        p++;
+        fracDigits++;
+        anyDigit = 1;
+      }
+    }
+    while (*p >= '0' && *p <= '9') {
+      mantissa = mantissa * 10 + (*p - '0');
+      digits++;
+      fracDigits++;
+      p++;
+    }
+  }
+  if (!(anyDigit || digits) || digits > 19 || mantissa > ((uint64_t) 1 << 53)) {
+    return om_strtod_locale(nptr, endptr);
+  }
+  if (*p == 'e' || *p == 'E') {
+    const char *e = p + 1;
+    int expNegative = 0;
+    if (*e == '-' || *e == '+') {
+      expNegative = *e == '-';
+      e++;
+    }
+    if (*e >= '0' && *e <= '9') {
+      while (*e >= '0' && *e <= '9') {
+        if (exponent > 1000) {
+          return om_strtod_locale(nptr, endptr);
+        }
+        exponent = exponent * 10 + (*e - '0');
+        e++;
+      }
+      if (expNegative) {
+        exponent = -exponent;
+      }
+      p = e;
+    }
+  }
+  exponent -= fracDigits;
+  if (mantissa != 0 && (exponent < -22 || exponent > 22)) {
+    return om_strtod_locale(nptr, endptr);
+  }
+  if (endptr) {
+    *endptr = (char*) p;
+  }
+  if (mantissa == 0) {
+    return negative ? -0.0 : 0.0;
+  }
+  {
+    double value = (double) mantissa;
+    value = exponent < 0 ? value / om_exact_powers_of_ten[-exponent] : value * om_exact_powers_of_ten[exponent];
+    return negative ? -value : value;
+  }
+}
@@ -32,17 +32,11 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include "read_csv.h"
-#include "read_matlab4.h"
 #include "libcsv.h"
 #include "omc_file.h"
+#include "omc_mmap.h"
 #include "omc_numbers.h"
 
-struct cell_row_count
-{
-  int cell_count;
-  int row_count;
-};
-
 struct csv_head
 {
   char **variables;
@@ -51,21 +45,6 @@ struct csv_head
   int found_row;
 };
 
-struct csv_body
-{
-  double *res;
-  int size;
-  int buffer_size;
-  int found_first_row;
-  int cur_size;
-  int row_length;
-  int error;
-};
-
-static void do_nothing(void *data, size_t len, void *t)
-{
-}
-
 static void found_first_row(int c, void *t)
 {
   struct csv_head *head = (struct csv_head*) t;
@@ -85,51 +64,252 @@ static void add_variable(void *data, size_t len, void *t)
   head->variables[head->size++] = strdup(data ? (char*) data : "");
 }
 
-static void row_count(int c, void *t)
+int read_csv_buffer(const char *filename, struct csv_buffer *buffer)
 {
-  struct cell_row_count *s =  (struct cell_row_count *) t;
-  s->row_count++;
+  FILE *fin = omc_fopen(filename, "rb");
+  long size;
+  char *data;
+
+  buffer->data = NULL;
+  buffer->size = 0;
+  buffer->mapped = 0;
+  if (!fin) {
+    return 1;
+  }
+#if HAVE_MMAP
+  {
+    /* The parser relies on a non-numeric character after the last cell;
+     * files that do not end with a newline are read into memory instead */
+    omc_mmap_read_unix map = omc_mmap_open_read_file_unix(fin);
+    if (map.data && map.data[map.size-1] == '\n') {
+      fclose(fin);
+      buffer->data = map.data;
+      buffer->size = map.size;
+      buffer->mapped = 1;
+      return 0;
+    }
+    if (map.data) {
+      omc_mmap_close_read_unix(map);
+    }
+  }
+#endif
+  if (fseek(fin, 0, SEEK_END) || (size = ftell(fin)) < 0 || fseek(fin, 0, SEEK_SET)) {
+    fclose(fin);
+    return 1;
+  }
+  data = (char*) malloc(size + 1);
+  if (!data) {
+    fclose(fin);
+    return 1;
+  }
+  if (size > 0 && omc_fread(data, 1, size, fin, 0) != (size_t) size) {
+    free(data);
+    fclose(fin);
+    return 1;
+  }
+  fclose(fin);
+  data[size] = '\0';
+  buffer->data = data;
+  buffer->size = size;
+  return 0;
 }
 
-int read_csv_dataset_size(const char* filename)
+void free_csv_buffer(struct csv_buffer *buffer)
 {
-  const int buf_size = 4096;
-  char buf[4096];
-  FILE *f;
-  struct csv_parser p;
-  struct cell_row_count count = {0};
-  size_t offset=0;
-  unsigned char delim = CSV_COMMA;
-  f = omc_fopen(filename,"r");
-  if (f == NULL) {
-    return -1;
+#if HAVE_MMAP
+  if (buffer->mapped) {
+    omc_mmap_read_unix map;
+    map.data = buffer->data;
+    map.size = buffer->size;
+    omc_mmap_close_read_unix(map);
+  } else
+#endif
+  {
+    free((void*) buffer->data);
   }
+  buffer->data = NULL;
+  buffer->size = 0;
+  buffer->mapped = 0;
+}
 
-  /* determine delim */
-  omc_fread(buf, 1, 5, f, 0);
-  if (0 == strcmp(buf, "\"sep="))
-  {
-    omc_fread(&delim, 1, 1, f, 0);
-    offset = 8;
+/* Skips the optional "sep=;" line and returns the delimiter */
+static const char* skip_separator_line(const char *pos, const char *end, unsigned char *delim)
+{
+  *delim = CSV_COMMA;
+  if (end - pos >= 6 && 0 == strncmp(pos, "\"sep=", 5)) {
+    *delim = pos[5];
+    pos = (const char*) memchr(pos, '\n', end - pos);
+    return pos ? pos + 1 : end;
   }
-  fseek(f, offset, SEEK_SET);
+  return pos;
+}
 
-  csv_init(&p, CSV_STRICT | CSV_REPALL_NL | CSV_STRICT_FINI | CSV_APPEND_NULL | CSV_EMPTY_IS_NULL, delim);
-  csv_set_realloc_func(&p, realloc);
-  csv_set_free_func(&p, free);
-  do {
-    size_t len = omc_fread(buf, 1, buf_size, f, 1);
-    if (len != buf_size && !feof(f)) {
-      csv_free(&p);
-      fclose(f);
-      return -1;
+/* Reads the quoted or unquoted names of the header row. On return pos points
+ * to the first character after the header. */
+static char** read_header(const char **pos, const char *end, unsigned char delim, int *length)
+{
+  const char *p = *pos;
+  char **variables = NULL;
+  int size = 0, buffer_size = 0;
+
+  while (p < end) {
+    const char *start = p;
+    char *name;
+    size_t len = 0;
+    if (size >= buffer_size) {
+      buffer_size = buffer_size ? 2*buffer_size : 512;
+      variables = (char**) realloc(variables, sizeof(char*)*buffer_size);
     }
-    csv_parse(&p,buf,len,do_nothing,row_count,&count);
-  } while (!feof(f));
-  csv_fini(&p,do_nothing,row_count,&count);
-  csv_free(&p);
-  fclose(f);
-  return count.row_count - 1; /* The header is excluded */
+    if (*p == '"') {
+      /* the unescaped name is never longer than the quoted one */
+      const char *q = ++p;
+      while (q < end && !(*q == '"' && (q+1 == end || q[1] != '"'))) {
+        q += (*q == '"') ? 2 : 1;
+      }
+      name = (char*) malloc(q - p + 1);
+      while (p < q) {
+        name[len++] = *p;
+        p += (*p == '"') ? 2 : 1;
+      }
+      p = q < end ? q + 1 : end;
+      while (p < end && *p != delim && *p != '\n' && *p != '\r') {
+        p++;
+      }
+    } else {
+      while (p < end && *p != delim && *p != '\n' && *p != '\r') {
+        p++;
+      }
+      len = p - start;
+      name = (char*) malloc(len + 1);
+      memcpy(name, start, len);
+    }
+    name[len] = '\0';
+    variables[size++] = name;
+    if (p < end && *p == delim) {
+      p++;
+      continue;
+    }
+    break;
+  }
+  while (p < end && (*p == '\r' || *p == '\n')) {
+    p++;
+  }
+  *pos = p;
+  *length = size;
+  return variables;
+}
+
+/* Returns the start of every non-empty line between pos and end */
+static size_t* index_rows(const char *pos, const char *end, int *numrows)
+{
+  size_t *rows = NULL;
+  int size = 0, buffer_size = 0;
+  const char *begin = pos;
+
+  while (pos < end) {
+    const char *eol = (const char*) memchr(pos, '\n', end - pos);
+    if (!eol) {
+      eol = end;
+    }
+    if (eol > pos && !(eol - pos == 1 && *pos == '\r')) {
+      if (size >= buffer_size) {
+        buffer_size = buffer_size ? 2*buffer_size : 1024;
+        rows = (size_t*) realloc(rows, sizeof(size_t)*buffer_size);
+      }
+      rows[size++] = pos - begin;
+    }
+    pos = eol + 1;
+  }
+  *numrows = size;
+  return rows;
+}
+
+static int is_blank(char c)
+{
+  return c == ' ' || c == '\t';
+}
+
+/* Parses one row into column-major data; returns 0 on success */
+static int read_row(const char *p, const char *end, unsigned char delim, double *data, int row, int numvars, int numsteps)
+{
+  int col;
+  for (col = 0; ; col++) {
+    const char *start, *stop;
+    if (col >= numvars) {
+      fprintf(stderr,"Did not find time points for all variables for row: %d\n", row+1);
+      return 1;
+    }
+    while (p < end && is_blank(*p)) {
+      p++;
+    }
+    if (p < end && *p == '"') {
+      start = ++p;
+      while (p < end && *p != '"' && *p != '\n') {
+        p++;
+      }
+      stop = p;
+      if (p < end && *p == '"') {
+        p++;
+      }
+      while (p < end && *p != delim && *p != '\n' && *p != '\r') {
+        p++;
+      }
+    } else {
+      start = p;
+      while (p < end && *p != delim && *p != '\n' && *p != '\r') {
+        p++;
+      }
+      stop = p;
+    }
+    while (stop > start && is_blank(stop[-1])) {
+      stop--;
+    }
+    if (start == stop) {
+      data[(size_t)col*numsteps + row] = 0.0;
+    } else {
+      char *endptr = NULL;
+      data[(size_t)col*numsteps + row] = om_strtod(start, &endptr);
+      if (endptr != stop) {
+        fprintf(stderr,"Found non-double data in csv result-file: %.*s\n", (int)(stop-start), start);
+        return 1;
+      }
+    }
+    if (p < end && *p == delim) {
+      p++;
+      continue;
+    }
+    break;
+  }
+  if (col+1 != numvars) {
+    fprintf(stderr,"Did not find time points for all variables for row: %d\n", row+1);
+    return 1;
+  }
+  return 0;
+}
+
+int read_csv_dataset_size(const char* filename)
+{
+  struct csv_buffer buffer;
+  const char *pos, *end;
+  unsigned char delim;
+  char **variables;
+  size_t *rows;
+  int i, numvars, numrows;
+
+  if (read_csv_buffer(filename, &buffer)) {
+    return -1;
+  }
+  end = buffer.data + buffer.size;
+  pos = skip_separator_line(buffer.data, end, &delim);
+  variables = read_header(&pos, end, delim, &numvars);
+  rows = index_rows(pos, end, &numrows);
+  for (i=0; i<numvars; i++) {
+    free(variables[i]);
+  }
+  free(variables);
+  free(rows);
+  free_csv_buffer(&buffer);
+  return numrows;
 }
 
 char** read_csv_variables(FILE *fin, int *length, unsigned char delim)
@@ -158,169 +338,112 @@ char** read_csv_variables(FILE *fin, int *length, unsigned char delim)
   return head.variables;
 }
 
-static void add_cell(void *data, size_t len, void *t)
+static int compare_variable_names(const void *a, const void *b)
 {
-  struct csv_body *body = (struct csv_body*) t;
-  char *endptr = "";
-  if (body->error) {
-    return;
-  }
-  if (!body->found_first_row) {
-    body->cur_size++;
-    body->row_length++;
-    return;
-  }
-  if (body->size+1 >= body->buffer_size) {
-    body->buffer_size = body->res ? 2*body->buffer_size : body->row_length*1024; /* Guess it's 1024 time points; we could also take the size of the file or something, but this is cool too */
-    body->buffer_size = body->buffer_size > 0 ? body->buffer_size : 1024;
-    body->res = body->res ? (double*)realloc(body->res, sizeof(double)*body->buffer_size) : (double*) malloc(sizeof(double)*body->buffer_size);
-  }
-  if (data == NULL) {
-    body->res[body->size++] = 0.0;
-    return;
-  }
-  body->res[body->size++] = data ? om_strtod((const char*)data,&endptr) : 0;
-  if (*endptr) {
-    fprintf(stderr,"Found non-double data in csv result-file: %s\n", (char*) data);
-    body->error = 1;
-  }
+  char * const *va = *(char * const **) a;
+  char * const *vb = *(char * const **) b;
+  int cmp = strcmp(*va, *vb);
+  /* keep the file order of duplicate names, read_csv_dataset returns the first one */
+  return cmp ? cmp : (va < vb ? -1 : va > vb);
 }
 
-static void add_row(int c, void *t)
+static int* sort_variables(char **variables, int numvars)
 {
-  struct csv_body *body = (struct csv_body*) t;
-  body->found_first_row++;
-  if (body->cur_size != body->row_length) {
-    fprintf(stderr,"Did not find time points for all variables for row: %d\n", body->found_first_row);
-    body->error = 1;
-    return;
-  }
-}
-
-double* read_csv_dataset_var(const char *filename, const char *var, int dimsize)
-{
-  const int buf_size = 4096;
-  char buf[4096];
-  char **res;
-  struct csv_parser p;
-  struct csv_body body = {0};
-  FILE *fin = omc_fopen(filename, "r");
-  size_t offset = 0;
-  unsigned char delim = CSV_COMMA;
-  if (!fin) {
-    return NULL;
+  char ***sorted = (char***) malloc(sizeof(char**)*(numvars > 0 ? numvars : 1));
+  int *index = (int*) malloc(sizeof(int)*(numvars > 0 ? numvars : 1));
+  int i;
+  for (i=0; i<numvars; i++) {
+    sorted[i] = variables + i;
   }
-
-  /* determine delim */
-  omc_fread(buf, 1, 5, fin, 0);
-  if (0 == strcmp(buf, "\"sep="))
-  {
-    omc_fread(&delim, 1, 1, fin, 0);
-    offset = 8;
+  qsort(sorted, numvars, sizeof(char**), compare_variable_names);
+  for (i=0; i<numvars; i++) {
+    index[i] = (int) (sorted[i] - variables);
   }
-  fseek(fin, offset, SEEK_SET);
-
-  csv_init(&p, CSV_STRICT | CSV_REPALL_NL | CSV_STRICT_FINI | CSV_APPEND_NULL | CSV_EMPTY_IS_NULL, delim);
-  csv_set_realloc_func(&p, realloc);
-  csv_set_free_func(&p, free);
-  do {
-    size_t len = omc_fread(buf, 1, buf_size, fin, 1);
-    if (len != buf_size && !feof(fin)) {
-      csv_free(&p);
-      fclose(fin);
-      return NULL;
-    }
-    csv_parse(&p,buf,len,add_cell,add_row,&body);
-  } while (!body.error && !feof(fin));
-  csv_fini(&p,add_cell,add_row,&body);
-  csv_free(&p);
-  fclose(fin);
-  if (body.error) {
-    return NULL;
-  }
-  return body.res;
+  free(sorted);
+  return index;
 }
 
 struct csv_data* read_csv(const char *filename)
 {
-  const int buf_size = 4096;
-  char buf[4096];
-  char **variables;
-  int dummy;
-  struct csv_parser p;
-  struct csv_body body = {0};
+  struct csv_buffer buffer;
   struct csv_data *res;
-  size_t offset = 0;
-  unsigned char delim = CSV_COMMA;
-  size_t len;
+  const char *pos, *end;
+  unsigned char delim;
+  char **variables;
+  size_t *rows;
+  double *data;
+  int i, numvars, numsteps, error = 0;
 
-  FILE *fin = omc_fopen(filename, "r");
-  if (!fin) {
+  if (read_csv_buffer(filename, &buffer)) {
     return NULL;
   }
-
-  /* determine delim */
-  len = omc_fread(buf, 1, 5, fin, 0);
-  // Terminate the string in the buffer to make sure strcmp works as expected.
-  buf[len] = '\0';
-  if (0 == strcmp(buf, "\"sep="))
-  {
-    omc_fread(&delim, 1, 1, fin, 0);
-    offset = 8;
-  }
-  fseek(fin, offset, SEEK_SET);
-
-  variables = read_csv_variables(fin, &dummy, delim);
+  end = buffer.data + buffer.size;
+  pos = skip_separator_line(buffer.data, end, &delim);
+  variables = read_header(&pos, end, delim, &numvars);
   if (!variables) {
-    fclose(fin);
+    free_csv_buffer(&buffer);
     return NULL;
   }
-  fseek(fin,offset,SEEK_SET);
+  rows = index_rows(pos, end, &numsteps);
 
-  csv_init(&p, CSV_STRICT | CSV_REPALL_NL | CSV_STRICT_FINI | CSV_APPEND_NULL | CSV_EMPTY_IS_NULL, delim);
-  csv_set_realloc_func(&p, realloc);
-  csv_set_free_func(&p, free);
-  do {
-    len = omc_fread(buf, 1, buf_size, fin, 1);
-    if (len != buf_size && !feof(fin)) {
-      csv_free(&p);
-      fclose(fin);
-      return NULL;
+  /* The values are stored column by column, each row writes one element of every column */
+  data = (double*) malloc(sizeof(double)*((size_t)numvars*numsteps > 0 ? (size_t)numvars*numsteps : 1));
+  if (data) {
+    om_strtod("0", NULL); /* initialize the C locale before the threads use it */
+#pragma omp parallel for schedule(static) default(none) shared(rows, pos, end, delim, data, numvars, numsteps, error)
+    for (i=0; i<numsteps; i++) {
+      if (!error && read_row(pos + rows[i], end, delim, data, i, numvars, numsteps)) {
+#pragma omp critical
+        error = 1;
+      }
     }
-    csv_parse(&p,buf,len,add_cell,add_row,&body);
-  } while (!body.error && !feof(fin));
-  csv_fini(&p,add_cell,add_row,&body);
-  csv_free(&p);
-  fclose(fin);
-  if (body.error) {
-    return NULL;
+  } else {
+    error = 1;
   }
-  res = (struct csv_data*) malloc(sizeof(struct csv_data));
+  free(rows);
+  free_csv_buffer(&buffer);
+
+  res = error ? NULL : (struct csv_data*) malloc(sizeof(struct csv_data));
   if (!res) {
+    for (i=0; i<numvars; i++) {
+      free(variables[i]);
+    }
+    free(variables);
+    free(data);
     return NULL;
   }
   res->variables = variables;
-  res->data = body.res;
-  res->numvars = body.row_length;
-  res->numsteps = body.size / body.row_length;
-  matrix_transpose(res->data,res->numvars,res->numsteps);
-  /* printf("num vars %d in %s num steps %d\n", body.row_length, filename, res->numsteps); */
+  res->data = data;
+  res->numvars = numvars;
+  res->numsteps = numsteps;
+  res->sortedIndex = sort_variables(variables, numvars);
   return res;
 }
 
-double* read_csv_dataset(struct csv_data *data, const char *var)
+int read_csv_dataset_index(struct csv_data *data, const char *var)
 {
-  int i,found=-1;
-  for (i=0; i<data->numvars; i++) {
-    if (0==strcmp(data->variables[i],var)) {
-      found=i;
-      break;
+  int low = 0, high = data->numvars;
+  while (low < high) {
+    int mid = low + (high - low) / 2;
+    if (strcmp(data->variables[data->sortedIndex[mid]], var) < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
     }
   }
-  if (found == -1) {
+  if (low == data->numvars || strcmp(data->variables[data->sortedIndex[low]], var)) {
+    return -1;
+  }
+  return data->sortedIndex[low];
+}
+
+double* read_csv_dataset(struct csv_data *data, const char *var)
+{
+  int index = read_csv_dataset_index(data, var);
+  if (index < 0) {
     return NULL;
   }
-  return data->data + i*data->numsteps;
+  return data->data + (size_t)index*data->numsteps;
 }
 
 void omc_free_csv_reader(struct csv_data *data)
@@ -331,7 +454,9 @@ void omc_free_csv_reader(struct csv_data *data)
   }
   free(data->variables);
   free(data->data);
+  free(data->sortedIndex);
   data->variables = 0;
   data->data = 0;
+  data->sortedIndex = 0;
   free(data);
 }
@@ -31,22 +31,40 @@
 #ifndef OMC_READ_CSV_H
 #define OMC_READ_CSV_H
 
+#include <stddef.h>
+
 struct csv_data {
   char **variables;
-  double *data;
+  double *data;     /* column-major: the values of variable i are data[i*numsteps ... (i+1)*numsteps-1] */
   int numvars;
   int numsteps;
+  int *sortedIndex; /* indices of the variables sorted by name, used by read_csv_dataset */
+};
+
+/* The contents of a whole file; memory-mapped if supported */
+struct csv_buffer {
+  const char *data;
+  size_t size;
+  int mapped;
 };
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Reads or maps the whole file. Returns 0 on success.
+ * The contents are either terminated by '\0' or end with a newline. */
+int read_csv_buffer(const char *filename, struct csv_buffer *buffer);
+void free_csv_buffer(struct csv_buffer *buffer);
+
 int read_csv_dataset_size(const char* filename);
 
 char** read_csv_variables(FILE *fin, int *length, unsigned char delim);
 
+/* Parses the header and all rows of the file in a single pass */
 struct csv_data* read_csv(const char *filename);
+/* Index of the first variable named var, or -1 */
+int read_csv_dataset_index(struct csv_data *data, const char *var);
 double* read_csv_dataset(struct csv_data *data, const char *var);
 void omc_free_csv_reader(struct csv_data *data);
 
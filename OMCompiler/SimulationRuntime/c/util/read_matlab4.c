@@ -36,6 +36,7 @@
 #include <ctype.h>
 #include "read_matlab4.h"
 #include "omc_file.h"
+#include "omc_mmap.h"
 
 extern const char *omc_mat_Aclass;
 
@@ -110,6 +111,16 @@ int mat_element_length(int type)
 void omc_free_matlab4_reader(ModelicaMatReader *reader)
 {
   unsigned int i;
+#if HAVE_MMAP
+  if (reader->mappedFile) {
+    omc_mmap_read_unix map;
+    map.data = reader->mappedFile;
+    map.size = reader->mappedSize;
+    omc_mmap_close_read_unix(map);
+    reader->mappedFile = NULL;
+    reader->mappedSize = 0;
+  }
+#endif
   if (reader->file) {
     fclose(reader->file);
     reader->file = 0;
@@ -455,34 +466,13 @@ const char* omc_new_matlab4_reader(const char *filename, ModelicaMatReader *read
         if(-1==omc_fseek(reader->file,matrix_length,SEEK_CUR)) return "Corrupt header: data_2 matrix";
       }
       if(binTrans==0) {
-        unsigned int k,j;
         reader->nrows = hdr.mrows;
         /* Allow empty matrix; it's not a complete file, but ok... */
         /* if(reader->nrows < 2) return "Too few rows in data_2 matrix"; */
         reader->nvar = hdr.ncols;
+        reader->columnMajor = 1;
         reader->var_offset = ftell(reader->file);
         reader->vars = (double**) calloc(reader->nvar*2,sizeof(double*));
-
-
-        double *tmp=NULL;
-        tmp = (double*) malloc(hdr.mrows*hdr.ncols*sizeof(double));
-        if (read_double(hdr.type, hdr.mrows*hdr.ncols, reader->file, tmp)) {
-          return "Corrupt header: data_2 matrix";
-        }
-        for(k=0; k<hdr.ncols; k++) {
-          reader->vars[k] = (double*) malloc(hdr.mrows*sizeof(double));
-          for(j=0; j<hdr.mrows; j++) {
-            reader->vars[k][j] = tmp[j+k*hdr.mrows];
-          }
-        }
-        for(k=reader->nvar; k<reader->nvar*2; k++) {
-          reader->vars[k] = (double*) malloc(hdr.mrows*sizeof(double));
-          for(j=0; j<hdr.mrows; j++) {
-            reader->vars[k][j] = -reader->vars[k-reader->nvar][j];
-          }
-        }
-        free(tmp);
-
         if(-1==omc_fseek(reader->file,matrix_length,SEEK_CUR)) return "Corrupt header: data_2 matrix";
       }
       break;
@@ -491,6 +481,20 @@ const char* omc_new_matlab4_reader(const char *filename, ModelicaMatReader *read
       return "Implementation error: Unknown case";
     }
   }
+#if HAVE_MMAP
+  /* Map the file so that variables can be extracted from data_2 without
+   * one seek+read per value; falls back to the FILE* on failure */
+  if (reader->nvar > 0 && reader->nrows > 0) {
+    omc_mmap_read_unix map = omc_mmap_open_read_file_unix(reader->file);
+    size_t element_length = reader->doublePrecision==1 ? sizeof(double) : sizeof(float);
+    if (map.data && map.size >= reader->var_offset + element_length*reader->nvar*reader->nrows) {
+      reader->mappedFile = map.data;
+      reader->mappedSize = map.size;
+    } else if (map.data) {
+      omc_mmap_close_read_unix(map);
+    }
+  }
+#endif
   return 0;
 }
 
@@ -573,6 +577,41 @@ ModelicaMatVariable_t *omc_matlab4_find_var(ModelicaMatReader *reader, const cha
   return res;
 }
 
+/* Position of the value of variable ix (0-based) at time step row in data_2, in elements */
+static OMC_INLINE size_t data_2_position(ModelicaMatReader *reader, size_t ix, size_t row)
+{
+  return reader->columnMajor ? ix*reader->nrows + row : row*reader->nvar + ix;
+}
+
+/* Extracts rows [rowStart,rowStart+n) of column ix (0-based) from the
+ * mapped data_2 matrix into res[0..n-1] in a single strided pass */
+static void read_mapped_column(ModelicaMatReader *reader, size_t ix, size_t rowStart, size_t n, int negate, double *res)
+{
+  size_t i;
+  const size_t pos = data_2_position(reader, ix, rowStart);
+  const size_t elemStride = reader->columnMajor ? 1 : reader->nvar;
+  if (reader->doublePrecision==1) {
+    const size_t stride = elemStride*sizeof(double);
+    const char *src = reader->mappedFile + reader->var_offset + pos*sizeof(double);
+    for (i=0; i<n; i++, src+=stride) {
+      memcpy(&res[i], src, sizeof(double)); /* the matrix is not necessarily aligned */
+    }
+  } else {
+    const size_t stride = elemStride*sizeof(float);
+    const char *src = reader->mappedFile + reader->var_offset + pos*sizeof(float);
+    float f;
+    for (i=0; i<n; i++, src+=stride) {
+      memcpy(&f, src, sizeof(float));
+      res[i] = f;
+    }
+  }
+  if (negate) {
+    for (i=0; i<n; i++) {
+      res[i] = -res[i];
+    }
+  }
+}
+
 /* Writes the number of values in the returned array if nvals is non-NULL */
 double* omc_matlab4_read_vals(ModelicaMatReader *reader, int varIndex)
 {
@@ -581,6 +620,31 @@ double* omc_matlab4_read_vals(ModelicaMatReader *reader, int varIndex)
   assert(absVarIndex > 0 && absVarIndex <= reader->nvar);
   if (0 == reader->nrows) {
     return NULL;
+  } else if(!reader->vars[ix] && reader->mappedFile) {
+    double *tmp = (double*) malloc(reader->nrows*sizeof(double));
+    if (!tmp) {
+      return NULL;
+    }
+    read_mapped_column(reader, absVarIndex-1, 0, reader->nrows, varIndex < 0, tmp);
+    reader->vars[ix] = tmp;
+  } else if(!reader->vars[ix] && reader->columnMajor) {
+    unsigned int i;
+    double *tmp = (double*) malloc(reader->nrows*sizeof(double));
+    if (!tmp) {
+      return NULL;
+    }
+    /* The variable is one contiguous block */
+    omc_fseek(reader->file, reader->var_offset + (reader->doublePrecision==1 ? sizeof(double) : sizeof(float))*data_2_position(reader, absVarIndex-1, 0), SEEK_SET);
+    if (read_double(reader->doublePrecision==1 ? 0 : 10, reader->nrows, reader->file, tmp)) {
+      free(tmp);
+      return NULL;
+    }
+    if (varIndex < 0) {
+      for (i=0; i<reader->nrows; i++) {
+        tmp[i] = -tmp[i];
+      }
+    }
+    reader->vars[ix] = tmp;
   } else if(!reader->vars[ix]) {
     unsigned int i;
     double *tmp = (double*) malloc(reader->nrows*sizeof(double));
@@ -631,6 +695,25 @@ double* omc_matlab4_read_vals(ModelicaMatReader *reader, int varIndex)
   return reader->vars[ix];
 }
 
+double* omc_matlab4_take_vals(ModelicaMatReader *reader, int varIndex)
+{
+  size_t absVarIndex = abs(varIndex);
+  size_t ix = (varIndex < 0 ? absVarIndex + reader->nvar : absVarIndex) -1;
+  double *vals;
+  assert(absVarIndex > 0 && absVarIndex <= reader->nvar);
+  if (reader->vars[ix]) {
+    /* Already cached; the reader keeps its copy */
+    vals = (double*) malloc(reader->nrows*sizeof(double));
+    if (vals) {
+      memcpy(vals, reader->vars[ix], reader->nrows*sizeof(double));
+    }
+    return vals;
+  }
+  vals = omc_matlab4_read_vals(reader, varIndex);
+  reader->vars[ix] = NULL;
+  return vals;
+}
+
 void matrix_transpose(double *m, int w, int h)
 {
   int start;
@@ -691,6 +774,39 @@ int omc_matlab4_read_all_vals(ModelicaMatReader *reader)
     reader->readAll = 1;
     return 0;
   }
+  if (reader->mappedFile) {
+    /* No full copy and transpose needed; gather blocks of rows so each
+     * part of the mapping is touched once while it is in cache */
+    const int blockRows = 256;
+    int k;
+    for (i=0; i<nvar; i++) {
+      if (!reader->vars[i]) {
+        reader->vars[i] = (double*) malloc(nrows*sizeof(double));
+        if (!reader->vars[i]) {
+          return 1;
+        }
+      }
+    }
+    for (k=0; k<nrows; k+=blockRows) {
+      int kEnd = k+blockRows < nrows ? k+blockRows : nrows;
+      for (i=0; i<nvar; i++) {
+        read_mapped_column(reader, i, k, kEnd-k, 0, reader->vars[i]+k);
+      }
+    }
+    for (i=nvar; i<2*nvar; i++) {
+      if (!reader->vars[i]) {
+        reader->vars[i] = (double*) malloc(nrows*sizeof(double));
+        if (!reader->vars[i]) {
+          return 1;
+        }
+        for (j=0; j<nrows; j++) {
+          reader->vars[i][j] = -reader->vars[i-nvar][j];
+        }
+      }
+    }
+    reader->readAll = 1;
+    return 0;
+  }
   tmp = (double*) malloc(2*nvar*nrows*sizeof(double));
   if (!tmp) {
     return 1;
@@ -705,7 +821,9 @@ int omc_matlab4_read_all_vals(ModelicaMatReader *reader)
       tmp[i] = ((float*)tmp)[i];
     }
   }
-  matrix_transpose(tmp,nvar,nrows);
+  if (!reader->columnMajor) {
+    matrix_transpose(tmp,nvar,nrows);
+  }
   /* Negative aliases */
   for (i=0; i<nrows*nvar; i++) {
     tmp[nrows*nvar + i] = -tmp[i];
@@ -731,15 +849,19 @@ double omc_matlab4_read_single_val(double *res, ModelicaMatReader *reader, int v
     *res = reader->vars[ix][timeIndex];
     return 0;
   }
+  if(reader->mappedFile) {
+    read_mapped_column(reader, absVarIndex-1, timeIndex, 1, varIndex < 0, res);
+    return 0;
+  }
   if(reader->doublePrecision==1) {
-    omc_fseek(reader->file,reader->var_offset + sizeof(double)*(timeIndex*reader->nvar + absVarIndex-1), SEEK_SET);
+    omc_fseek(reader->file,reader->var_offset + sizeof(double)*data_2_position(reader, absVarIndex-1, timeIndex), SEEK_SET);
     if(1 != omc_fread(res, sizeof(double), 1, reader->file, 0)) {
       *res = 0;
       return 1;
     }
   } else {
     float tmpres;
-    omc_fseek(reader->file,reader->var_offset + sizeof(float)*(timeIndex*reader->nvar + absVarIndex-1), SEEK_SET);
+    omc_fseek(reader->file,reader->var_offset + sizeof(float)*data_2_position(reader, absVarIndex-1, timeIndex), SEEK_SET);
     if(1 != omc_fread(&tmpres, sizeof(float), 1, reader->file, 0)) {
       *res = 0;
       return 1;
@@ -884,6 +1006,88 @@ int omc_matlab4_read_vars_val(double *res, ModelicaMatReader *reader, ModelicaMa
     return 0;
 }
 
+/* Returns the last row i with vec[i] <= key, for vec[0] <= key.
+ * Gallops away from hint and bisects the final bracket. */
+static int find_row_from(double key, const double *vec, int nelem, int hint)
+{
+  int lo, hi, step;
+  if (hint < 0) {
+    hint = 0;
+  } else if (hint >= nelem) {
+    hint = nelem-1;
+  }
+  if (vec[hint] <= key) {
+    /* Invariant: vec[lo] <= key and (hi == nelem or vec[hi] > key) */
+    lo = hint;
+    hi = hint+1;
+    for (step = 1; hi < nelem && vec[hi] <= key; step *= 2) {
+      lo = hi;
+      hi = (nelem - lo > step) ? lo + step : nelem;
+    }
+  } else {
+    hi = hint;
+    lo = hint-1;
+    for (step = 1; lo > 0 && vec[lo] > key; step *= 2) {
+      hi = lo;
+      lo = (lo > step) ? lo - step : 0;
+    }
+  }
+  while (hi - lo > 1) {
+    int mid = lo + (hi-lo)/2;
+    if (vec[mid] <= key) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+int omc_matlab4_find_time(ModelicaMatReader *reader, double time, ModelicaMatTimePoint *point)
+{
+  double *t;
+  int row;
+  if(time > omc_matlab4_stopTime(reader)) return 1;
+  if(time < omc_matlab4_startTime(reader)) return 1;
+  t = omc_matlab4_read_vals(reader,1);
+  if(!t) return 1;
+  row = find_row_from(time, t, reader->nrows, point->cursor);
+  point->cursor = row;
+  if(t[row] == time) {
+    point->index1 = row;
+    point->weight1 = 1.0;
+    point->index2 = -1;
+    point->weight2 = 0.0;
+  } else if(row+1 < (int)reader->nrows) {
+    point->index1 = row+1;
+    point->index2 = row;
+    point->weight1 = (time - t[row]) / (t[row+1]-t[row]);
+    point->weight2 = 1.0 - point->weight1;
+  } else {
+    return 1; /* NaN */
+  }
+  return 0;
+}
+
+int omc_matlab4_val_at(double *res, ModelicaMatReader *reader, ModelicaMatVariable_t *var, const ModelicaMatTimePoint *point)
+{
+  double y1,y2;
+  if(var->isParam) {
+    if(var->index < 0)
+      *res = -reader->params[abs(var->index)-1];
+    else
+      *res = reader->params[var->index-1];
+    return 0;
+  }
+  if(point->index2 == -1) {
+    return (int)omc_matlab4_read_single_val(res,reader,var->index,point->index1);
+  }
+  if(omc_matlab4_read_single_val(&y1,reader,var->index,point->index1)) return 1;
+  if(omc_matlab4_read_single_val(&y2,reader,var->index,point->index2)) return 1;
+  *res = point->weight1*y1 + point->weight2*y2;
+  return 0;
+}
+
 void omc_matlab4_print_all_vars(FILE *stream, ModelicaMatReader *reader)
 {
   unsigned int i;
@@ -55,8 +55,23 @@ typedef struct {
   int readAll; /* Read all variables already */
   double **vars;
   char doublePrecision; /* data_1 and data_2 in double ore single precision */
+  char columnMajor; /* binNormal: data_2 holds each variable as one contiguous block of nrows values */
+  const char *mappedFile; /* Read-only mapping of the whole file if supported; else NULL and values are read using file */
+  size_t mappedSize;
 } ModelicaMatReader;
 
+/* A point in the time vector of a result file, see omc_matlab4_find_time.
+ * index2 is -1 if the time is one of the stored time points; else the value is
+ * interpolated as weight1*value(index1) + weight2*value(index2).
+ * cursor is the row found by the last lookup and is used as the starting point
+ * of the next one; initialize it to 0.
+ */
+typedef struct {
+  int index1, index2;
+  double weight1, weight2;
+  int cursor;
+} ModelicaMatTimePoint;
+
 /* Returns 0 on success; the error message on error.
  * The internal data is free'd by omc_free_matlab4_reader.
  * The data persists until free'd, and is safe to use in your own data-structures
@@ -78,6 +93,11 @@ ModelicaMatVariable_t *omc_matlab4_find_var(ModelicaMatReader *reader, const cha
  */
 double* omc_matlab4_read_vals(ModelicaMatReader *reader, int varIndex);
 
+/* Like omc_matlab4_read_vals, but the returned array is owned (and free'd) by the caller
+ * and not cached by the reader. Use it to stream over the variables of a large file.
+ */
+double* omc_matlab4_take_vals(ModelicaMatReader *reader, int varIndex);
+
 /* Returns 0 on success */
 int omc_matlab4_val(double *res, ModelicaMatReader *reader, ModelicaMatVariable_t *var, double time);
 
@@ -85,6 +105,17 @@ int omc_matlab4_val(double *res, ModelicaMatReader *reader, ModelicaMatVariable_
  * Returns 0 on success */
 int omc_matlab4_read_vars_val(double *res, ModelicaMatReader *reader, ModelicaMatVariable_t **var, int N, double time);
 
+/* Locates time in the time vector, starting the search at point->cursor.
+ * The cost depends on the distance to the previous lookup, so evaluating many
+ * variables at a slowly moving time (e.g. animations) does not bisect the whole
+ * time vector for each variable. At events the right limit is used, as in omc_matlab4_val.
+ * Returns 0 on success and 1 if time is outside the simulation interval */
+int omc_matlab4_find_time(ModelicaMatReader *reader, double time, ModelicaMatTimePoint *point);
+
+/* Reads the value of a variable at a time point found by omc_matlab4_find_time
+ * Returns 0 on success */
+int omc_matlab4_val_at(double *res, ModelicaMatReader *reader, ModelicaMatVariable_t *var, const ModelicaMatTimePoint *point);
+
 /* For debugging */
 void omc_matlab4_print_all_vars(FILE *stream, ModelicaMatReader *reader);
 
@@ -36,6 +36,7 @@
 #include "integer_array.h"
 #include "omc_error.h"
 #include "generic_array.h"
+#include "matrix_kernels.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -877,77 +878,28 @@ modelica_real mul_real_scalar_product(const real_array a, const real_array b)
 
 void mul_real_matrix_product(const real_array * a,const real_array * b,real_array* dest)
 {
-    modelica_real tmp;
-    size_t i_size;
-    size_t j_size;
-    size_t k_size;
-    size_t i;
-    size_t j;
-    size_t k;
-
     /* Assert that dest has correct size */
-    i_size = dest->dim_size[0];
-    j_size = dest->dim_size[1];
-    k_size = a->dim_size[1];
-
-    for(i = 0; i < i_size; ++i) {
-        for(j = 0; j < j_size; ++j) {
-            tmp = 0;
-            for(k = 0; k < k_size; ++k) {
-                tmp += real_get(*a, (i * k_size) + k)*real_get(*b, (k * j_size) + j);
-            }
-            real_set(dest, (i * j_size) + j, tmp);
-        }
-    }
+    omc_matrix_product(dest->dim_size[0], dest->dim_size[1], a->dim_size[1],
+                       (const modelica_real*) a->data, (const modelica_real*) b->data, (modelica_real*) dest->data);
 }
 
 void mul_real_matrix_vector(const real_array * a, const real_array * b,real_array* dest)
 {
-    size_t i;
-    size_t j;
-    size_t i_size;
-    size_t j_size;
-    modelica_real tmp;
-
     /* Assert a matrix */
     /* Assert b vector */
     /* Assert dest correct size (a vector)*/
-
-    i_size = a->dim_size[0];
-    j_size = a->dim_size[1];
-
-    for(i = 0; i < i_size; ++i) {
-        tmp = 0;
-        for(j = 0; j < j_size; ++j) {
-            tmp += real_get(*a, (i * j_size) + j) * real_get(*b, j);
-        }
-        real_set(dest, i, tmp);
-    }
+    omc_matrix_vector_product(a->dim_size[0], a->dim_size[1],
+                              (const modelica_real*) a->data, (const modelica_real*) b->data, (modelica_real*) dest->data);
 }
 
 
 void mul_real_vector_matrix(const real_array * a, const real_array * b,real_array* dest)
 {
-    size_t i;
-    size_t j;
-    size_t i_size;
-    size_t j_size;
-    modelica_real tmp;
-
     /* Assert a vector */
     /* Assert b matrix */
     /* Assert dest vector of correct size */
-
-    i_size = a->dim_size[0];
-    j_size = b->dim_size[1];
-
-    for(i = 0; i < i_size; ++i) {
-        tmp = 0;
-        for(j = 0; j < j_size; ++j) {
-            tmp += real_get(*a, j) * real_get(*b, (j * j_size) + i);
-        }
-        real_set(dest, i, tmp);
-    }
+    omc_vector_matrix_product(b->dim_size[0], b->dim_size[1],
+                              (const modelica_real*) a->data, (const modelica_real*) b->data, (modelica_real*) dest->data);
 }
 
 real_array mul_alloc_real_matrix_product_smart(const real_array a, const real_array b)
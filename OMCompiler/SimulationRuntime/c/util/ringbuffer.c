@@ -113,9 +113,18 @@ void *getRingData(RINGBUFFER *rb, int i)
  */
 void expandRingBuffer(RINGBUFFER *rb)
 {
+  int oldSize = rb->bufferSize;
+  int nWrapped = rb->firstElement + rb->nElements - oldSize;
+
   rb->bufferSize *= 2;
   rb->buffer = realloc(rb->buffer, rb->bufferSize*rb->itemSize);
   assertStreamPrint(NULL, 0 != rb->buffer, "out of memory");
+
+  /* Elements that wrapped around to the start of the old buffer
+   * now have to follow the last element of the old buffer. */
+  if (nWrapped > 0) {
+    memcpy(((char*)rb->buffer)+oldSize*rb->itemSize, rb->buffer, nWrapped*rb->itemSize);
+  }
 }
 
 /**
@@ -183,6 +192,38 @@ int ringBufferLength(RINGBUFFER *rb)
   return rb->nElements;
 }
 
+/**
+ * @brief Binary search in sorted ring buffer.
+ *
+ * Elements lo, ..., hi-1 have to be sorted in ascending order with respect to compare.
+ *
+ * @param rb        Pointer to ring buffer.
+ * @param lo        First index of search range.
+ * @param hi        One past the last index of search range.
+ * @param key       Pointer to searched key.
+ * @param compare   Returns a negative value, zero or a positive value if key is
+ *                  less than, equal to or greater than elem.
+ * @return int      Index of last element in [lo,hi) that is less than or equal to key,
+ *                  lo-1 if key is less than all elements.
+ */
+int bisectRingBuffer(RINGBUFFER *rb, int lo, int hi, const void *key, int (*compare)(const void *key, const void *elem))
+{
+  assertStreamPrint(NULL, 0 <= lo && lo <= hi && hi <= rb->nElements, "index range [%d:%d) out of range [0:%d)", lo, hi, rb->nElements);
+
+  /* invariant: elements before lo are <= key, elements from hi on are > key */
+  while (lo < hi) {
+    int mid = lo + (hi-lo)/2;
+    void *elem = ((char*)rb->buffer)+(((rb->firstElement+mid)%rb->bufferSize)*rb->itemSize);
+    if (compare(key, elem) < 0) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+
+  return lo - 1;
+}
+
 /**
  * @brief Rotate start point of ring buffer by n elements.
  *
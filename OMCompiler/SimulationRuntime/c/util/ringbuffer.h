@@ -55,6 +55,8 @@ extern "C" {
 
   int ringBufferLength(RINGBUFFER *rb);
 
+  int bisectRingBuffer(RINGBUFFER *rb, int lo, int hi, const void *key, int (*compare)(const void *key, const void *elem));
+
   void rotateRingBuffer(RINGBUFFER *rb, int n);
   void lookupRingBuffer(RINGBUFFER *rb, void **lookup);
 
@@ -35,6 +35,9 @@ const char *FLAG_NAME[FLAG_MAX+1] = {
 
   /* FLAG_ABORT_SLOW */                   "abortSlowSimulation",
   /* FLAG_ALARM */                        "alarm",
+  /* FLAG_ASYNC_OUTPUT */                 "asyncOutput",
+  /* FLAG_BATCH */                        "batch",
+  /* FLAG_BATCH_PROCESSES */              "batchProcesses",
   /* FLAG_CLOCK */                        "clock",
   /* FLAG_CPU */                          "cpu",
   /* FLAG_CSV_OSTEP */                    "csvOstep",
@@ -42,11 +45,13 @@ const char *FLAG_NAME[FLAG_MAX+1] = {
   /* FLAG_CVODE_LMM */                    "cvodeLinearMultistepMethod",
   /* FLAG_DATA_RECONCILE_Cx */            "cx",
   /* FLAG_DAE_MODE */                     "daeMode",
+  /* FLAG_DECODE_LOG */                   "decodeLog",
   /* FLAG_DELTA_X_LINEARIZE */            "deltaXLinearize",
   /* FLAG_DELTA_X_SOLVER */               "deltaXSolver",
   /* FLAG_EMBEDDED_SERVER */              "embeddedServer",
   /* FLAG_EMBEDDED_SERVER_PORT */         "embeddedServerPort",
   /* FLAG_MAT_SYNC */                     "mat_sync",
+  /* FLAG_MAT_COLUMN_MAJOR */             "matColumnMajor",
   /* FLAG_EMIT_PROTECTED */               "emit_protected",
   /* FLAG_DATA_RECONCILE_Eps */           "eps",
   /* FLAG_F */                            "f",
@@ -117,6 +122,7 @@ const char *FLAG_NAME[FLAG_MAX+1] = {
   /* FLAG_NLS */                          "nls",
   /* FLAG_NLS_INFO */                     "nlsInfo",
   /* FLAG_NLS_LS */                       "nlsLS",
+  /* FLAG_NLS_WARM_START */               "nlsWarmStart",
   /* FLAG_NLSS_MAX_DENSITY */             "nlssMaxDensity",
   /* FLAG_NLSS_MIN_SIZE */                "nlssMinSize",
   /* FLAG_NOEMIT */                       "noemit",
@@ -170,6 +176,9 @@ const char *FLAG_DESC[FLAG_MAX+1] = {
 
   /* FLAG_ABORT_SLOW */                   "aborts if the simulation chatters",
   /* FLAG_ALARM */                        "aborts after the given number of seconds (0 disables)",
+  /* FLAG_ASYNC_OUTPUT */                 "writes the result file in a background thread",
+  /* FLAG_BATCH */                        "value specifies a csv-file with one parameter set per line, every line is simulated",
+  /* FLAG_BATCH_PROCESSES */              "value specifies the number of simulations of -batch that run at the same time",
   /* FLAG_CLOCK */                        "selects the type of clock to use -clock=RT, -clock=CYC or -clock=CPU",
   /* FLAG_CPU */                          "dumps the cpu-time into the result file",
   /* FLAG_CSV_OSTEP */                    "value specifies csv-files for debug values for optimizer step",
@@ -177,11 +186,13 @@ const char *FLAG_DESC[FLAG_MAX+1] = {
   /* FLAG_CVODE_LMM */                    "linear multistep method for CVODE solver",
   /* FLAG_DATA_RECONCILE_Cx */            "value specifies a csv-file with inputs as correlation coefficient matrix Cx for DataReconciliation",
   /* FLAG_DAE_MODE */                     "flag to let the integrator use daeResiduals",
+  /* FLAG_DECODE_LOG */                   "value specifies a binary log file written with -logFormat=binary that is printed as text",
   /* FLAG_DELTA_X_LINEARIZE */            "value specifies the delta x value for numerical differentiation used by linearization. The default value is 1e-5.",
   /* FLAG_DELTA_X_SOLVER */               "value specifies the delta x value for numerical differentiation used by integrator. The default values is sqrt(DBL_EPSILON).",
   /* FLAG_EMBEDDED_SERVER */              "enables an embedded server. Valid values: none, opc-da [broken], opc-ua [experimental], or the path to a shared object.",
   /* FLAG_EMBEDDED_SERVER_PORT */         "[int (default 4841)] value specifies the port number used by the embedded server",
   /* FLAG_MAT_SYNC */                     "[int (default 0)] syncs the mat file header after emitting every N time-points (default disabled)",
+  /* FLAG_MAT_COLUMN_MAJOR */             "rewrites the mat result file column-major (binNormal) at the end of the simulation",
   /* FLAG_EMIT_PROTECTED */               "emits protected variables to the result-file",
   /* FLAG_DATA_RECONCILE_Eps */           "value specifies the number of convergence iteration to be performed for DataReconciliation",
   /* FLAG_F */                            "value specifies a new setup XML file to the generated simulation code",
@@ -229,7 +240,7 @@ const char *FLAG_DESC[FLAG_MAX+1] = {
   /* FLAG_JACOBIAN_THREADS */             "[int default: 1] value specifies the number of threads for jacobian evaluation in dassl or ida.",
   /* FLAG_L */                            "value specifies a time where the linearization of the model should be performed",
   /* FLAG_L_DATA_RECOVERY */              "emit data recovery matrices with model linearization",
-  /* FLAG_LOG_FORMAT */                   "value specifies the log format of the executable. -logFormat=text (default), -logFormat=xml or -logFormat=xmltcp",
+  /* FLAG_LOG_FORMAT */                   "value specifies the log format of the executable. -logFormat=text (default), -logFormat=xml, -logFormat=xmltcp or -logFormat=binary",
   /* FLAG_LS */                           "value specifies the linear solver method (default: lapack, totalpivot (fallback))",
   /* FLAG_LS_IPOPT */                     "value specifies the linear solver method for ipopt",
   /* FLAG_LSS */                          "value specifies the linear sparse solver method (default: umfpack)",
@@ -252,6 +263,7 @@ const char *FLAG_DESC[FLAG_MAX+1] = {
   /* FLAG_NLS */                          "value specifies the nonlinear solver",
   /* FLAG_NLS_INFO */                     "outputs detailed information about solving process of non-linear systems into csv files.",
   /* FLAG_NLS_LS */                       "value specifies the linear solver used by the non-linear solver",
+  /* FLAG_NLS_WARM_START */               "value specifies a file to read and write converged solutions of non-linear systems for the initial guess",
   /* FLAG_NLSS_MAX_DENSITY */             "[double (default " EXPANDSTRING(DEFAULT_FLAG_NLSS_MAX_DENSITY) ")] value specifies the maximum density for using a non-linear sparse solver",
   /* FLAG_NLSS_MIN_SIZE */                "[int (default " EXPANDSTRING(DEFAULT_FLAG_NLSS_MIN_SIZE) ")] value specifies the minimum system size for using a non-linear sparse solver",
   /* FLAG_NOEMIT */                       "do not emit any results to the result file",
@@ -306,6 +318,23 @@ const char *FLAG_DETAILED_DESC[FLAG_MAX+1] = {
   "  Aborts if the simulation chatters.",
   /* FLAG_ALARM */
   "  Aborts after the given number of seconds (default=0 disables the alarm).",
+  /* FLAG_ASYNC_OUTPUT */
+  "  Writes the result file in a background thread. The integrator copies every\n"
+  "  output row into a bounded buffer and continues, the rows are written in batches.\n"
+  "  If the buffer is full the integrator waits for the writer.\n"
+  "  With -cpu, $cpuTime is taken when the row is copied.",
+  /* FLAG_BATCH */
+  "  Value specifies a csv-file with parameter sets that are simulated without\n"
+  "  reading the model description again. The first line names the\n"
+  "  parameters, variables (their start value is set) or experiment settings\n"
+  "  (startTime, stopTime, stepSize, tolerance), every further line is one run.\n"
+  "  Run n writes the result <model>_res_n.<format> (or the name given by -r with _n\n"
+  "  appended) and the log <model>_res_n.log.\n"
+  "  The runs are simulated in worker processes, see -batchProcesses.\n"
+  "  Can not be used together with -logFormat=binary or -nlsWarmStart.",
+  /* FLAG_BATCH_PROCESSES */
+  "  Value specifies the number of simulations of -batch that run at the same time.\n"
+  "  Defaults to the number of processors.",
   /* FLAG_CLOCK */
   "  Selects the type of clock to use. Valid options include:\n\n"
   "  * RT (monotonic real-time clock)\n"
@@ -331,6 +360,9 @@ const char *FLAG_DETAILED_DESC[FLAG_MAX+1] = {
   "  Value specifies an csv-file with inputs as correlation coefficient matrix Cx for DataReconciliation",
   /* FLAG_DAE_MODE */
   "  Enables daeMode simulation if the model was compiled with the omc flag --daeMode and ida method is used.",
+  /* FLAG_DECODE_LOG */
+  "  Value specifies a binary log file written with -logFormat=binary.\n"
+  "  The messages are printed like with -logFormat=text and the executable exits without simulating.",
   /* FLAG_DELTA_X_LINEARIZE */
   "  Value specifies the delta x value for numerical differentiation used by linearization. The default value is sqrt(DBL_EPSILON*2e1).",
   /* FLAG_DELTA_X_SOLVER */
@@ -345,6 +377,10 @@ const char *FLAG_DETAILED_DESC[FLAG_MAX+1] = {
   "  Value specifies the port number used by the embedded server. The default value is 4841.",
   /* FLAG_MAT_SYNC */
   "  Syncs the mat file header after emitting every N time-points.",
+  /* FLAG_MAT_COLUMN_MAJOR */
+  "  Rewrites the mat result file at the end of the simulation so that all values of a variable\n"
+  "  are stored contiguously (binNormal layout). Reading a single variable is then one contiguous read.\n"
+  "  While the simulation is running the file is written in the usual row-major layout (see -mat_sync).",
   /* FLAG_EMIT_PROTECTED */
   "  Emits protected variables to the result-file.",
   /* FLAG_DATA_RECONCILE_Eps */
@@ -455,7 +491,8 @@ const char *FLAG_DETAILED_DESC[FLAG_MAX+1] = {
   "  Value specifies the log format of the executable:\n\n"
   "  * text (default)\n"
   "  * xml\n"
-  "  * xmltcp (required -port flag)",
+  "  * xmltcp (required -port flag)\n"
+  "  * binary (messages of the optional log streams are written unformatted to <model>_log.bin, see -decodeLog)",
   /* FLAG_LS */
   "  Value specifies the linear solver method",
   /* FLAG_LS_IPOPT */
@@ -520,6 +557,14 @@ const char *FLAG_DETAILED_DESC[FLAG_MAX+1] = {
   "  Outputs detailed information about solving process of non-linear systems into csv files.",
   /* FLAG_NLS_LS */
   "  Value specifies the linear solver used by the non-linear solver:",
+  /* FLAG_NLS_WARM_START */
+  "  Value specifies a file with converged solutions of the non-linear systems.\n"
+  "  If the file exists the solutions are read and used as initial guess for the\n"
+  "  non-linear systems whenever there are no recent solutions of the current run\n"
+  "  to extrapolate from, e.g. during initialization.\n"
+  "  At the end of the simulation the solutions of the current run are written to\n"
+  "  the file, so repeated simulations of the same model (parameter studies,\n"
+  "  restarts) start with better guesses.",
   /* FLAG_NLSS_MAX_DENSITY */
   "  Value specifies the maximum density for using a non-linear sparse solver.\n"
   "  The value is a Double with default value " EXPANDSTRING(DEFAULT_FLAG_NLSS_MAX_DENSITY) ".",
@@ -644,6 +689,9 @@ const flag_repeat_policy FLAG_REPEAT_POLICIES[FLAG_MAX] = {
 
   /* FLAG_ABORT_SLOW */                   FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_ALARM */                        FLAG_REPEAT_POLICY_FORBID,
+  /* FLAG_ASYNC_OUTPUT */                 FLAG_REPEAT_POLICY_FORBID,
+  /* FLAG_BATCH */                        FLAG_REPEAT_POLICY_FORBID,
+  /* FLAG_BATCH_PROCESSES */              FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_CLOCK */                        FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_CPU */                          FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_CSV_OSTEP */                    FLAG_REPEAT_POLICY_FORBID,
@@ -651,11 +699,13 @@ const flag_repeat_policy FLAG_REPEAT_POLICIES[FLAG_MAX] = {
   /* FLAG_CVODE_LMM */                    FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_DATA_RECONCILE_Cx */            FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_DAE_MODE */                     FLAG_REPEAT_POLICY_FORBID,
+  /* FLAG_DECODE_LOG */                   FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_DELTA_X_LINEARIZE */            FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_DELTA_X_SOLVER */               FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_EMBEDDED_SERVER */              FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_EMBEDDED_SERVER_PORT */         FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_MAT_SYNC */                     FLAG_REPEAT_POLICY_FORBID,
+  /* FLAG_MAT_COLUMN_MAJOR */             FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_EMIT_PROTECTED */               FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_DATA_RECONCILE_Eps */           FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_F */                            FLAG_REPEAT_POLICY_FORBID,
@@ -726,6 +776,7 @@ const flag_repeat_policy FLAG_REPEAT_POLICIES[FLAG_MAX] = {
   /* FLAG_NLS */                          FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_NLS_INFO */                     FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_NLS_LS */                       FLAG_REPEAT_POLICY_FORBID,
+  /* FLAG_NLS_WARM_START */               FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_NLSS_MAX_DENSITY */             FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_NLSS_MIN_SIZE */                FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_NOEMIT */                       FLAG_REPEAT_POLICY_FORBID,
@@ -778,6 +829,9 @@ const int FLAG_TYPE[FLAG_MAX] = {
 
   /* FLAG_ABORT_SLOW */                   FLAG_TYPE_FLAG,
   /* FLAG_ALARM */                        FLAG_TYPE_OPTION,
+  /* FLAG_ASYNC_OUTPUT */                 FLAG_TYPE_FLAG,
+  /* FLAG_BATCH */                        FLAG_TYPE_OPTION,
+  /* FLAG_BATCH_PROCESSES */              FLAG_TYPE_OPTION,
   /* FLAG_CLOCK */                        FLAG_TYPE_OPTION,
   /* FLAG_CPU */                          FLAG_TYPE_FLAG,
   /* FLAG_CSV_OSTEP */                    FLAG_TYPE_OPTION,
@@ -785,11 +839,13 @@ const int FLAG_TYPE[FLAG_MAX] = {
   /* FLAG_CVODE_LMM */                    FLAG_TYPE_OPTION,
   /* FLAG_DATA_RECONCILE_Cx */            FLAG_TYPE_OPTION,
   /* FLAG_DAE_SOLVING */                  FLAG_TYPE_FLAG,
+  /* FLAG_DECODE_LOG */                   FLAG_TYPE_OPTION,
   /* FLAG_DELTA_X_LINEARIZE */            FLAG_TYPE_OPTION,
   /* FLAG_DELTA_X_SOLVER */               FLAG_TYPE_OPTION,
   /* FLAG_EMBEDDED_SERVER */              FLAG_TYPE_OPTION,
   /* FLAG_EMBEDDED_SERVER_PORT */         FLAG_TYPE_OPTION,
   /* FLAG_MAT_SYNC */                     FLAG_TYPE_OPTION,
+  /* FLAG_MAT_COLUMN_MAJOR */             FLAG_TYPE_FLAG,
   /* FLAG_EMIT_PROTECTED */               FLAG_TYPE_FLAG,
   /* FLAG_DATA_RECONCILE_Eps */           FLAG_TYPE_OPTION,
   /* FLAG_F */                            FLAG_TYPE_OPTION,
@@ -860,6 +916,7 @@ const int FLAG_TYPE[FLAG_MAX] = {
   /* FLAG_NLS */                          FLAG_TYPE_OPTION,
   /* FLAG_NLS_INFO */                     FLAG_TYPE_FLAG,
   /* FLAG_NLS_LS */                       FLAG_TYPE_OPTION,
+  /* FLAG_NLS_WARM_START */               FLAG_TYPE_OPTION,
   /* FLAG_NLSS_MAX_DENSITY */             FLAG_TYPE_OPTION,
   /* FLAG_NLSS_MIN_SIZE */                FLAG_TYPE_OPTION,
   /* FLAG_NOEMIT */                       FLAG_TYPE_FLAG,
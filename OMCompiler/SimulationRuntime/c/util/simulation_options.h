@@ -52,6 +52,9 @@ enum _FLAG
 
   FLAG_ABORT_SLOW,
   FLAG_ALARM,
+  FLAG_ASYNC_OUTPUT,
+  FLAG_BATCH,
+  FLAG_BATCH_PROCESSES,
   FLAG_CLOCK,
   FLAG_CPU,
   FLAG_CSV_OSTEP,
@@ -59,11 +62,13 @@ enum _FLAG
   FLAG_CVODE_LMM,
   FLAG_DATA_RECONCILE_Cx,
   FLAG_DAE_MODE,
+  FLAG_DECODE_LOG,
   FLAG_DELTA_X_LINEARIZE,
   FLAG_DELTA_X_SOLVER,
   FLAG_EMBEDDED_SERVER,
   FLAG_EMBEDDED_SERVER_PORT,
   FLAG_MAT_SYNC,
+  FLAG_MAT_COLUMN_MAJOR,
   FLAG_EMIT_PROTECTED,
   FLAG_DATA_RECONCILE_Eps,
   FLAG_F,
@@ -134,6 +139,7 @@ enum _FLAG
   FLAG_NLS,
   FLAG_NLS_INFO,
   FLAG_NLS_LS,
+  FLAG_NLS_WARM_START,
   FLAG_NLSS_MAX_DENSITY,
   FLAG_NLSS_MIN_SIZE,
   FLAG_NOEMIT,
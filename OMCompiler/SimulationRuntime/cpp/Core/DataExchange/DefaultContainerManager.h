@@ -35,6 +35,12 @@ class DefaultContainerManager : public Writer
     virtual ~DefaultContainerManager()
     {
     }
+    /**
+     * Nothing to do, all containers are written directly.
+     */
+    void finishWriting()
+    {
+    }
     /**
      * Get the internal container. It is always the same.
      * @return A reference to the internal container that can be filled with values.
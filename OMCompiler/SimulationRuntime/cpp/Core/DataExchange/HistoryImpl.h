@@ -28,7 +28,8 @@ public:
 
   virtual ~HistoryImpl()
   {
-
+    // write queued output before the results policy closes its file
+    ResultsPolicy::finishWriting();
   }
 
   /*
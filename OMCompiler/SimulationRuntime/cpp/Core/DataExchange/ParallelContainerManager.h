@@ -7,95 +7,194 @@
 #include <Core/Modelica.h>
 #include <Core/ModelicaDefine.h>
 
-#define CONTAINER_COUNT 3
+/** default number of output slots between the solver and the writer thread, can be overridden at compile time */
+#ifndef PARALLEL_OUTPUT_DEPTH
+#define PARALLEL_OUTPUT_DEPTH 64
+#endif
 
 /**
- * This container manager is designed to write simulation results in parallel. It has multiple data containers that
- * can be filled with values. The write routine works asynchronously with the help of a consumer-producer-queue.
+ * This container manager is designed to write simulation results in parallel. The solver thread copies the values
+ * of all output variables into a preallocated slot of a bounded single-producer/single-consumer ring, the writer
+ * thread takes the slots out of the ring and writes them to the result file. The ring indices are atomics, a mutex
+ * and condition variable are only touched if one of the two threads has to sleep, i.e. if the ring runs empty or full.
  */
 class ParallelContainerManager : public Writer
 {
   private:
-    deque<write_data_t > _writeContainers;
-    deque<write_data_t > _freeContainers;
-    semaphore _freeContainerMutex;
-    semaphore _writeContainerMutex;
-    semaphore _nempty;
+    /**
+     * One entry of the ring. The pointer vectors of the container point into the value buffers of the same slot,
+     * so the writer sees the values of the time step they were copied in and not the current simulation values.
+     */
+    struct OutputSlot
+    {
+      write_data_t container;
+      boost::container::vector<double> realValues;
+      boost::container::vector<int> intValues;
+      boost::container::vector<bool> boolValues;
+      boost::container::vector<double> derValues;
+      boost::container::vector<double> resValues;
+    };
+
+    vector<OutputSlot> _slots;
+    const size_t _depth;
+    /** index of the next slot filled by the producer, only written by the solver thread */
+    atomic<size_t> _head;
+    /** index of the next slot written by the consumer, only written by the writer thread */
+    atomic<size_t> _tail;
+    atomic<bool> _writerWaiting;
+    atomic<bool> _producerWaiting;
+    atomic<bool> _threadWorkDone;
+    size_t _producerStalls;
+    /** container handed out by getFreeContainer, only used by the solver thread */
+    write_data_t _stagingContainer;
+    mutex _waitMutex;
+    condition_variable _writerCondition;
+    condition_variable _producerCondition;
     thread _writerThread;
-    bool _threadWorkDone;
 
-  protected:
-    void writeThread()
+    /**
+     * Copy the current values of the variables referenced by src into values and let dst point to them.
+     */
+    template<typename T>
+    static void copyValues(const boost::container::vector<const T*>& src, boost::container::vector<T>& values,
+                           boost::container::vector<const T*>& dst)
     {
-      std::cerr << "Parallel writer thread used" << std::endl;
-      while(!_threadWorkDone)
-        writeContainer();
-
-      while(!_writeContainers.empty())
-        writeContainer();
+      size_t n = src.size();
+      values.resize(n);
+      for (size_t i = 0; i < n; i++)
+        values[i] = *src[i];
+      if (dst.size() != n || (n > 0 && dst[0] != &values[0]))
+      {
+        dst.resize(n);
+        for (size_t i = 0; i < n; i++)
+          dst[i] = &values[i];
+      }
     }
 
-    void writeContainer()
+    static void copyContainer(const write_data_t& container, OutputSlot& slot)
     {
-      const write_data_t* container;
-
-      _writeContainerMutex.wait();
-      if (!_writeContainers.empty())
-        container = &_writeContainers.front();
-
-      _writeContainerMutex.post();
+      const all_vars_time_t& src = get<0>(container);
+      all_vars_time_t& dst = get<0>(slot.container);
+
+      copyValues(get<0>(src), slot.realValues, get<0>(dst));
+      copyValues(get<1>(src), slot.intValues, get<1>(dst));
+      copyValues(get<2>(src), slot.boolValues, get<2>(dst));
+      get<3>(dst) = get<3>(src);
+      copyValues(get<4>(src), slot.derValues, get<4>(dst));
+      copyValues(get<5>(src), slot.resValues, get<5>(dst));
+      get<1>(slot.container) = get<1>(container);
+    }
 
-      if (!container)
+  protected:
+    void writeThread()
+    {
+      while (true)
       {
-        usleep(5);
-        return;
+        size_t tail = _tail.load(memory_order_relaxed);
+        if (tail == _head.load())
+        {
+          if (_threadWorkDone.load() && tail == _head.load())
+            break;
+
+          unique_lock<mutex> lock(_waitMutex);
+          _writerWaiting.store(true);
+          while (tail == _head.load() && !_threadWorkDone.load())
+            _writerCondition.wait(lock);
+          _writerWaiting.store(false);
+          continue;
+        }
+
+        const write_data_t& container = _slots[tail % _depth].container;
+        write(get<0>(container), get<1>(container));
+        _tail.store(tail + 1);
+
+        if (_producerWaiting.load())
+        {
+          unique_lock<mutex> lock(_waitMutex);
+          _producerCondition.notify_one();
+        }
       }
-
-      write(get<0>(*container),get<1>(*container));
-
-      _writeContainerMutex.wait();
-      _writeContainers.pop_front();
-      _writeContainerMutex.post();
-
-      _freeContainerMutex.wait();
-      _freeContainers.push_back(*container);
-      _freeContainerMutex.post();
-      _nempty.post();
     }
 
   public:
-    ParallelContainerManager() : Writer()
-      , _writeContainers()
-      ,_freeContainers()
-      ,_freeContainerMutex(1)
-      ,_writeContainerMutex(1)
-      ,_nempty(CONTAINER_COUNT)
-      ,_writerThread(&ParallelContainerManager::writeThread, this)
-      ,_threadWorkDone(false)
+    /**
+     * @param depth Number of output slots that can be queued before the solver thread has to wait for the writer.
+     */
+    ParallelContainerManager(size_t depth = PARALLEL_OUTPUT_DEPTH) : Writer()
+      , _slots(depth > 0 ? depth : 1)
+      , _depth(depth > 0 ? depth : 1)
+      , _head(0)
+      , _tail(0)
+      , _writerWaiting(false)
+      , _producerWaiting(false)
+      , _threadWorkDone(false)
+      , _producerStalls(0)
+      , _stagingContainer()
+      , _waitMutex()
+      , _writerCondition()
+      , _producerCondition()
+      , _writerThread(&ParallelContainerManager::writeThread, this)
     {
     }
 
     virtual ~ParallelContainerManager()
     {
-      _threadWorkDone = true;
+      finishWriting();
+    }
+
+    /**
+     * Write all queued containers and stop the writer thread. Has to be called before the result file is closed.
+     */
+    void finishWriting()
+    {
+      if (!_writerThread.joinable())
+        return;
+      {
+        unique_lock<mutex> lock(_waitMutex);
+        _threadWorkDone.store(true);
+        _writerCondition.notify_one();
+      }
       _writerThread.join();
     }
 
-    virtual write_data_t& getFreeContainer()
+    /**
+     * @return Number of times the solver thread found the ring full and had to wait for the writer thread.
+     */
+    size_t getProducerStalls() const
     {
-      _nempty.wait();
-      _freeContainerMutex.wait();
+      return _producerStalls;
+    }
 
-       write_data_t& container = _freeContainers.front();
-      _freeContainers.pop_front();
-      _freeContainerMutex.post();
+    virtual write_data_t& getFreeContainer()
+    {
+      return _stagingContainer;
+    };
+
+    /**
+     * Copy the values referenced by the given container into the next free slot and hand it to the writer thread.
+     * @param container The container that should be written.
+     */
+    virtual void addContainerToWriteQueue(const write_data_t& container)
+    {
+      size_t head = _head.load(memory_order_relaxed);
+      if (head - _tail.load() == _depth)
+      {
+        _producerStalls++;
+        unique_lock<mutex> lock(_waitMutex);
+        _producerWaiting.store(true);
+        while (head - _tail.load() == _depth)
+          _producerCondition.wait(lock);
+        _producerWaiting.store(false);
+      }
 
-      return container;
-  };
+      copyContainer(container, _slots[head % _depth]);
+      _head.store(head + 1);
 
-  virtual void addContainerToWriteQueue(const write_data_t& container)
-  {
-    _writeContainers.push_back(container);
-  };
+      if (_writerWaiting.load())
+      {
+        unique_lock<mutex> lock(_waitMutex);
+        _writerCondition.notify_one();
+      }
+    };
 };
 /** @} */ // end of dataexchange
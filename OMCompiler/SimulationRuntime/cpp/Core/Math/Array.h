@@ -2167,10 +2167,10 @@ class DynArray : public BaseArray<T>
    */
   DynArray()
     :BaseArray<T>(false,false)
-    ,_dims(ndims)
   {
     _array_data = NULL;
     _nelems = 0;
+    std::fill(_dims, _dims + ndims, 0);
   }
 
   /**
@@ -2178,10 +2178,10 @@ class DynArray : public BaseArray<T>
    */
   DynArray(const DynArray<T, ndims>& dynarray)
     :BaseArray<T>(false,false)
-    ,_dims(ndims)
   {
     _array_data = NULL;
     _nelems = 0;
+    std::fill(_dims, _dims + ndims, 0);
     assign(dynarray);
   }
 
@@ -2190,10 +2190,10 @@ class DynArray : public BaseArray<T>
    */
   DynArray(const BaseArray<T>& b)
     :BaseArray<T>(false,false)
-    ,_dims(ndims)
   {
     _array_data = NULL;
     _nelems = 0;
+    std::fill(_dims, _dims + ndims, 0);
     assign(b);
   }
 
@@ -2225,22 +2225,7 @@ class DynArray : public BaseArray<T>
   {
     if (dims.size() != ndims)
       throw std::runtime_error("Can't change dimensionality of DynArray");
-    if (dims != _dims) {
-      size_t nelems = 0;
-      if (dims.size() > 0)
-        nelems = std::accumulate(dims.begin(), dims.end(),
-                                 1, std::multiplies<size_t>());
-      if (nelems != _nelems) {
-        if (_array_data != NULL)
-          delete [] _array_data;
-        if (nelems > 0)
-          _array_data = new T[nelems];
-        else
-          _array_data = NULL;
-        _nelems = nelems;
-      }
-      _dims = dims;
-    }
+    resizeDims(dims.data());
   }
 
   virtual void setDims(const std::vector<size_t>& dims)
@@ -2250,7 +2235,7 @@ class DynArray : public BaseArray<T>
 
   virtual std::vector<size_t> getDims() const
   {
-    return _dims;
+    return std::vector<size_t>(_dims, _dims + ndims);
   }
 
   virtual int getDim(size_t dim) const
@@ -2295,9 +2280,33 @@ class DynArray : public BaseArray<T>
   }
 
  protected:
+  /**
+   * Resize without building a dims vector, used by the setDims
+   * methods of the specialized classes
+   * @param dims sizes of the ndims dimensions
+   */
+  void resizeDims(const size_t* dims)
+  {
+    if (!std::equal(_dims, _dims + ndims, dims)) {
+      size_t nelems = ndims > 0 ? 1 : 0;
+      for (size_t dim = 0; dim < ndims; dim++)
+        nelems *= dims[dim];
+      if (nelems != _nelems) {
+        if (_array_data != NULL)
+          delete [] _array_data;
+        if (nelems > 0)
+          _array_data = new T[nelems];
+        else
+          _array_data = NULL;
+        _nelems = nelems;
+      }
+      std::copy(dims, dims + ndims, _dims);
+    }
+  }
+
   T *_array_data;
   size_t _nelems;
-  std::vector<size_t> _dims;
+  size_t _dims[ndims > 0 ? ndims : 1]; // stored inline, arrays have few dimensions
 };
 
 /**
@@ -2326,17 +2335,15 @@ class DynArrayDim1 : public DynArray<T, 1>
   DynArrayDim1(size_t size1)
     :DynArray<T, 1>()
   {
-    std::vector<size_t> dims;
-    dims.push_back(size1);
-    this->resize(dims);
+    size_t dims[] = {size1};
+    this->resizeDims(dims);
   }
 
   DynArrayDim1(size_t size1, const T *data)
     :DynArray<T, 1>()
   {
-    std::vector<size_t> dims;
-    dims.push_back(size1);
-    this->resize(dims);
+    size_t dims[] = {size1};
+    this->resizeDims(dims);
     if (size1 > 0)
       std::copy(data, data + size1, this->_array_data);
   }
@@ -2377,9 +2384,8 @@ class DynArrayDim1 : public DynArray<T, 1>
 
   void setDims(size_t size1)
   {
-    std::vector<size_t> dims;
-    dims.push_back(size1);
-    this->resize(dims);
+    size_t dims[] = {size1};
+    this->resizeDims(dims);
   }
 
   virtual void setDims(const std::vector<size_t>& dims)
@@ -2428,10 +2434,8 @@ class DynArrayDim2 : public DynArray<T, 2>
   DynArrayDim2(size_t size1, size_t size2)
     :DynArray<T, 2>()
   {
-    std::vector<size_t> dims;
-    dims.push_back(size1);
-    dims.push_back(size2);
-    this->resize(dims);
+    size_t dims[] = {size1, size2};
+    this->resizeDims(dims);
   }
 
   virtual ~DynArrayDim2() {}
@@ -2497,10 +2501,8 @@ class DynArrayDim2 : public DynArray<T, 2>
 
   void setDims(size_t size1, size_t size2)
   {
-    std::vector<size_t> dims;
-    dims.push_back(size1);
-    dims.push_back(size2);
-    this->resize(dims);
+    size_t dims[] = {size1, size2};
+    this->resizeDims(dims);
   }
   virtual void setDims(const std::vector<size_t>& dims)
   {
@@ -2529,11 +2531,8 @@ public:
   DynArrayDim3(size_t size1, size_t size2, size_t size3)
     :DynArray<T, 3>()
   {
-    std::vector<size_t> dims;
-    dims.push_back(size1);
-    dims.push_back(size2);
-    dims.push_back(size3);
-    this->resize(dims);
+    size_t dims[] = {size1, size2, size3};
+    this->resizeDims(dims);
   }
 
   virtual ~DynArrayDim3() {}
@@ -2546,11 +2545,8 @@ public:
 
   void setDims(size_t size1, size_t size2, size_t size3)
   {
-    std::vector<size_t> dims;
-    dims.push_back(size1);
-    dims.push_back(size2);
-    dims.push_back(size3);
-    this->resize(dims);
+    size_t dims[] = {size1, size2, size3};
+    this->resizeDims(dims);
   }
   virtual void setDims(const std::vector<size_t>& dims)
   {
@@ -2560,28 +2556,28 @@ public:
   virtual const T& operator()(const vector<size_t>& idx) const
   {
     //return _multi_array[idx[0]-1][idx[1]-1][idx[2]-1];
-    const std::vector<size_t>& shape = this->_dims;
+    const size_t* shape = this->_dims;
     return this->_array_data[idx[0]-1 + shape[0]*(idx[1]-1 + shape[1]*(idx[2]-1))];
   }
 
   virtual T& operator()(const vector<size_t>& idx)
   {
     //return _multi_array[idx[0]-1][idx[1]-1][idx[2]-1];
-    const std::vector<size_t>& shape = this->_dims;
+    const size_t* shape = this->_dims;
     return this->_array_data[idx[0]-1 + shape[0]*(idx[1]-1 + shape[1]*(idx[2]-1))];
   }
 
   inline virtual T& operator()(size_t i, size_t j, size_t k)
   {
     //return _multi_array[i-1][j-1][k-1];
-    const std::vector<size_t>& shape = this->_dims;
+    const size_t* shape = this->_dims;
     return this->_array_data[i-1 + shape[0]*(j-1 + shape[1]*(k-1))];
   }
 
   inline virtual const T& operator()(size_t i, size_t j, size_t k) const
   {
     //return _multi_array[i-1][j-1][k-1];
-    const std::vector<size_t>& shape = this->_dims;
+    const size_t* shape = this->_dims;
     return this->_array_data[i-1 + shape[0]*(j-1 + shape[1]*(k-1))];
   }
 };
@@ -2607,12 +2603,8 @@ public:
   DynArrayDim4(size_t size1, size_t size2, size_t size3, size_t size4)
     :DynArray<T, 4>()
   {
-    std::vector<size_t> dims;
-    dims.push_back(size1);
-    dims.push_back(size2);
-    dims.push_back(size3);
-    dims.push_back(size4);
-    this->resize(dims);
+    size_t dims[] = {size1, size2, size3, size4};
+    this->resizeDims(dims);
   }
 
   virtual ~DynArrayDim4() {}
@@ -2625,12 +2617,8 @@ public:
 
   void setDims(size_t size1, size_t size2, size_t size3, size_t size4)
   {
-    std::vector<size_t> dims;
-    dims.push_back(size1);
-    dims.push_back(size2);
-    dims.push_back(size3);
-    dims.push_back(size4);
-    this->resize(dims);
+    size_t dims[] = {size1, size2, size3, size4};
+    this->resizeDims(dims);
   }
   virtual void setDims(const std::vector<size_t>& dims)
   {
@@ -2640,28 +2628,28 @@ public:
   virtual const T& operator()(const vector<size_t>& idx) const
   {
     //return _multi_array[idx[0]-1][idx[1]-1][idx[2]-1][idx[3]-1];
-    const std::vector<size_t>& shape = this->_dims;
+    const size_t* shape = this->_dims;
     return this->_array_data[idx[0]-1 + shape[0]*(idx[1]-1 + shape[1]*(idx[2]-1 + shape[2]*(idx[3]-1)))];
   }
 
   virtual T& operator()(const vector<size_t>& idx)
   {
     //return _multi_array[idx[0]-1][idx[1]-1][idx[2]-1][idx[3]-1];
-    const std::vector<size_t>& shape = this->_dims;
+    const size_t* shape = this->_dims;
     return this->_array_data[idx[0]-1 + shape[0]*(idx[1]-1 + shape[1]*(idx[2]-1 + shape[2]*(idx[3]-1)))];
   }
 
   inline virtual T& operator()(size_t i, size_t j, size_t k, size_t l)
   {
     //return _multi_array[i-1][j-1][k-1][l-1];
-    const std::vector<size_t>& shape = this->_dims;
+    const size_t* shape = this->_dims;
     return this->_array_data[i-1 + shape[0]*(j-1 + shape[1]*(k-1 + shape[2]*(l-1)))];
   }
 
   inline virtual const T& operator()(size_t i, size_t j, size_t k, size_t l) const
   {
     //return _multi_array[i-1][j-1][k-1][l-1];
-    const std::vector<size_t>& shape = this->_dims;
+    const size_t* shape = this->_dims;
     return this->_array_data[i-1 + shape[0]*(j-1 + shape[1]*(k-1 + shape[2]*(l-1)))];
   }
 };
@@ -2687,13 +2675,8 @@ public:
   DynArrayDim5(size_t size1, size_t size2, size_t size3, size_t size4, size_t size5)
     :DynArray<T, 5>()
   {
-    std::vector<size_t> dims;
-    dims.push_back(size1);
-    dims.push_back(size2);
-    dims.push_back(size3);
-    dims.push_back(size4);
-    dims.push_back(size5);
-    this->resize(dims);
+    size_t dims[] = {size1, size2, size3, size4, size5};
+    this->resizeDims(dims);
   }
 
   virtual ~DynArrayDim5() {}
@@ -2706,13 +2689,8 @@ public:
 
   void setDims(size_t size1, size_t size2, size_t size3, size_t size4, size_t size5)
   {
-    std::vector<size_t> dims;
-    dims.push_back(size1);
-    dims.push_back(size2);
-    dims.push_back(size3);
-    dims.push_back(size4);
-    dims.push_back(size5);
-    this->resize(dims);
+    size_t dims[] = {size1, size2, size3, size4, size5};
+    this->resizeDims(dims);
   }
   virtual void setDims(const std::vector<size_t>& dims)
   {
@@ -2722,28 +2700,28 @@ public:
   virtual const T& operator()(const vector<size_t>& idx) const
   {
     //return _multi_array[idx[0]-1][idx[1]-1][idx[2]-1][idx[3]-1][idx[4]-1];
-    const std::vector<size_t>& shape = this->_dims;
+    const size_t* shape = this->_dims;
     return this->_array_data[idx[0]-1 + shape[0]*(idx[1]-1 + shape[1]*(idx[2]-1 + shape[2]*(idx[3]-1 + shape[3]*(idx[4]-1))))];
   }
 
   virtual T& operator()(const vector<size_t>& idx)
   {
     //return _multi_array[idx[0]-1][idx[1]-1][idx[2]-1][idx[3]-1][idx[4]-1];
-    const std::vector<size_t>& shape = this->_dims;
+    const size_t* shape = this->_dims;
     return this->_array_data[idx[0]-1 + shape[0]*(idx[1]-1 + shape[1]*(idx[2]-1 + shape[2]*(idx[3]-1 + shape[3]*(idx[4]-1))))];
   }
 
   inline virtual T& operator()(size_t i, size_t j, size_t k, size_t l, size_t m)
   {
     //return _multi_array[i-1][j-1][k-1][l-1][m-1];
-    const std::vector<size_t>& shape = this->_dims;
+    const size_t* shape = this->_dims;
     return this->_array_data[i-1 + shape[0]*(j-1 + shape[1]*(k-1 + shape[2]*(l-1 + shape[3]*(m-1))))];
   }
 
   inline virtual const T& operator()(size_t i, size_t j, size_t k, size_t l, size_t m) const
   {
     //return _multi_array[i-1][j-1][k-1][l-1][m-1];
-    const std::vector<size_t>& shape = this->_dims;
+    const size_t* shape = this->_dims;
     return this->_array_data[i-1 + shape[0]*(j-1 + shape[1]*(k-1 + shape[2]*(l-1 + shape[3]*(m-1))))];
   }
 };
@@ -2769,14 +2747,8 @@ public:
   DynArrayDim6(size_t size1, size_t size2, size_t size3, size_t size4, size_t size5, size_t size6)
     :DynArray<T, 6>()
   {
-    std::vector<size_t> dims;
-    dims.push_back(size1);
-    dims.push_back(size2);
-    dims.push_back(size3);
-    dims.push_back(size4);
-    dims.push_back(size5);
-    dims.push_back(size6);
-    this->resize(dims);
+    size_t dims[] = {size1, size2, size3, size4, size5, size6};
+    this->resizeDims(dims);
   }
 
   virtual ~DynArrayDim6() {}
@@ -2789,14 +2761,8 @@ public:
 
   void setDims(size_t size1, size_t size2, size_t size3, size_t size4, size_t size5, size_t size6)
   {
-    std::vector<size_t> dims;
-    dims.push_back(size1);
-    dims.push_back(size2);
-    dims.push_back(size3);
-    dims.push_back(size4);
-    dims.push_back(size5);
-    dims.push_back(size6);
-    this->resize(dims);
+    size_t dims[] = {size1, size2, size3, size4, size5, size6};
+    this->resizeDims(dims);
   }
   virtual void setDims(const std::vector<size_t>& dims)
   {
@@ -2806,28 +2772,28 @@ public:
   virtual const T& operator()(const vector<size_t>& idx) const
   {
     //return _multi_array[idx[0]-1][idx[1]-1][idx[2]-1][idx[3]-1][idx[4]-1][idx[5]-1];
-    const std::vector<size_t>& shape = this->_dims;
+    const size_t* shape = this->_dims;
     return this->_array_data[idx[0]-1 + shape[0]*(idx[1]-1 + shape[1]*(idx[2]-1 + shape[2]*(idx[3]-1 + shape[3]*(idx[4]-1 + shape[4]*(idx[5]-1)))))];
   }
 
   virtual T& operator()(const vector<size_t>& idx)
   {
     //return _multi_array[idx[0]-1][idx[1]-1][idx[2]-1][idx[3]-1][idx[4]-1][idx[5]-1];
-    const std::vector<size_t>& shape = this->_dims;
+    const size_t* shape = this->_dims;
     return this->_array_data[idx[0]-1 + shape[0]*(idx[1]-1 + shape[1]*(idx[2]-1 + shape[2]*(idx[3]-1 + shape[3]*(idx[4]-1 + shape[4]*(idx[5]-1)))))];
   }
 
   inline virtual T& operator()(size_t i, size_t j, size_t k, size_t l, size_t m, size_t n)
   {
     //return _multi_array[i-1][j-1][k-1][l-1][m-1][n-1];
-    const std::vector<size_t>& shape = this->_dims;
+    const size_t* shape = this->_dims;
     return this->_array_data[i-1 + shape[0]*(j-1 + shape[1]*(k-1 + shape[2]*(l-1 + shape[3]*(m-1 + shape[4]*(n-1)))))];
   }
 
   inline virtual const T& operator()(size_t i, size_t j, size_t k, size_t l, size_t m, size_t n) const
   {
     //return _multi_array[i-1][j-1][k-1][l-1][m-1][n-1];
-    const std::vector<size_t>& shape = this->_dims;
+    const size_t* shape = this->_dims;
     return this->_array_data[i-1 + shape[0]*(j-1 + shape[1]*(k-1 + shape[2]*(l-1 + shape[3]*(m-1 + shape[4]*(n-1)))))];
   }
 };
@@ -6,7 +6,12 @@
 #include <Core/Modelica.h>
 #include <Core/Math/ArrayOperations.h>
 #include <Core/Math/ArraySlice.h>
+#include <Core/Math/ArrayView.h>
+#ifdef USE_BLAS
+#include <Core/Math/IBlas.h>
+#endif
 #include <sstream>
+#include <memory>
 #include <stdio.h>
 
 using namespace std;
@@ -125,6 +130,16 @@ void transpose_array(const BaseArray<T>& x, BaseArray<T>& a)
   vector<size_t> ex = x.getDims();
   std::swap(ex[0], ex[1]);
   a.setDims(ex);
+  if (ndims == 2 && !a.isRefArray()) {
+    // walk down the columns of a, x is read through a transposed view
+    ArrayView<T, 2> av(a);
+    ArrayView<const T, 2> xt = ArrayView<const T, 2>(x).transpose();
+    size_t m = av.getDim(1), n = av.getDim(2);
+    for (size_t j = 1; j <= n; j++)
+      for (size_t i = 1; i <= m; i++)
+        av(i, j) = xt(i, j);
+    return;
+  }
   vector<Slice> sx(ndims);
   vector<Slice> sa(ndims);
   for (int i = 1; i <= x.getDim(1); i++) {
@@ -146,6 +161,131 @@ void multiply_array(const BaseArray<T>& inputArray, const T &b, BaseArray<T>& ou
   }
 };
 
+/* block sizes of the matrix product, chosen such that a block of the left
+   matrix and a column of the result stay in the L1/L2 cache */
+#define MULTIPLY_BLOCK_N 64
+#define MULTIPLY_BLOCK_K 128
+/* below these numbers of multiply-adds the BLAS call overhead dominates */
+#define MULTIPLY_BLAS_GEMM_THRESHOLD (64 * 64 * 64)
+#define MULTIPLY_BLAS_GEMV_THRESHOLD (128 * 128)
+
+/**
+ * Column-major matrix product c(m,n) = a(m,k) * b(k,n). The innermost loop
+ * walks down contiguous columns of a and c, the outer loops are blocked.
+ */
+template <typename T>
+static void multiply_matrix_matrix_loops(size_t m, size_t n, size_t k, const T* a, const T* b, T* c)
+{
+  std::fill(c, c + m * n, T());
+  for (size_t j0 = 0; j0 < n; j0 += MULTIPLY_BLOCK_N) {
+    size_t j1 = std::min(j0 + MULTIPLY_BLOCK_N, n);
+    for (size_t p0 = 0; p0 < k; p0 += MULTIPLY_BLOCK_K) {
+      size_t p1 = std::min(p0 + MULTIPLY_BLOCK_K, k);
+      for (size_t j = j0; j < j1; j++) {
+        T* cj = c + j * m;
+        for (size_t p = p0; p < p1; p++) {
+          const T bpj = b[p + j * k];
+          const T* ap = a + p * m;
+          for (size_t i = 0; i < m; i++)
+            cj[i] += ap[i] * bpj;
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Column-major matrix vector product y(m) = a(m,k) * x(k)
+ */
+template <typename T>
+static void multiply_matrix_vector_loops(size_t m, size_t k, const T* a, const T* x, T* y)
+{
+  std::fill(y, y + m, T());
+  for (size_t p = 0; p < k; p++) {
+    const T xp = x[p];
+    const T* ap = a + p * m;
+    for (size_t i = 0; i < m; i++)
+      y[i] += ap[i] * xp;
+  }
+}
+
+/**
+ * Column-major vector matrix product y(n) = x(k) * b(k,n)
+ */
+template <typename T>
+static void multiply_vector_matrix_loops(size_t n, size_t k, const T* x, const T* b, T* y)
+{
+  for (size_t j = 0; j < n; j++) {
+    const T* bj = b + j * k;
+    T val = T();
+    for (size_t p = 0; p < k; p++)
+      val += x[p] * bj[p];
+    y[j] = val;
+  }
+}
+
+template <typename T>
+static void multiply_matrix_matrix(size_t m, size_t n, size_t k, const T* a, const T* b, T* c)
+{
+  multiply_matrix_matrix_loops(m, n, k, a, b, c);
+}
+
+template <typename T>
+static void multiply_matrix_vector(size_t m, size_t k, const T* a, const T* x, T* y)
+{
+  multiply_matrix_vector_loops(m, k, a, x, y);
+}
+
+template <typename T>
+static void multiply_vector_matrix(size_t n, size_t k, const T* x, const T* b, T* y)
+{
+  multiply_vector_matrix_loops(n, k, x, b, y);
+}
+
+#ifdef USE_BLAS
+template <>
+void multiply_matrix_matrix<double>(size_t m, size_t n, size_t k, const double* a, const double* b, double* c)
+{
+  if (m * n * k < MULTIPLY_BLAS_GEMM_THRESHOLD) {
+    multiply_matrix_matrix_loops(m, n, k, a, b, c);
+    return;
+  }
+  char trans = 'N';
+  long int M = m, N = n, K = k;
+  double alpha = 1.0, beta = 0.0;
+  dgemm_(&trans, &trans, &M, &N, &K, &alpha, const_cast<double*>(a), &M,
+         const_cast<double*>(b), &K, &beta, c, &M);
+}
+
+template <>
+void multiply_matrix_vector<double>(size_t m, size_t k, const double* a, const double* x, double* y)
+{
+  if (m * k < MULTIPLY_BLAS_GEMV_THRESHOLD) {
+    multiply_matrix_vector_loops(m, k, a, x, y);
+    return;
+  }
+  char trans = 'N';
+  long int M = m, K = k, inc = 1;
+  double alpha = 1.0, beta = 0.0;
+  dgemv_(&trans, &M, &K, &alpha, const_cast<double*>(a), &M,
+         const_cast<double*>(x), &inc, &beta, y, &inc);
+}
+
+template <>
+void multiply_vector_matrix<double>(size_t n, size_t k, const double* x, const double* b, double* y)
+{
+  if (n * k < MULTIPLY_BLAS_GEMV_THRESHOLD) {
+    multiply_vector_matrix_loops(n, k, x, b, y);
+    return;
+  }
+  char trans = 'T';
+  long int N = n, K = k, inc = 1;
+  double alpha = 1.0, beta = 0.0;
+  dgemv_(&trans, &K, &N, &alpha, const_cast<double*>(b), &K,
+         const_cast<double*>(x), &inc, &beta, y, &inc);
+}
+#endif
+
 template <typename T>
 void multiply_array(const BaseArray<T> &leftArray, const BaseArray<T> &rightArray, BaseArray<T> &resultArray)
 {
@@ -155,49 +295,40 @@ void multiply_array(const BaseArray<T> &leftArray, const BaseArray<T> &rightArra
   if (leftArray.getDim(leftNumDims) != matchDim)
     throw ModelicaSimulationError(MODEL_ARRAY_FUNCTION,
                                   "Wrong sizes in multiply_array");
-  if (leftNumDims == 1 && rightNumDims == 2) {
-    size_t rightDim = rightArray.getDim(2);
-    vector<size_t> dims;
-    dims.push_back(rightDim);
-    resultArray.setDims(dims);
-    for (size_t j = 1; j <= rightDim; j++) {
-      T val = T();
-      for (size_t k = 1; k <= matchDim; k++)
-        val += leftArray(k) * rightArray(k, j);
-      resultArray(j) = val;
-    }
-  }
-  else if (leftNumDims == 2 && rightNumDims == 1) {
-    size_t leftDim = leftArray.getDim(1);
-    vector<size_t> dims;
-    dims.push_back(leftDim);
-    resultArray.setDims(dims);
-    for (size_t i = 1; i <= leftDim; i++) {
-      T val = T();
-      for (size_t k = 1; k <= matchDim; k++)
-        val += leftArray(i, k) * rightArray(k);
-      resultArray(i) = val;
-    }
-  }
-  else if (leftNumDims == 2 && rightNumDims == 2) {
-    size_t leftDim = leftArray.getDim(1);
-    size_t rightDim = rightArray.getDim(2);
-    vector<size_t> dims;
-    dims.push_back(leftDim);
-    dims.push_back(rightDim);
-    resultArray.setDims(dims);
-    for (size_t i = 1; i <= leftDim; i++) {
-      for (size_t j = 1; j <= rightDim; j++) {
-        T val = T();
-        for (size_t k = 1; k <= matchDim; k++)
-          val += leftArray(i, k) * rightArray(k, j);
-        resultArray(i, j) = val;
-      }
-    }
-  }
-  else
+  if ((leftNumDims != 1 && leftNumDims != 2) ||
+      (rightNumDims != 1 && rightNumDims != 2) ||
+      (leftNumDims == 1 && rightNumDims == 1))
     throw ModelicaSimulationError(MODEL_ARRAY_FUNCTION,
                                   "Unsupported dimensions in multiply_array");
+
+  vector<size_t> dims;
+  if (leftNumDims == 2)
+    dims.push_back(leftArray.getDim(1));
+  if (rightNumDims == 2)
+    dims.push_back(rightArray.getDim(2));
+  resultArray.setDims(dims);
+
+  // the kernels work on contiguous data, reference arrays only provide a copy
+  const T* leftData = leftArray.getData();
+  const T* rightData = rightArray.getData();
+  std::unique_ptr<T[]> refResult;
+  T* resultData;
+  if (resultArray.isRefArray()) {
+    refResult.reset(new T[resultArray.getNumElems()]);
+    resultData = refResult.get();
+  }
+  else
+    resultData = resultArray.getData();
+
+  if (leftNumDims == 1)
+    multiply_vector_matrix(dims[0], matchDim, leftData, rightData, resultData);
+  else if (rightNumDims == 1)
+    multiply_matrix_vector(dims[0], matchDim, leftData, rightData, resultData);
+  else
+    multiply_matrix_matrix(dims[0], dims[1], matchDim, leftData, rightData, resultData);
+
+  if (refResult)
+    resultArray.assign(resultData);
 }
 
 template <typename T>
@@ -393,9 +524,12 @@ cross product of two arrays (a,b type as template parameter)
 template <typename T>
 void cross_array(const BaseArray<T>& a, const BaseArray<T>& b, BaseArray<T>& res)
 {
-  res(1) = (a(2) * b(3)) - (a(3) * b(2));
-  res(2) = (a(3) * b(1)) - (a(1) * b(3));
-  res(3) = (a(1) * b(2)) - (a(2) * b(1));
+  ArrayView<const T, 1> av(a), bv(b);
+  T c[3];
+  c[0] = (av(2) * bv(3)) - (av(3) * bv(2));
+  c[1] = (av(3) * bv(1)) - (av(1) * bv(3));
+  c[2] = (av(1) * bv(2)) - (av(2) * bv(1));
+  res.assign(c);
 };
 
 /**
@@ -424,50 +558,52 @@ void cast_array(const BaseArray<S>& a, BaseArray<T>& b)
 }
 
 /**
- * helper for assignRowMajorData
- * recursive function for muli-dimensional assignment of raw data
+ * helper for assignRowMajorData and convertArrayLayout
+ * calls f(p, q) for all elements of an array with the given dims,
+ * p is the position in row major and q in column major storage
  */
-template <typename T>
-static size_t assignRowMajorDim(size_t dim, const T* data,
-                                BaseArray<T> &array, vector<size_t> &idx) {
-  size_t processed = 0;
-  size_t size = array.getDim(dim);
-  for (size_t i = 1; i <= size; i++) {
-    idx[dim - 1] = i;
-    if (dim < idx.size())
-      processed += assignRowMajorDim(dim + 1, data + processed, array, idx);
-    else
-      array(idx) = data[processed++];
+template <typename F>
+static void forEachRowMajor(const vector<size_t>& dims, F f)
+{
+  size_t ndims = dims.size();
+  size_t nelems = std::accumulate(dims.begin(), dims.end(), (size_t)1, std::multiplies<size_t>());
+  if (ndims == 0 || nelems == 0)
+    return;
+  vector<size_t> idx(ndims, 0);
+  vector<size_t> strides(ndims);
+  strides[0] = 1;
+  for (size_t dim = 1; dim < ndims; dim++)
+    strides[dim] = strides[dim - 1] * dims[dim - 1];
+  size_t q = 0;
+  for (size_t p = 0; p < nelems; p++) {
+    f(p, q);
+    // advance the last index first like row major storage does
+    for (size_t dim = ndims; dim-- > 0;) {
+      if (++idx[dim] < dims[dim]) {
+        q += strides[dim];
+        break;
+      }
+      q -= (dims[dim] - 1) * strides[dim];
+      idx[dim] = 0;
+    }
   }
-  return processed;
 }
 
 template <typename T>
 void assignRowMajorData(const T *data, BaseArray<T> &array) {
-  vector<size_t> idx(array.getNumDims());
-  assignRowMajorDim(1, data, array, idx);
-}
-
-/**
- * helper for convertArrayLayout
- * recursive function for changing between row and column major
- */
-template <typename S, typename T>
-static void convertArrayDim(size_t dim,
-                            const BaseArray<S> &s, vector<size_t> &sidx,
-                            BaseArray<T> &d, vector<size_t> &didx) {
-  size_t ndims = s.getNumDims();
-  size_t size = s.getDim(dim);
-  for (size_t i = 1; i <= size; i++) {
-    didx[ndims - dim] = sidx[dim - 1] = i;
-    if (dim < sidx.size())
-      convertArrayDim(dim + 1, s, sidx, d, didx);
-    else
-      d(didx) = s(sidx);
+  vector<size_t> dims = array.getDims();
+  if (array.isRefArray()) {
+    std::unique_ptr<T[]> tmp(new T[array.getNumElems()]);
+    T* tmp_data = tmp.get();
+    forEachRowMajor(dims, [&](size_t p, size_t q) { tmp_data[q] = data[p]; });
+    array.assign(tmp_data);
+  }
+  else {
+    T* array_data = array.getData();
+    forEachRowMajor(dims, [&](size_t p, size_t q) { array_data[q] = data[p]; });
   }
 }
 
-
 /**
  * permutes dims between row and column major storage layout,
  * including optional type conversion if supported in assignment from S to T
@@ -483,7 +619,18 @@ void convertArrayLayout(const BaseArray<S> &s, BaseArray<T> &d) {
   for (size_t dim = 1; dim <= ndims; dim++)
     ddims[ndims - dim] = sdims[dim - 1];
   d.resize(ddims);
-  convertArrayDim(1, s, sdims, d, ddims);
+  // column major storage of d with reversed dims is row major storage of s
+  const S* s_data = s.getData();
+  if (d.isRefArray()) {
+    std::unique_ptr<T[]> tmp(new T[d.getNumElems()]);
+    T* tmp_data = tmp.get();
+    forEachRowMajor(sdims, [&](size_t p, size_t q) { tmp_data[p] = s_data[q]; });
+    d.assign(tmp_data);
+  }
+  else {
+    T* d_data = d.getData();
+    forEachRowMajor(sdims, [&](size_t p, size_t q) { d_data[p] = s_data[q]; });
+  }
 }
 
 /*
@@ -0,0 +1,204 @@
+#pragma once
+/*
+ * Non-virtual views on the contiguous data of Modelica arrays.
+ *
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+#include "Array.h"
+/** @addtogroup math
+ *   @{
+*/
+
+/**
+ * Statically dimensioned view on the data of an array.
+ * The dimensions and strides are fetched once when the view is created,
+ * element access is non-virtual and computes the column-major offset
+ * inline, so loops over a view can be optimized like loops over a C array.
+ * The view does not own the data and must not outlive a resize of the
+ * viewed array. Use a const T to view a const array.
+ * @param T type of the elements, const T for read-only views
+ * @param ndims number of dimensions of the view
+ */
+template<typename T, size_t ndims>
+class ArrayView
+{
+ public:
+  typedef typename std::remove_const<T>::type value_type;
+  typedef typename std::conditional<std::is_const<T>::value,
+    const BaseArray<value_type>, BaseArray<value_type> >::type array_type;
+  typedef T* iterator;
+
+  /**
+   * View on contiguous column-major data
+   * @param data first element
+   * @param dims sizes of the ndims dimensions
+   */
+  ArrayView(T* data, const size_t* dims)
+    :_data(data)
+  {
+    size_t stride = 1;
+    for (size_t dim = 0; dim < ndims; dim++) {
+      _dims[dim] = dims[dim];
+      _strides[dim] = stride;
+      stride *= dims[dim];
+    }
+  }
+
+  /**
+   * View on all elements of an array
+   * Reference arrays only provide a temporary copy of their data,
+   * so they can only be viewed read-only.
+   */
+  ArrayView(array_type& a)
+    :_data(a.getData())
+  {
+    if (a.getNumDims() != ndims)
+      throw ModelicaSimulationError(MODEL_ARRAY_FUNCTION, "Wrong dimensions for array view");
+    size_t stride = 1;
+    for (size_t dim = 0; dim < ndims; dim++) {
+      _dims[dim] = a.getDim(dim + 1);
+      _strides[dim] = stride;
+      stride *= _dims[dim];
+    }
+  }
+
+  inline T& operator()(size_t i) const
+  {
+    static_assert(ndims == 1, "ArrayView index count must match dimensions");
+    return _data[(i-1)*_strides[0]];
+  }
+
+  inline T& operator()(size_t i, size_t j) const
+  {
+    static_assert(ndims == 2, "ArrayView index count must match dimensions");
+    return _data[(i-1)*_strides[0] + (j-1)*_strides[1]];
+  }
+
+  inline T& operator()(size_t i, size_t j, size_t k) const
+  {
+    static_assert(ndims == 3, "ArrayView index count must match dimensions");
+    return _data[(i-1)*_strides[0] + (j-1)*_strides[1] + (k-1)*_strides[2]];
+  }
+
+  inline T& operator()(size_t i, size_t j, size_t k, size_t l) const
+  {
+    static_assert(ndims == 4, "ArrayView index count must match dimensions");
+    return _data[(i-1)*_strides[0] + (j-1)*_strides[1] + (k-1)*_strides[2] + (l-1)*_strides[3]];
+  }
+
+  /**
+   * Size of dimension dim, counted from 1 like BaseArray::getDim
+   */
+  inline size_t getDim(size_t dim) const
+  {
+    return _dims[dim - 1];
+  }
+
+  /**
+   * Distance between two neighbouring elements of dimension dim
+   */
+  inline size_t getStride(size_t dim) const
+  {
+    return _strides[dim - 1];
+  }
+
+  inline size_t getNumElems() const
+  {
+    size_t nelems = 1;
+    for (size_t dim = 0; dim < ndims; dim++)
+      nelems *= _dims[dim];
+    return nelems;
+  }
+
+  /**
+   * True if the elements are stored without gaps in column-major order,
+   * i.e. begin() to end() covers the viewed elements
+   */
+  bool isContiguous() const
+  {
+    size_t stride = 1;
+    for (size_t dim = 0; dim < ndims; dim++) {
+      if (_dims[dim] > 1 && _strides[dim] != stride)
+        return false;
+      stride *= _dims[dim];
+    }
+    return true;
+  }
+
+  inline T* getData() const
+  {
+    return _data;
+  }
+
+  iterator begin() const
+  {
+    return _data;
+  }
+
+  iterator end() const
+  {
+    return _data + getNumElems();
+  }
+
+  /**
+   * View with dimensions dim1 and dim2 exchanged, no data is copied
+   */
+  ArrayView<T, ndims> transpose(size_t dim1 = 1, size_t dim2 = 2) const
+  {
+    ArrayView<T, ndims> view(*this);
+    std::swap(view._dims[dim1 - 1], view._dims[dim2 - 1]);
+    std::swap(view._strides[dim1 - 1], view._strides[dim2 - 1]);
+    return view;
+  }
+
+ private:
+  T* _data;
+  size_t _dims[ndims];
+  size_t _strides[ndims];
+};
+
+/**
+ * Read-only view on an array
+ */
+template<size_t ndims, typename T>
+ArrayView<const T, ndims> makeConstArrayView(const BaseArray<T>& a)
+{
+  return ArrayView<const T, ndims>(a);
+}
+
+/**
+ * Writable view on an array that stores its data contiguously
+ */
+template<size_t ndims, typename T>
+ArrayView<T, ndims> makeArrayView(BaseArray<T>& a)
+{
+  return ArrayView<T, ndims>(a);
+}
+/** @} */ // end of math
@@ -14,6 +14,11 @@
 #include <Core/Math/ILapack.h>     // needed for solution of linear system with Lapack
 #include <Core/Math/Constants.h>   // definitializeion of constants like uround
 
+/// Maximum number of Broyden updates before the Jacobian is recomputed
+static const int NEWTON_MAX_BROYDEN = 10;
+/// Maximum ratio of two successive residual norms for keeping the Jacobian
+static const double NEWTON_MAX_CONTRACTION = 0.5;
+
 Newton::Newton(INonLinSolverSettings* settings,shared_ptr<INonLinearAlgLoop> algLoop)
   :AlgLoopSolverDefaultImplementation()
    ,_algLoop          (algLoop)
@@ -32,9 +37,18 @@ Newton::Newton(INonLinSolverSettings* settings,shared_ptr<INonLinearAlgLoop> alg
   , _iHelp            (NULL)
   , _jHelp            (NULL)
   , _jac              (NULL)
+  , _jacLU            (NULL)
+  , _fOld             (NULL)
+  , _broydenA         (NULL)
+  , _broydenS         (NULL)
   , _firstCall        (true)
   , _iterationStatus  (CONTINUE)
   , _lc               (LC_NLS)
+  , _jacValid         (false)
+  , _nBroyden         (0)
+  , _nFactorizations  (0)
+  , _nReuses          (0)
+  , _nBroydenUpdates  (0)
 {
 	if (_algLoop)
 	{
@@ -48,6 +62,12 @@ Newton::Newton(INonLinSolverSettings* settings,shared_ptr<INonLinearAlgLoop> alg
 
 Newton::~Newton()
 {
+  if (_nFactorizations > 0)
+    LOGGER_WRITE("Newton: eq" + to_string(_algLoop->getEquationIndex()) +
+                 ": " + to_string(_nFactorizations) + " Jacobian factorizations, " +
+                 to_string(_nReuses) + " steps with reused factorization, " +
+                 to_string(_nBroydenUpdates) + " Broyden updates", _lc, LL_INFO);
+
   if (_yNames)   delete []    _yNames;
   if (_yNominal) delete []    _yNominal;
   if (_yMin)     delete []    _yMin;
@@ -62,6 +82,10 @@ Newton::~Newton()
   if (_iHelp)    delete []    _iHelp;
   if (_jHelp)    delete []    _jHelp;
   if (_jac)      delete []    _jac;
+  if (_jacLU)    delete []    _jacLU;
+  if (_fOld)     delete []    _fOld;
+  if (_broydenA) delete []    _broydenA;
+  if (_broydenS) delete []    _broydenS;
 }
 
 void Newton::initialize()
@@ -93,6 +117,10 @@ void Newton::initialize()
       if (_iHelp)    delete []    _iHelp;
       if (_jHelp)    delete []    _jHelp;
       if (_jac)      delete []    _jac;
+      if (_jacLU)    delete []    _jacLU;
+      if (_fOld)     delete []    _fOld;
+      if (_broydenA) delete []    _broydenA;
+      if (_broydenS) delete []    _broydenS;
 
       _yNames       = new const char* [_dimSys];
       _yNominal     = new double[_dimSys];
@@ -108,12 +136,18 @@ void Newton::initialize()
       _iHelp        = new long int[_dimSys];
       _jHelp        = new long int[_dimSys];
       _jac          = new double[_dimSys*_dimSys];
+      _jacLU        = new double[_dimSys*_dimSys];
+      _fOld         = new double[_dimSys];
+      _broydenA     = new double[_dimSys*NEWTON_MAX_BROYDEN];
+      _broydenS     = new double[_dimSys*NEWTON_MAX_BROYDEN];
 
       _algLoop->getNamesReal(_yNames);
       _algLoop->getNominalReal(_yNominal);
       _algLoop->getMinReal(_yMin);
       _algLoop->getMaxReal(_yMax);
     }
+    _jacValid = false;
+    _nBroyden = 0;
 
 
 
@@ -170,7 +204,19 @@ void Newton::solve( )
       LOGGER_WRITE_VECTOR("y" + to_string(totSteps), _y, _dimSys, _lc, LL_DEBUG);
       LOGGER_WRITE_VECTOR("f" + to_string(totSteps), _f, _dimSys, _lc, LL_DEBUG);
 
-      calcJacobian(_jac, _fNominal);
+      // Reuse the factorization of a previous step if it is still valid
+      bool fresh = !_jacValid;
+      if (fresh) {
+        calcJacobian(_jac, _fNominal);
+        std::copy(_jac, _jac + _dimSys * _dimSys, _jacLU);
+        dgetrf_(&_dimSys, &_dimSys, _jacLU, &_dimSys, _iHelp, &info);
+        _jacValid = (info == 0);
+        _nBroyden = 0;
+        _nFactorizations++;
+      }
+      else
+        _nReuses++;
+      std::copy(_f, _f + _dimSys, _fOld);
 
       // Initialize line search function
       double phi = 0.0;
@@ -179,25 +225,11 @@ void Newton::solve( )
         phi += _f[i] * _f[i];
       }
 
-      double det;
-      if (_dimSys == 1 && (det = _jac[0]) != 0.0) {
-        det = _jac[0];
-        _f[0] /= det;
-        info = 0;
-      }
-      else if (_dimSys == 2 && (det = _jac[0]*_jac[3] - _jac[1]*_jac[2]) != 0.0) {
-        det = _jac[0]*_jac[3] - _jac[1]*_jac[2];
-        double f0 = (_f[0]*_jac[3] - _f[1]*_jac[2]) / det;
-        _f[1] = (_jac[0]*_f[1] - _jac[1]*_f[0]) / det;
-        _f[0] = f0;
-        info = 0;
-      }
-      else {
+      if (_jacValid) {
         // Solve linear system
-        dgesv_(&_dimSys, &dimRHS, _jac, &_dimSys, _iHelp, _f, &_dimSys, &info);
+        solveJacobian(_f);
       }
-
-      if (info > 0) {
+      else if (info > 0) {
         long int info2 = 0;
         double scale = 0.0;
         dgetc2_(&_dimSys, _jac, &_dimSys, _iHelp, _jHelp, &info2);
@@ -206,14 +238,14 @@ void Newton::solve( )
         for (int i = 0; i < _dimSys; i++) {
           _f[i] = std::min(_yNominal[i], std::max(-_yNominal[i], _f[i]));
         }
-        LOGGER_WRITE("total pivoting: dgesv/dgetc2 infos: " + to_string(info) + "/" + to_string(info2) +
+        LOGGER_WRITE("total pivoting: dgetrf/dgetc2 infos: " + to_string(info) + "/" + to_string(info2) +
                      ", dgesc2 scale: " + to_string(scale), _lc, LL_DEBUG);
       }
-      else if (info < 0) {
+      else {
         LOGGER_WRITE_END(_lc, LL_DEBUG);
         throw ModelicaSimulationError(ALGLOOP_SOLVER,
           "error solving nonlinear system (iteration: " + to_string(totSteps)
-          + ", dgesv info: " + to_string(info) + ")");
+          + ", dgetrf info: " + to_string(info) + ")");
       }
 
       // Increase counter
@@ -222,6 +254,7 @@ void Newton::solve( )
       // New iterate
       double lambda = 1.0; // step size
       double alpha = 1e-4; // guard for sufficient decrease
+      bool refresh = false; // retry the step with a fresh Jacobian
       // first find a feasible step
       while (true) {
         for (int i = 0; i < _dimSys; i++) {
@@ -233,6 +266,10 @@ void Newton::solve( )
           calcFunction(_yHelp, _fHelp);
         }
         catch (ModelicaSimulationError& ex) {
+          if (lambda < 1e-10 && !fresh) {
+            refresh = true;
+            break;
+          }
           if (lambda < 1e-10) {
             LOGGER_WRITE_END(_lc, LL_DEBUG);
             throw ex;
@@ -243,6 +280,12 @@ void Newton::solve( )
         }
         break;
       }
+      if (refresh) {
+        // go back to _y, the Jacobian is evaluated at the current state of the loop
+        calcFunction(_y, _f);
+        _jacValid = false;
+        continue;
+      }
       // check stopping criterion
       _iterationStatus = DONE;
       for (int i = 0; i < _dimSys; i++) {
@@ -260,6 +303,11 @@ void Newton::solve( )
         phiHelp += _fHelp[i] * _fHelp[i];
       }
       while (_iterationStatus == CONTINUE) {
+        // an old Jacobian that gives no descent is not worth a line search
+        if (!fresh && phiHelp > (1.0 - alpha * lambda) * phi) {
+          refresh = true;
+          break;
+        }
         // test half step that also serves as max bound for step reduction
         double lambdaTest = 0.5*lambda;
         for (int i = 0; i < _dimSys; i++) {
@@ -322,10 +370,27 @@ void Newton::solve( )
         if (phiHelp <= (1.0 - alpha * lambda) * phi || (lambda < alpha && isfinite(phiHelp)))
           break;
       }
-      // take iterate
-      std::copy(_yHelp, _yHelp + _dimSys, _y);
-      for (int i = 0; i < _dimSys; i++)
+      if (refresh) {
+        LOGGER_WRITE("no decrease with old Jacobian, phi = " + to_string(phi) +
+                     " --> " + to_string(phiHelp), _lc, LL_DEBUG);
+        calcFunction(_y, _f);
+        _jacValid = false;
+        continue;
+      }
+      // take iterate, keeping the step in _yTest and the residual change in _fTest
+      for (int i = 0; i < _dimSys; i++) {
+        _yTest[i] = _yHelp[i] - _y[i];
         _f[i] = _fHelp[i] * _fNominal[i];
+        _fTest[i] = _f[i] - _fOld[i];
+      }
+      std::copy(_yHelp, _yHelp + _dimSys, _y);
+      // keep the Jacobian for the next step if the residual contracts well,
+      // correct it with a Broyden update if there is room for one
+      if (_jacValid && _iterationStatus == CONTINUE) {
+        if (lambda < 1.0 || phiHelp > NEWTON_MAX_CONTRACTION * NEWTON_MAX_CONTRACTION * phi ||
+            _nBroyden >= NEWTON_MAX_BROYDEN || !updateBroyden(_yTest, _fTest))
+          _jacValid = false;
+      }
       phi = phiHelp;
   } // end while
 
@@ -411,6 +476,47 @@ void Newton::calcJacobian(double *jac, double *fNominal)
       //jac[idx] *= _yNominal[j] / fNominal[i];
       jac[idx] /= fNominal[i];
 }
+void Newton::solveJacobian(double *f)
+{
+  long int dimRHS = 1, info = 0;
+  char trans = 'N';
+  // f is scaled with fNominal like the factorized Jacobian
+  dgetrs_(&trans, &_dimSys, &dimRHS, _jacLU, &_dimSys, _iHelp, f, &_dimSys, &info);
+  // H_k+1 * f = H_k * f + a_k * (s_k^T * H_k * f)
+  for (int k = 0; k < _nBroyden; k++) {
+    const double *a = _broydenA + k * _dimSys;
+    const double *s = _broydenS + k * _dimSys;
+    double sf = 0.0;
+    for (int i = 0; i < _dimSys; i++)
+      sf += s[i] * f[i];
+    for (int i = 0; i < _dimSys; i++)
+      f[i] += a[i] * sf;
+  }
+}
+
+bool Newton::updateBroyden(const double *s, const double *df)
+{
+  // good Broyden update of the inverse with Sherman-Morrison:
+  // a = (s - H*df) / (s^T*H*df)
+  double *a = _broydenA + _nBroyden * _dimSys;
+  for (int i = 0; i < _dimSys; i++)
+    a[i] = df[i] / _fNominal[i];
+  solveJacobian(a);
+  double sHdf = 0.0, ss = 0.0;
+  for (int i = 0; i < _dimSys; i++) {
+    sHdf += s[i] * a[i];
+    ss += s[i] * s[i];
+  }
+  if (!(std::abs(sHdf) > 1e-12 * ss))
+    return false;
+  for (int i = 0; i < _dimSys; i++)
+    a[i] = (s[i] - a[i]) / sHdf;
+  std::copy(s, s + _dimSys, _broydenS + _nBroyden * _dimSys);
+  _nBroyden++;
+  _nBroydenUpdates++;
+  return true;
+}
+
 bool* Newton::getConditionsWorkArray()
 {
 	return AlgLoopSolverDefaultImplementation::getConditionsWorkArray();
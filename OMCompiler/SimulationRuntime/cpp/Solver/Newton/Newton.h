@@ -28,6 +28,9 @@
    by Lapack/DGESV, which computes the solution to a real system of linear equations
    A * y = B,                            (2)
    where A is an n-by-n matrix and y and B are n-by-n(right hand side) matrices.
+   The LU factors of the Jacobian are kept across iterations and calls
+   (simplified Newton) as long as the residual contracts well. Between two
+   factorizations the inverse is corrected with Broyden rank-one updates.
    \date     2008, September, 16th
    \author
 */
@@ -67,6 +70,12 @@ class Newton : public INonLinearAlgLoopSolver,  public AlgLoopSolverDefaultImple
   /// Encapsulation of determination of Jacobian
   void calcJacobian(double *jac, double *fNominal);
 
+  /// Apply the inverse of the last factorized Jacobian and the Broyden updates to the residual f
+  void solveJacobian(double *f);
+
+  /// Broyden update of the inverse Jacobian with the step s and the change of the residuals df
+  bool updateBroyden(const double *s, const double *df);
+
   // Member variables
   //---------------------------------------------------------------
   INonLinSolverSettings
@@ -95,9 +104,22 @@ class Newton : public INonLinearAlgLoopSolver,  public AlgLoopSolverDefaultImple
     *_fHelp,                    ///< Temp        - Auxillary variables
     *_yTest,                    ///< Temp        - Auxillary variables
     *_fTest,                    ///< Temp        - Auxillary variables
-    *_jac;                      ///< Temp        - Jacobian
+    *_jac,                      ///< Temp        - Jacobian
+    *_jacLU,                    ///< Temp        - LU factors of the scaled Jacobian, kept across calls
+    *_fOld,                     ///< Temp        - Residuals at the start of a step
+    *_broydenA,                 ///< Temp        - Broyden updates of the inverse Jacobian,
+    *_broydenS;                 ///<               H_k+1 = H_k + a_k*s_k^T*H_k
   long int *_iHelp;
   long int *_jHelp;
   LogCategory _lc;              ///< LC_NLS or LC_LS
 
+  bool
+    _jacValid;                  ///< _jacLU can be used for the next step
+  int
+    _nBroyden;                  ///< number of Broyden updates since the last factorization
+  unsigned long
+    _nFactorizations,           ///< Statistics  - Jacobians computed and factorized
+    _nReuses,                   ///< Statistics  - steps taken with an old factorization
+    _nBroydenUpdates;           ///< Statistics  - rank-one updates
+
 };/** @} */ // end of solverNewton
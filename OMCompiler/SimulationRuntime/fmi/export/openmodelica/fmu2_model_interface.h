@@ -98,22 +98,38 @@ typedef struct {
   int _has_jacobian_intialization;
   ANALYTIC_JACOBIAN* fmiDerJac;
   ANALYTIC_JACOBIAN* fmiDerJacInitialization;
+  ANALYTIC_JACOBIAN* _jacobian_constants; /* Jacobian whose constant equations are up to date, NULL after every update */
 
   fmi2Real* states;
   fmi2Real* states_der;
   fmi2Real* event_indicators;
   fmi2Real* event_indicators_prev;
   fmi2Real* input_real_derivative;
+
+  struct INTERNAL_FMU_STATE* fmuStatePool; /* free list of released FMU state snapshots */
+  int fmuStatePoolSize;
 } ModelInstance;
 
-typedef struct {
-  RINGBUFFER* simulationData;
-  modelica_real* realParameter;
-  modelica_integer* integerParameter;
-  modelica_boolean* booleanParameter;
-  modelica_string* stringParameter;
+/* Snapshot of an FMU created by fmi2GetFMUstate. The header is followed by one contiguous
+ * payload of `size' bytes, which is also the serialized form of the state:
+ *   time values and real variables of all ring buffer slots, real parameters,
+ *   integer variables, integer parameters, boolean variables, boolean parameters,
+ *   and the zero-terminated contents of the string variables and string parameters.
+ * Freed snapshots are kept in a free list of the instance and reused. */
+typedef struct INTERNAL_FMU_STATE {
+  struct INTERNAL_FMU_STATE* next;  /* next snapshot in the free list */
+  size_t capacity;                  /* allocated bytes of the payload */
+  size_t size;                      /* used bytes of the payload */
 } INTERNAL_FMU_STATE;
 
+/* Non-standard extension: dense column-major matrix of the partial derivatives of the
+ * unknowns with respect to the knowns, jacobian[k*nUnknown+i] = d unknown_i / d known_k.
+ * Columns that do not share rows are evaluated together using the sparsity pattern. */
+fmi2Status fmi2GetDirectionalDerivativeColumns(fmi2Component c,
+    const fmi2ValueReference vUnknown_ref[], size_t nUnknown,
+    const fmi2ValueReference vKnown_ref[], size_t nKnown,
+    fmi2Real jacobian[]);
+
 
 /* reset alignment policy to the one set before reading this file */
 #if defined _MSC_VER || defined __GNUC__
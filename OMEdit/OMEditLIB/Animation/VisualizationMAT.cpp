@@ -34,18 +34,37 @@
 
 #include "VisualizationMAT.h"
 
+#include <QtConcurrent/QtConcurrent>
+
+/* Largest buffer of pre-baked values, larger result files are read frame by frame. */
+static const std::size_t maxPreBakeBytes = 256 * 1024 * 1024;
+
 VisualizationMAT::VisualizationMAT(const std::string& modelFile, const std::string& path)
   : VisualizationAbstract(modelFile, path, VisType::MAT),
-    _matReader()
+    _matReader(),
+    _matVariables(),
+    _timePoint(),
+    _timePointTime(0.0),
+    _timePointValid(false),
+    _preBakeVariables(),
+    _preBakeColumns(),
+    _preBakedValues(),
+    _preBakeFutures(),
+    _preBakeStarted(false),
+    _preBakeWorkersLeft(0),
+    _preBakeReady(false),
+    _preBakeFailed(false),
+    _preBakeCancel(false)
 {
 }
 
 /*!
  * \brief VisualizationMAT::~VisualizationMAT
- * Free the ModelicaMatReader
+ * Stop the pre-baking and free the ModelicaMatReader
  */
 VisualizationMAT::~VisualizationMAT()
 {
+  stopPreBake();
   if (_matReader.file) {
     omc_free_matlab4_reader(&_matReader);
   }
@@ -67,6 +86,8 @@ void VisualizationMAT::initializeVisAttributes(const double time)
                                                           Helper::scriptingKind, Helper::errorLevel));
   }
   updateVisAttributes(time);
+  // the first frame has looked up all the variables of the visualizer attributes
+  startPreBake();
 }
 
 void VisualizationMAT::readMat(const std::string& modelFile, const std::string& path)
@@ -83,6 +104,10 @@ void VisualizationMAT::readMat(const std::string& modelFile, const std::string&
   else
   {
     // Read mat file.
+    stopPreBake();
+    _matVariables.clear();
+    _timePoint = ModelicaMatTimePoint();
+    _timePointValid = false;
     omc_new_matlab4_reader(resFileName.c_str(), &_matReader);
     //auto ret = omc_new_matlab4_reader(resFileName.c_str(), &_matReader);
     // Check return value.
@@ -123,9 +148,137 @@ void VisualizationMAT::updateVisualizerAttribute(VisualizerAttribute& attr, cons
 
 void VisualizationMAT::updateVisualizerAttributeMAT(VisualizerAttribute& attr, const double time)
 {
-  if (!attr.isConst) {
-    attr.exp = omcGetVarValue(&_matReader, attr.cref.c_str(), time);
+  if (attr.isConst) {
+    return;
+  }
+  ModelicaMatVariable_t* var = getMatVariable(attr.cref);
+  if (var == nullptr) {
+    attr.exp = 0.0;
+    return;
+  }
+  // all attributes of a frame are evaluated at the same time, locate it only once
+  if (!_timePointValid || _timePointTime != time) {
+    _timePointValid = (0 == omc_matlab4_find_time(&_matReader, time, &_timePoint));
+    _timePointTime = time;
+  }
+  double val = 0.0;
+  if (_timePointValid && _preBakeReady) {
+    // interpolate the pre-baked values like omc_matlab4_val_at
+    auto column = _preBakeColumns.find(var);
+    if (column != _preBakeColumns.end()) {
+      const std::size_t columns = _preBakeVariables.size();
+      val = _timePoint.weight1 * _preBakedValues[_timePoint.index1 * columns + column->second];
+      if (_timePoint.index2 >= 0) {
+        val += _timePoint.weight2 * _preBakedValues[_timePoint.index2 * columns + column->second];
+      }
+      attr.exp = val;
+      return;
+    }
+  }
+  if (_timePointValid) {
+    omc_matlab4_val_at(&val, &_matReader, var, &_timePoint);
+  } else {
+    omc_matlab4_val(&val, &_matReader, var, time);
+  }
+  attr.exp = val;
+}
+
+/*!
+ * \brief VisualizationMAT::getMatVariable
+ * Returns the result file variable with the given name. The lookup is done once per name.
+ * \param varName
+ * \return the variable or nullptr if the result file does not contain it.
+ */
+ModelicaMatVariable_t* VisualizationMAT::getMatVariable(const std::string& varName)
+{
+  auto it = _matVariables.find(varName);
+  if (it != _matVariables.end()) {
+    return it->second;
+  }
+  ModelicaMatVariable_t* var = omc_matlab4_find_var(&_matReader, varName.c_str());
+  if (var == nullptr) {
+    MessagesWidget::instance()->addGUIMessage(MessageItem(MessageItem::Modelica,
+                                                          QString(QObject::tr("Did not get variable from result file. Variable name is %1."))
+                                                          .arg(varName.c_str()), Helper::scriptingKind, Helper::errorLevel));
+  }
+  _matVariables.emplace(varName, var);
+  // parameters are not time dependent and need no pre-baking
+  if (var != nullptr && !var->isParam && !_preBakeStarted && _preBakeColumns.emplace(var, _preBakeVariables.size()).second) {
+    _preBakeVariables.push_back(var);
+  }
+  return var;
+}
+
+/*!
+ * \brief VisualizationMAT::startPreBake
+ * Reads the values of the visualizer attribute variables at all time points into _preBakedValues.
+ * The columns are distributed over worker threads, each with its own ModelicaMatReader.
+ * Until all workers are done the values are read from the result file frame by frame.
+ */
+void VisualizationMAT::startPreBake()
+{
+  if (_preBakeStarted || _preBakeVariables.empty() || !_matReader.file || _matReader.nrows == 0) {
+    return;
+  }
+  _preBakeStarted = true;
+  const std::size_t columns = _preBakeVariables.size();
+  const std::size_t rows = _matReader.nrows;
+  if (rows * columns * sizeof(double) > maxPreBakeBytes) {
+    MessagesWidget::instance()->addGUIMessage(MessageItem(MessageItem::Modelica,
+                                                          QObject::tr("The result file is too large to pre-bake the animation, the values are read for each frame."),
+                                                          Helper::scriptingKind, Helper::notificationLevel));
+    return;
+  }
+  _preBakedValues.assign(rows * columns, 0.0);
+  const std::size_t workers = std::min<std::size_t>(columns, std::max(1, std::min(QThread::idealThreadCount(), 8)));
+  const std::string fileName = _matReader.fileName;
+  _preBakeWorkersLeft = static_cast<int>(workers);
+  for (std::size_t worker = 0; worker < workers; ++worker) {
+    _preBakeFutures.append(QtConcurrent::run([this, worker, workers, rows, columns, fileName]() {
+      ModelicaMatReader reader;
+      bool ok = (omc_new_matlab4_reader(fileName.c_str(), &reader) == nullptr);
+      for (std::size_t column = worker; ok && column < columns && !_preBakeCancel; column += workers) {
+        double* vals = omc_matlab4_take_vals(&reader, _preBakeVariables[column]->index);
+        if (vals == nullptr) {
+          ok = false;
+          break;
+        }
+        for (std::size_t row = 0; row < rows; ++row) {
+          _preBakedValues[row * columns + column] = vals[row];
+        }
+        free(vals);
+      }
+      if (reader.file) {
+        omc_free_matlab4_reader(&reader);
+      }
+      if (!ok) {
+        _preBakeFailed = true;
+      }
+      if (--_preBakeWorkersLeft == 0 && !_preBakeFailed && !_preBakeCancel) {
+        _preBakeReady = true;
+      }
+    }));
+  }
+}
+
+/*!
+ * \brief VisualizationMAT::stopPreBake
+ * Cancels the worker threads, waits for them and drops the pre-baked values.
+ */
+void VisualizationMAT::stopPreBake()
+{
+  _preBakeCancel = true;
+  for (QFuture<void>& future : _preBakeFutures) {
+    future.waitForFinished();
   }
+  _preBakeFutures.clear();
+  _preBakeReady = false;
+  _preBakeFailed = false;
+  _preBakeCancel = false;
+  _preBakeStarted = false;
+  _preBakeVariables.clear();
+  _preBakeColumns.clear();
+  _preBakedValues.clear();
 }
 
 double VisualizationMAT::omcGetVarValue(ModelicaMatReader* reader, const char* varName, const double time)
@@ -38,6 +38,12 @@
 #include "Visualization.h"
 #include "util/read_matlab4.h"
 
+#include <QFuture>
+
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
 class VisualizationMAT : public VisualizationAbstract
 {
 public:
@@ -55,8 +61,29 @@ public:
   void updateVisualizerAttribute(VisualizerAttribute& attr, const double time) override;
   void updateVisualizerAttributeMAT(VisualizerAttribute& attr, const double time);
   double omcGetVarValue(ModelicaMatReader* reader, const char* varName, const double time);
+private:
+  ModelicaMatVariable_t* getMatVariable(const std::string& varName);
+  void startPreBake();
+  void stopPreBake();
 private:
   ModelicaMatReader _matReader;
+  // result file variables of the visualizer attributes, looked up once per name (nullptr if not found)
+  std::unordered_map<std::string, ModelicaMatVariable_t*> _matVariables;
+  // position of the current frame in the time vector, shared by all attributes of the frame
+  ModelicaMatTimePoint _timePoint;
+  double _timePointTime;
+  bool _timePointValid;
+  // values of the visualizer attribute variables at all time points, baked by worker threads
+  // row after row (frame after frame) with one column per variable, in double precision like the result file
+  std::vector<ModelicaMatVariable_t*> _preBakeVariables;
+  std::unordered_map<ModelicaMatVariable_t*, std::size_t> _preBakeColumns;
+  std::vector<double> _preBakedValues;
+  QList<QFuture<void>> _preBakeFutures;
+  bool _preBakeStarted;
+  std::atomic<int> _preBakeWorkersLeft;
+  std::atomic<bool> _preBakeReady;
+  std::atomic<bool> _preBakeFailed;
+  std::atomic<bool> _preBakeCancel;
 };
 
 #endif // VISUALIZATIONMAT_H
@@ -2456,12 +2456,16 @@ void LibraryTreeModel::createLibraryTreeItems(LibraryTreeItem *pLibraryTreeItem)
     if (!libs.isEmpty()) {
       libs.removeFirst();
     }
+    /* $Code is a special OpenModelica keyword. No API command will work if we use it. */
+    for (int i = libs.size() - 1 ; i >= 0 ; i--) {
+      if (libs.at(i).contains("$Code")) {
+        libs.removeAt(i);
+      }
+    }
+    // fetch the class information of all nested classes with one call instead of one call per LibraryTreeItem::updateClassInformation
+    pOMCProxy->prefetchClassInformation(libs);
     LibraryTreeItem *pParentLibraryTreeItem = 0;
     foreach (QString lib, libs) {
-      /* $Code is a special OpenModelica keyword. No API command will work if we use it. */
-      if (lib.contains("$Code")) {
-        continue;
-      }
       QString name = StringHandler::getLastWordAfterDot(lib);
       QString parentName = StringHandler::removeLastWordAfterDot(lib);
       if (!(pParentLibraryTreeItem && pParentLibraryTreeItem->getNameStructure().compare(parentName) == 0)) {
@@ -34,6 +34,7 @@
 
 #include <stdlib.h>
 #include <iostream>
+#include <algorithm>
 
 #include "OMCProxy.h"
 #include "MainWindow.h"
@@ -135,6 +136,7 @@ OMCProxy::OMCProxy(threadData_t* threadData, QWidget *pParent)
                                       << "clear"
                                       << "clearProgram";
   mLoadModelError = false;
+  mCacheHits = 0;
   //start the server
   if(!initializeOMC(threadData)) {  // if we are unable to start OMC. Exit the application.
     MainWindow::instance()->setExitApplicationStatus(true);
@@ -302,6 +304,7 @@ bool OMCProxy::initializeOMC(threadData_t *threadData)
 void OMCProxy::quitOMC()
 {
   sendCommand("quit()");
+  logCommandsTime();
   if (mpCommunicationLogFile) {
     fclose(mpCommunicationLogFile);
   }
@@ -385,6 +388,21 @@ void OMCProxy::sendCommand(const QString expression, bool saveToHistory)
   MMC_CATCH_TOP(mResult = "");
 }
 
+/*!
+ * \brief OMCProxy::logCommandsTime
+ * Writes the number of calls and the total time of each OMC API to the omeditcommunication.log file.
+ */
+void OMCProxy::logCommandsTime()
+{
+  if (mpCommunicationLogFile) {
+    fputs(QString("#calls#; %1 cached getClassInformation\n").arg(mCacheHits).toUtf8().constData(), mpCommunicationLogFile);
+    for (QHash<QString, QPair<int, double> >::const_iterator it = mCommandsTime.constBegin() ; it != mCommandsTime.constEnd() ; ++it) {
+      fputs(QString("#calls#; %1; %2; %3; \'%4\'\n").arg(it.value().first).arg(QString::number(it.value().second, 'f', 6))
+            .arg(QString::number(it.value().second / it.value().first, 'f', 6)).arg(it.key()).toUtf8().constData(), mpCommunicationLogFile);
+    }
+  }
+}
+
 /*!
   Sets the command result.
   \param value the command result.
@@ -413,6 +431,13 @@ QString OMCProxy::getResult()
  */
 void OMCProxy::logCommand(QString command, bool saveToHistory)
 {
+  // commands that might change the loaded classes invalidate the cached responses
+  static const QStringList readOnlyCommands = {"get", "is", "exist", "list", "search", "count", "size(", "currentError", "errors:=", "{e.", "qualifyPath", "uriToFilename", "numProcessors", "help"};
+  const QString trimmedCommand = command.trimmed();
+  if (!mClassInformationCache.isEmpty()
+      && std::none_of(readOnlyCommands.begin(), readOnlyCommands.end(), [&](const QString &prefix) {return trimmedCommand.startsWith(prefix);})) {
+    mClassInformationCache.clear();
+  }
   if (isLoggingEnabled()) {
     if (saveToHistory || MainWindow::instance()->isDebug()) {
       // insert the command to the logger window.
@@ -457,6 +482,10 @@ void OMCProxy::logCommand(QString command, bool saveToHistory)
  */
 void OMCProxy::logResponse(QString command, QString response, double elapsed, bool customCommand)
 {
+  // time of the round trips per API
+  QPair<int, double> &commandTime = mCommandsTime[command.section('(', 0, 0).left(64).trimmed()];
+  commandTime.first++;
+  commandTime.second += elapsed;
   if (isLoggingEnabled()) {
     QString firstLine("");
     for (int i = 0; i < command.length(); i++) {
@@ -590,6 +619,9 @@ bool OMCProxy::printMessagesStringInternal()
   int errorsSize = getMessagesStringInternal();
   bool returnValue = errorsSize > 0 ? true : false;
 
+  if (errorsSize == 0 || addMessagesStringInternal(errorsSize)) {
+    return returnValue;
+  }
   /* Loop in reverse order since getMessagesStringInternal returns error messages in reverse order. */
   for (int i = errorsSize; i > 0 ; i--) {
     setCurrentError(i);
@@ -604,6 +636,65 @@ bool OMCProxy::printMessagesStringInternal()
   return returnValue;
 }
 
+/*!
+ * \brief OMCProxy::getErrorsField
+ * Gets a field of all the errors with one command.
+ * \param field - the field of the error record, e.g., info.lineStart.
+ * \param strings - true if the field is a string.
+ * \return the values of the field.
+ */
+QStringList OMCProxy::getErrorsField(const QString &field, bool strings)
+{
+  sendCommand(QString("{e.%1 for e in errors}").arg(field));
+  if (strings) {
+    return StringHandler::unparseStrings(getResult());
+  }
+  QStringList values = StringHandler::removeFirstLastCurlBrackets(getResult()).split(",");
+  for (int i = 0 ; i < values.size() ; i++) {
+    values[i] = values[i].trimmed();
+  }
+  return values;
+}
+
+/*!
+ * \brief OMCProxy::addMessagesStringInternal
+ * Reads the errors field by field instead of a command per field and error.
+ * Adds the errors to the Messages Browser.
+ * \param errorsSize
+ * \return false if the fields could not be read. Then no error is added.
+ */
+bool OMCProxy::addMessagesStringInternal(int errorsSize)
+{
+  const QStringList fileNames = getErrorsField("info.filename", true);
+  const QStringList readOnlys = getErrorsField("info.readonly");
+  const QStringList lineStarts = getErrorsField("info.lineStart");
+  const QStringList columnStarts = getErrorsField("info.columnStart");
+  const QStringList lineEnds = getErrorsField("info.lineEnd");
+  const QStringList columnEnds = getErrorsField("info.columnEnd");
+  const QStringList messages = getErrorsField("message", true);
+  const QStringList kinds = getErrorsField("kind");
+  const QStringList levels = getErrorsField("level");
+  const QStringList ids = getErrorsField("id");
+  const QList<QStringList> fields = {fileNames, readOnlys, lineStarts, columnStarts, lineEnds, columnEnds, messages, kinds, levels, ids};
+  foreach (QStringList field, fields) {
+    if (field.size() != errorsSize) {
+      return false;
+    }
+  }
+  /* Loop in reverse order since getMessagesStringInternal returns error messages in reverse order. */
+  for (int i = errorsSize - 1; i >= 0 ; i--) {
+    const int errorId = ids.at(i).toInt();
+    if (errorId == 371 || errorId == 372 || errorId == 373) {
+      mLoadModelError = true;
+    }
+    const QString fileName = fileNames.at(i).compare("<interactive>") == 0 ? "" : fileNames.at(i);
+    MessageItem messageItem(MessageItem::Modelica, fileName, StringHandler::unparseBool(readOnlys.at(i)), lineStarts.at(i).toInt(), columnStarts.at(i).toInt(),
+                            lineEnds.at(i).toInt(), columnEnds.at(i).toInt(), messages.at(i), kinds.at(i), levels.at(i));
+    MessagesWidget::instance()->addGUIMessage(messageItem);
+  }
+  return true;
+}
+
 /*!
   Retrieves the list of errors from OMC
   \return size of errors
@@ -830,12 +921,77 @@ QStringList OMCProxy::searchClassNames(QString searchText, bool findInText)
 
 /*!
   Gets the information about the class.
+  The information is cached until a command changes the loaded classes.
   \param className - is the name of the class whose information is retrieved.
   \return the class information list.
   */
 OMCInterface::getClassInformation_res OMCProxy::getClassInformation(QString className)
 {
-  OMCInterface::getClassInformation_res classInformation = mpOMCInterface->getClassInformation(className);
+  QHash<QString, OMCInterface::getClassInformation_res>::const_iterator it = mClassInformationCache.constFind(className);
+  if (it != mClassInformationCache.constEnd()) {
+    mCacheHits++;
+    return it.value();
+  }
+  cacheClassInformation(className, mpOMCInterface->getClassInformation(className));
+  return mClassInformationCache.value(className);
+}
+
+/*!
+ * \brief OMCProxy::prefetchClassInformation
+ * Fetches the information of the classes that are not cached yet with one getClassInformations call.
+ * \param classNames
+ */
+void OMCProxy::prefetchClassInformation(const QStringList &classNames)
+{
+  QList<QString> missingClassNames;
+  foreach (QString className, classNames) {
+    if (!mClassInformationCache.contains(className)) {
+      missingClassNames.append(className);
+    }
+  }
+  if (missingClassNames.isEmpty()) {
+    return;
+  }
+  OMCInterface::getClassInformations_res classInformations = mpOMCInterface->getClassInformations(missingClassNames);
+  if (classInformations.restriction.size() != missingClassNames.size()) {
+    return;
+  }
+  for (int i = 0 ; i < missingClassNames.size() ; i++) {
+    OMCInterface::getClassInformation_res classInformation;
+    classInformation.restriction = classInformations.restriction.at(i);
+    classInformation.comment = classInformations.comment.at(i);
+    classInformation.partialPrefix = classInformations.partialPrefix.at(i);
+    classInformation.finalPrefix = classInformations.finalPrefix.at(i);
+    classInformation.encapsulatedPrefix = classInformations.encapsulatedPrefix.at(i);
+    classInformation.fileName = classInformations.fileName.at(i);
+    classInformation.fileReadOnly = classInformations.fileReadOnly.at(i);
+    classInformation.lineNumberStart = classInformations.lineNumberStart.at(i);
+    classInformation.columnNumberStart = classInformations.columnNumberStart.at(i);
+    classInformation.lineNumberEnd = classInformations.lineNumberEnd.at(i);
+    classInformation.columnNumberEnd = classInformations.columnNumberEnd.at(i);
+    classInformation.dimensions = StringHandler::unparseStrings(classInformations.dimensions.at(i));
+    classInformation.isProtectedClass = classInformations.isProtectedClass.at(i);
+    classInformation.isDocumentationClass = classInformations.isDocumentationClass.at(i);
+    classInformation.version = classInformations.version.at(i);
+    classInformation.preferredView = classInformations.preferredView.at(i);
+    classInformation.state = classInformations.state.at(i);
+    classInformation.access = classInformations.access.at(i);
+    classInformation.versionDate = classInformations.versionDate.at(i);
+    classInformation.versionBuild = classInformations.versionBuild.at(i);
+    classInformation.dateModified = classInformations.dateModified.at(i);
+    classInformation.revisionId = classInformations.revisionId.at(i);
+    cacheClassInformation(missingClassNames.at(i), classInformation);
+  }
+}
+
+/*!
+ * \brief OMCProxy::cacheClassInformation
+ * Fixes the documentation links in the class comment and caches the class information.
+ * \param className
+ * \param classInformation
+ */
+void OMCProxy::cacheClassInformation(const QString &className, OMCInterface::getClassInformation_res classInformation)
+{
   QString comment = classInformation.comment.replace("\\\"", "\"");
   comment = makeDocumentationUriToFileName(comment);
   // since tooltips can't handle file:// scheme so we have to remove it in order to display images and make links work.
@@ -845,7 +1001,7 @@ OMCInterface::getClassInformation_res OMCProxy::getClassInformation(QString clas
   comment.replace("src=\"file://", "src=\"");
 #endif
   classInformation.comment = comment;
-  return classInformation;
+  mClassInformationCache.insert(className, classInformation);
 }
 
 /*!
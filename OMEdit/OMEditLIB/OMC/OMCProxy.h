@@ -84,6 +84,13 @@ private:
   QStringList mLibrariesBrowserAdditionCommandsList;
   QStringList mLibrariesBrowserDeletionCommandsList;
   bool mLoadModelError;
+  QHash<QString, OMCInterface::getClassInformation_res> mClassInformationCache;
+  QHash<QString, QPair<int, double> > mCommandsTime;
+  int mCacheHits;
+  void logCommandsTime();
+  QStringList getErrorsField(const QString &field, bool strings = false);
+  void cacheClassInformation(const QString &className, OMCInterface::getClassInformation_res classInformation);
+  bool addMessagesStringInternal(int errorsSize);
 public:
   OMCProxy(threadData_t *threadData, QWidget *pParent = 0);
   ~OMCProxy();
@@ -121,6 +128,8 @@ public:
                             bool sort = false, bool builtin = false, bool showProtected = true, bool includeConstants = false);
   QStringList searchClassNames(QString searchText, bool findInText = false);
   OMCInterface::getClassInformation_res getClassInformation(QString className);
+  void prefetchClassInformation(const QStringList &classNames);
+  bool isClassInformationCached(const QString &className) const {return mClassInformationCache.contains(className);}
   bool isPackage(QString className);
   bool isBuiltinType(QString typeName);
   QString getBuiltinType(QString typeName);
@@ -0,0 +1,118 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "ClassInformationTest.h"
+#include "Util.h"
+#include "OMEditApplication.h"
+#include "MainWindow.h"
+
+#define GC_THREADS
+extern "C" {
+#include "meta/meta_modelica.h"
+}
+
+OMEDITTEST_MAIN(ClassInformationTest)
+
+static const QString fileName = "ClassInformationTest.mo";
+
+/*!
+ * \brief packageText
+ * Returns the text of the test package with the given comment on model M1.
+ * \param comment
+ * \return
+ */
+static QString packageText(const QString &comment)
+{
+  return QString("package ClassInformationTest\n"
+                 "  model M1 \"%1\"\n"
+                 "  end M1;\n"
+                 "  model M2 \"second model\"\n"
+                 "  end M2;\n"
+                 "  type T = Real[3, 2];\n"
+                 "end ClassInformationTest;\n").arg(comment);
+}
+
+void ClassInformationTest::initTestCase()
+{
+  OMCProxy *pOMCProxy = MainWindow::instance()->getOMCProxy();
+  if (!pOMCProxy->loadString(packageText("first model"), fileName)) {
+    QFAIL("Failed to load the ClassInformationTest package.");
+  }
+}
+
+void ClassInformationTest::readOnlyCommandKeepsCachedEntry()
+{
+  OMCProxy *pOMCProxy = MainWindow::instance()->getOMCProxy();
+  QCOMPARE(pOMCProxy->getClassInformation("ClassInformationTest.M1").comment, QString("first model"));
+  QVERIFY(pOMCProxy->isClassInformationCached("ClassInformationTest.M1"));
+  // queries must not clear the cache
+  QVERIFY(pOMCProxy->existClass("ClassInformationTest.M2"));
+  QVERIFY(!pOMCProxy->isPackage("ClassInformationTest.M1"));
+  pOMCProxy->getClassNames("ClassInformationTest");
+  QVERIFY(pOMCProxy->isClassInformationCached("ClassInformationTest.M1"));
+}
+
+void ClassInformationTest::modelEditClearsCachedEntry()
+{
+  OMCProxy *pOMCProxy = MainWindow::instance()->getOMCProxy();
+  pOMCProxy->getClassInformation("ClassInformationTest.M1");
+  QVERIFY(pOMCProxy->isClassInformationCached("ClassInformationTest.M1"));
+  // loadString is what OMEdit sends when the text of a model is edited
+  if (!pOMCProxy->loadString(packageText("edited model"), fileName)) {
+    QFAIL("Failed to update the ClassInformationTest package.");
+  }
+  QVERIFY(!pOMCProxy->isClassInformationCached("ClassInformationTest.M1"));
+  QCOMPARE(pOMCProxy->getClassInformation("ClassInformationTest.M1").comment, QString("edited model"));
+}
+
+void ClassInformationTest::prefetchFillsCache()
+{
+  OMCProxy *pOMCProxy = MainWindow::instance()->getOMCProxy();
+  // clear the cache with an edit
+  if (!pOMCProxy->loadString(packageText("prefetched model"), fileName)) {
+    QFAIL("Failed to update the ClassInformationTest package.");
+  }
+  pOMCProxy->prefetchClassInformation(QStringList() << "ClassInformationTest.M1" << "ClassInformationTest.M2" << "ClassInformationTest.T");
+  QVERIFY(pOMCProxy->isClassInformationCached("ClassInformationTest.M1"));
+  QVERIFY(pOMCProxy->isClassInformationCached("ClassInformationTest.M2"));
+  QVERIFY(pOMCProxy->isClassInformationCached("ClassInformationTest.T"));
+  QCOMPARE(pOMCProxy->getClassInformation("ClassInformationTest.M1").comment, QString("prefetched model"));
+  QCOMPARE(pOMCProxy->getClassInformation("ClassInformationTest.M2").comment, QString("second model"));
+  QCOMPARE(pOMCProxy->getClassInformation("ClassInformationTest.M2").restriction, QString("model"));
+  // the classes have different numbers of dimensions
+  QVERIFY(pOMCProxy->getClassInformation("ClassInformationTest.M1").dimensions.isEmpty());
+  QCOMPARE(pOMCProxy->getClassInformation("ClassInformationTest.T").dimensions, QList<QString>() << "3" << "2");
+}
+
+void ClassInformationTest::cleanupTestCase()
+{
+  MainWindow::instance()->close();
+}
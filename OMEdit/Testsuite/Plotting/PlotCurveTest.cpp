@@ -0,0 +1,129 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "PlotCurveTest.h"
+#include "Util.h"
+#include "OMEditApplication.h"
+#include "MainWindow.h"
+#include "PlotCurve.h"
+
+#include <qwt_scale_map.h>
+#include <QtMath>
+#include <random>
+
+#define GC_THREADS
+extern "C" {
+#include "meta/meta_modelica.h"
+}
+
+OMEDITTEST_MAIN(PlotCurveTest)
+
+/*!
+ * \brief compareClosestSample
+ * Looks up the closest sample of random positions on and around a 800x600 canvas showing all samples,
+ * and checks that no sample is closer than the one returned by PlotCurveData::closestSample.
+ * \param x
+ * \param y
+ */
+static void compareClosestSample(const QVector<double> &x, const QVector<double> &y)
+{
+  OMPlot::PlotCurveData plotCurveData(x, y);
+  const QRectF rect = plotCurveData.boundingRect();
+  QwtScaleMap xMap, yMap;
+  xMap.setPaintInterval(0, 800);
+  xMap.setScaleInterval(rect.left(), rect.right());
+  yMap.setPaintInterval(600, 0);
+  yMap.setScaleInterval(rect.top(), rect.bottom());
+
+  auto distance = [&](int i, const QPoint &pos) {
+    const double cx = xMap.transform(x.at(i)) - pos.x();
+    const double cy = yMap.transform(y.at(i)) - pos.y();
+    return qSqrt(cx * cx + cy * cy);
+  };
+
+  std::mt19937 generator(4711);
+  std::uniform_int_distribution<int> posX(-100, 900), posY(-100, 700);
+  for (int k = 0 ; k < 1000 ; k++) {
+    const QPoint pos(posX(generator), posY(generator));
+    double dist = -1.0;
+    const int index = plotCurveData.closestSample(pos, xMap, yMap, &dist);
+    QVERIFY2(index >= 0 && index < x.size(), QString("No sample found for (%1, %2).").arg(pos.x()).arg(pos.y()).toStdString().c_str());
+    QCOMPARE(distance(index, pos), dist);
+
+    double minimum = -1.0;
+    for (int i = 0 ; i < x.size() ; i++) {
+      const double d = distance(i, pos);
+      if (minimum < 0 || d < minimum) {
+        minimum = d;
+      }
+    }
+    QVERIFY2(dist <= minimum, QString("Sample %1 at distance %2 of (%3, %4) is not the closest, the closest is at distance %5.")
+             .arg(index).arg(dist).arg(pos.x()).arg(pos.y()).arg(minimum).toStdString().c_str());
+  }
+}
+
+/*!
+ * \brief PlotCurveTest::closestSampleAscending
+ * A noisy time series, searched with the min/max pyramid.
+ */
+void PlotCurveTest::closestSampleAscending()
+{
+  const int n = 20000;
+  QVector<double> x(n), y(n);
+  std::mt19937 generator(1234);
+  std::normal_distribution<double> noise(0.0, 0.1);
+  for (int i = 0 ; i < n ; i++) {
+    x[i] = i * 1e-3;
+    y[i] = qSin(7.0 * x[i]) + noise(generator);
+  }
+  compareClosestSample(x, y);
+}
+
+/*!
+ * \brief PlotCurveTest::closestSampleParametric
+ * A curve that crosses itself, searched with the grid.
+ */
+void PlotCurveTest::closestSampleParametric()
+{
+  const int n = 10000;
+  QVector<double> x(n), y(n);
+  for (int i = 0 ; i < n ; i++) {
+    const double t = 10.0 * M_PI * i / n;
+    x[i] = (1.0 + 0.1 * t) * qCos(3.0 * t);
+    y[i] = qSin(5.0 * t);
+  }
+  compareClosestSample(x, y);
+}
+
+void PlotCurveTest::cleanupTestCase()
+{
+  MainWindow::instance()->close();
+}
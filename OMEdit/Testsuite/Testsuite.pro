@@ -37,7 +37,9 @@ SUBDIRS = Util \
   Homotopy \
   Expression \
   ModelInstance \
-  Utilities
+  Utilities \
+  Plotting \
+  ClassInformation
 
 BrowseMSL.depends = Util
 Diagram.depends = Util
@@ -46,3 +48,5 @@ Homotopy.depends = Util
 Expression.depends = Util
 ModelInstance.depends = Util
 Utilities.depends = Util
+Plotting.depends = Util
+ClassInformation.depends = Util
@@ -39,8 +39,324 @@
 #include "qwt_scale_map.h"
 #include "qwt_point_polar.h"
 
+#include <algorithm>
+
 using namespace OMPlot;
 
+/*!
+ * \brief PlotCurveData::PlotCurveData
+ * Computes the bounding rectangle and, if the x values are ascending, the min/max pyramid, otherwise the grid.
+ * \param xAxisVector
+ * \param yAxisVector
+ */
+PlotCurveData::PlotCurveData(const QVector<double> &xAxisVector, const QVector<double> &yAxisVector)
+  : mXAxisVector(xAxisVector), mYAxisVector(yAxisVector), mAscending(true), mGridSize(0), mFirst(0), mDecimated(false)
+{
+  const int n = qMin(mXAxisVector.size(), mYAxisVector.size());
+  mLast = n - 1;
+  const double *x = mXAxisVector.constData();
+  const double *y = mYAxisVector.constData();
+  if (n > 0) {
+    double xMin = x[0], xMax = x[0], yMin = y[0], yMax = y[0];
+    for (int i = 1 ; i < n ; i++) {
+      mAscending = mAscending && !(x[i] < x[i - 1]) && !qIsNaN(x[i]);
+      xMin = qMin(xMin, x[i]);
+      xMax = qMax(xMax, x[i]);
+      yMin = qMin(yMin, y[i]);
+      yMax = qMax(yMax, y[i]);
+    }
+    cachedBoundingRect = QRectF(xMin, yMin, xMax - xMin, yMax - yMin);
+  }
+  // small curves are always drawn and searched completely
+  if (n <= 4096) {
+    return;
+  }
+  // parametric curves are always drawn completely but get a grid for closestSample
+  if (!mAscending) {
+    const QRectF rect = cachedBoundingRect;
+    mGridSize = qBound(1, int(qSqrt(n / 8)), 1024);
+    QVector<int> cells(n, -1);
+    mGridCellStarts.fill(0, mGridSize * mGridSize + 1);
+    for (int i = 0 ; i < n ; i++) {
+      if (qIsFinite(x[i]) && qIsFinite(y[i])) {
+        const int cx = rect.width() > 0 ? qBound(0, int((x[i] - rect.left()) / rect.width() * mGridSize), mGridSize - 1) : 0;
+        const int cy = rect.height() > 0 ? qBound(0, int((y[i] - rect.top()) / rect.height() * mGridSize), mGridSize - 1) : 0;
+        cells[i] = cy * mGridSize + cx;
+        mGridCellStarts[cells[i] + 1]++;
+      }
+    }
+    for (int c = 0 ; c < mGridSize * mGridSize ; c++) {
+      mGridCellStarts[c + 1] += mGridCellStarts[c];
+    }
+    mGridIndexes.resize(mGridCellStarts.last());
+    QVector<int> fill = mGridCellStarts;
+    for (int i = 0 ; i < n ; i++) {
+      if (cells[i] >= 0) {
+        mGridIndexes[fill[cells[i]]++] = i;
+      }
+    }
+    return;
+  }
+  // level 0 from the samples, every further level from four buckets of the previous one
+  int buckets = (n + 3) / 4;
+  QVector<int> minIndexes(buckets), maxIndexes(buckets);
+  for (int b = 0 ; b < buckets ; b++) {
+    int iMin = 4 * b, iMax = 4 * b;
+    for (int i = 4 * b + 1 ; i < qMin(4 * b + 4, n) ; i++) {
+      if (y[i] < y[iMin]) iMin = i;
+      if (y[i] > y[iMax]) iMax = i;
+    }
+    minIndexes[b] = iMin;
+    maxIndexes[b] = iMax;
+  }
+  mMinIndexes.append(minIndexes);
+  mMaxIndexes.append(maxIndexes);
+  while (buckets > 1) {
+    const QVector<int> &previousMin = mMinIndexes.last();
+    const QVector<int> &previousMax = mMaxIndexes.last();
+    const int previousBuckets = buckets;
+    buckets = (buckets + 3) / 4;
+    QVector<int> levelMinIndexes(buckets), levelMaxIndexes(buckets);
+    for (int b = 0 ; b < buckets ; b++) {
+      int iMin = previousMin.at(4 * b), iMax = previousMax.at(4 * b);
+      for (int c = 4 * b + 1 ; c < qMin(4 * b + 4, previousBuckets) ; c++) {
+        if (y[previousMin.at(c)] < y[iMin]) iMin = previousMin.at(c);
+        if (y[previousMax.at(c)] > y[iMax]) iMax = previousMax.at(c);
+      }
+      levelMinIndexes[b] = iMin;
+      levelMaxIndexes[b] = iMax;
+    }
+    mMinIndexes.append(levelMinIndexes);
+    mMaxIndexes.append(levelMaxIndexes);
+  }
+}
+
+size_t PlotCurveData::size() const
+{
+  return mDecimated ? mSelection.size() : mLast - mFirst + 1;
+}
+
+QPointF PlotCurveData::sample(size_t i) const
+{
+  const int index = sourceIndex(i);
+  return QPointF(mXAxisVector.at(index), mYAxisVector.at(index));
+}
+
+QRectF PlotCurveData::boundingRect() const
+{
+  return cachedBoundingRect;
+}
+
+/*!
+ * \brief PlotCurveData::selectSamples
+ * Selects the samples for the visible x range [x1, x2].
+ * Picks the finest level of the pyramid that has at most one bucket per pixel.
+ * \param x1
+ * \param x2
+ * \param pixels - the width of the visible x range in pixels.
+ */
+void PlotCurveData::selectSamples(double x1, double x2, int pixels) const
+{
+  const int n = qMin(mXAxisVector.size(), mYAxisVector.size());
+  mFirst = 0;
+  mLast = n - 1;
+  mDecimated = false;
+  mSelection.clear();
+  if (mMinIndexes.isEmpty() || pixels <= 0) {
+    return;
+  }
+  if (x1 > x2) {
+    qSwap(x1, x2);
+  }
+  // keep one sample on each side of the visible range so that the lines reach the canvas border
+  const double *x = mXAxisVector.constData();
+  mFirst = qMax(0, int(std::lower_bound(x, x + n, x1) - x) - 1);
+  mLast = qMin(n - 1, int(std::upper_bound(x, x + n, x2) - x));
+  const int count = mLast - mFirst + 1;
+  if (count <= 2 * pixels) {
+    return;
+  }
+  int level = 0;
+  int bucketSize = 4;
+  while (count / bucketSize > pixels && level + 1 < mMinIndexes.size()) {
+    level++;
+    bucketSize *= 4;
+  }
+  const QVector<int> &minIndexes = mMinIndexes.at(level);
+  const QVector<int> &maxIndexes = mMaxIndexes.at(level);
+  mSelection.reserve(2 * (count / bucketSize + 2) + 2);
+  mSelection.append(mFirst);
+  for (int b = mFirst / bucketSize ; b <= mLast / bucketSize ; b++) {
+    const int i = qMin(minIndexes.at(b), maxIndexes.at(b));
+    const int j = qMax(minIndexes.at(b), maxIndexes.at(b));
+    if (i > mSelection.last() && i < mLast) {
+      mSelection.append(i);
+    }
+    if (j > mSelection.last() && j < mLast) {
+      mSelection.append(j);
+    }
+  }
+  mSelection.append(mLast);
+  mDecimated = true;
+}
+
+/*!
+ * \brief PlotCurveData::closestSample
+ * Finds the sample with the smallest distance in pixels to pos.
+ * For ascending x values the search starts at the binary searched x of pos and walks to both sides until the
+ * x distance alone is larger than the closest sample so far. Buckets of the pyramid whose y range is too far away are skipped.
+ * Otherwise the rings of grid cells around pos are searched until no cell outside of them can be closer.
+ * \param pos
+ * \param xMap
+ * \param yMap
+ * \param dist - the distance in pixels to the closest sample.
+ * \return the index of the closest sample in the x and y vectors or -1.
+ */
+int PlotCurveData::closestSample(const QPoint &pos, const QwtScaleMap &xMap, const QwtScaleMap &yMap, double *dist) const
+{
+  const int n = qMin(mXAxisVector.size(), mYAxisVector.size());
+  const double *x = mXAxisVector.constData();
+  const double *y = mYAxisVector.constData();
+  int index = -1;
+  double dmin = 0.0;
+  auto test = [&](int i) {
+    const double cx = xMap.transform(x[i]) - pos.x();
+    const double cy = yMap.transform(y[i]) - pos.y();
+    const double f = cx * cx + cy * cy;
+    if (index < 0 || f < dmin) {
+      index = i;
+      dmin = f;
+    }
+  };
+
+  if (mAscending) {
+    // squared pixel distance of pos to the y range of a bucket with the given x distance
+    auto bucketDistance = [&](int level, int bucket, double cx) {
+      const double y1 = yMap.transform(y[mMinIndexes.at(level).at(bucket)]);
+      const double y2 = yMap.transform(y[mMaxIndexes.at(level).at(bucket)]);
+      const double cy = pos.y() < qMin(y1, y2) ? qMin(y1, y2) - pos.y() : (pos.y() > qMax(y1, y2) ? pos.y() - qMax(y1, y2) : 0.0);
+      return cx * cx + cy * cy;
+    };
+    const int start = int(std::lower_bound(x, x + n, xMap.invTransform(pos.x())) - x);
+    // walk to the right, buckets start at i
+    for (int i = start ; i < n ; ) {
+      const double cx = xMap.transform(x[i]) - pos.x();
+      if (index >= 0 && cx * cx >= dmin) {
+        break;
+      }
+      int skip = 0;
+      for (int level = mMinIndexes.size() - 1, bucketSize = 1 << (2 * mMinIndexes.size()) ; level >= 0 && index >= 0 ; level--, bucketSize /= 4) {
+        if (i % bucketSize == 0 && bucketDistance(level, i / bucketSize, cx) >= dmin) {
+          skip = bucketSize;
+          break;
+        }
+      }
+      if (skip > 0) {
+        i += skip;
+      } else {
+        test(i++);
+      }
+    }
+    // walk to the left, buckets end at i
+    for (int i = start - 1 ; i >= 0 ; ) {
+      const double cx = xMap.transform(x[i]) - pos.x();
+      if (index >= 0 && cx * cx >= dmin) {
+        break;
+      }
+      int skip = 0;
+      for (int level = mMinIndexes.size() - 1, bucketSize = 1 << (2 * mMinIndexes.size()) ; level >= 0 && index >= 0 ; level--, bucketSize /= 4) {
+        if ((i + 1) % bucketSize == 0 && bucketDistance(level, i / bucketSize, cx) >= dmin) {
+          skip = bucketSize;
+          break;
+        }
+      }
+      if (skip > 0) {
+        i -= skip;
+      } else {
+        test(i--);
+      }
+    }
+  } else if (mGridSize > 0) {
+    const QRectF rect = cachedBoundingRect;
+    const double px = xMap.invTransform(pos.x());
+    const double py = yMap.invTransform(pos.y());
+    const double cellWidth = rect.width() / mGridSize;
+    const double cellHeight = rect.height() / mGridSize;
+    const int ci = cellWidth > 0 ? qBound(0, int((px - rect.left()) / cellWidth), mGridSize - 1) : 0;
+    const int cj = cellHeight > 0 ? qBound(0, int((py - rect.top()) / cellHeight), mGridSize - 1) : 0;
+    auto testCell = [&](int i, int j) {
+      if (i >= 0 && i < mGridSize && j >= 0 && j < mGridSize) {
+        const int c = j * mGridSize + i;
+        for (int k = mGridCellStarts.at(c) ; k < mGridCellStarts.at(c + 1) ; k++) {
+          test(mGridIndexes.at(k));
+        }
+      }
+    };
+    for (int r = 0 ; ; r++) {
+      const int i0 = ci - r, i1 = ci + r, j0 = cj - r, j1 = cj + r;
+      for (int j = j0 ; j <= j1 ; j++) {
+        testCell(i0, j);
+        if (i1 != i0) {
+          testCell(i1, j);
+        }
+      }
+      for (int i = i0 + 1 ; i < i1 ; i++) {
+        testCell(i, j0);
+        if (j1 != j0) {
+          testCell(i, j1);
+        }
+      }
+      if (i0 <= 0 && j0 <= 0 && i1 >= mGridSize - 1 && j1 >= mGridSize - 1) {
+        break;
+      }
+      if (index >= 0) {
+        // pixel distance of pos to the cells outside of the rings searched so far
+        double bound = -1.0;
+        auto limit = [&](double d) {
+          bound = bound < 0 ? d : qMin(bound, d);
+        };
+        if (i0 > 0) {
+          const double edge = rect.left() + i0 * cellWidth;
+          limit(px < edge ? 0.0 : qAbs(xMap.transform(edge) - pos.x()));
+        }
+        if (i1 < mGridSize - 1) {
+          const double edge = rect.left() + (i1 + 1) * cellWidth;
+          limit(px >= edge ? 0.0 : qAbs(xMap.transform(edge) - pos.x()));
+        }
+        if (j0 > 0) {
+          const double edge = rect.top() + j0 * cellHeight;
+          limit(py < edge ? 0.0 : qAbs(yMap.transform(edge) - pos.y()));
+        }
+        if (j1 < mGridSize - 1) {
+          const double edge = rect.top() + (j1 + 1) * cellHeight;
+          limit(py >= edge ? 0.0 : qAbs(yMap.transform(edge) - pos.y()));
+        }
+        if (bound * bound >= dmin) {
+          break;
+        }
+      }
+    }
+  } else {
+    for (int i = 0 ; i < n ; i++) {
+      test(i);
+    }
+  }
+  if (dist && index >= 0) {
+    *dist = qSqrt(dmin);
+  }
+  return index;
+}
+
+/*!
+ * \brief PlotCurveData::sourceIndex
+ * \param i - index of the selected sample.
+ * \return the index of the sample in the x and y vectors.
+ */
+int PlotCurveData::sourceIndex(size_t i) const
+{
+  return mDecimated ? mSelection.at(i) : mFirst + int(i);
+}
+
 PlotCurve::PlotCurve(const QString &fileName, const QString &absoluteFilePath, const QString &xVariableName, const QString &xUnit, const QString &xDisplayUnit,
                      const QString &yVariableName, const QString &yUnit, const QString &yDisplayUnit, Plot *pParent)
   : mCustomColor(false)
@@ -167,6 +483,18 @@ void PlotCurve::updateXAxisValue(int index, double value)
   mXAxisVector.replace(index, value);
 }
 
+/*!
+ * \brief PlotCurve::setAxisVectors
+ * Sets the x and y values. The vectors are implicitly shared, e.g., one time vector with all curves of a result file.
+ * \param xAxisVector
+ * \param yAxisVector
+ */
+void PlotCurve::setAxisVectors(const QVector<double> &xAxisVector, const QVector<double> &yAxisVector)
+{
+  mXAxisVector = xAxisVector;
+  mYAxisVector = yAxisVector;
+}
+
 QPair<QVector<double>*, QVector<double>*> PlotCurve::getAxisVectors()
 {
   return qMakePair(&mXAxisVector, &mYAxisVector);
@@ -325,7 +653,7 @@ void PlotCurve::plotData(bool toggleSign)
       mYExponent = 0;
     }
   }
-  setSamples(mXAxisVector, mYAxisVector);
+  setData(new PlotCurveData(mXAxisVector, mYAxisVector));
 }
 
 #if QWT_VERSION < 0x060000
@@ -346,6 +674,7 @@ void PlotCurve::updateLegend(QwtLegend *legend) const
  * \brief QwtPlotCurve::closestPoint
  * Reimplentation of QwtPlotCurve::closestPoint()
  * Just doesn't fail if first time f < dmin instead we use the first f value to initialize dmin.
+ * Uses PlotCurveData::closestSample if the curve has PlotCurveData.
  * \param pos
  * \param dist
  * \return
@@ -361,6 +690,11 @@ int PlotCurve::closestPoint(const QPoint &pos, double *dist) const
   const QwtScaleMap xMap = plot()->canvasMap(xAxis());
   const QwtScaleMap yMap = plot()->canvasMap(yAxis());
 
+  const PlotCurveData *pPlotCurveData = dynamic_cast<const PlotCurveData*>(series);
+  if (pPlotCurveData) {
+    return pPlotCurveData->closestSample(pos, xMap, yMap, dist);
+  }
+
   int index = -1;
   double dmin = 1.0e10;
 
@@ -383,6 +717,20 @@ int PlotCurve::closestPoint(const QPoint &pos, double *dist) const
   return index;
 }
 
+/*!
+ * \brief PlotCurve::drawSeries
+ * Reimplentation of QwtPlotCurve::drawSeries()
+ * Selects the level of detail of PlotCurveData for the visible x range before drawing.
+ */
+void PlotCurve::drawSeries(QPainter *painter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRectF &canvasRect, int from, int to) const
+{
+  const PlotCurveData *pPlotCurveData = dynamic_cast<const PlotCurveData*>(data());
+  if (pPlotCurveData && from == 0 && to < 0) {
+    pPlotCurveData->selectSamples(xMap.s1(), xMap.s2(), qRound(qAbs(xMap.pDist())));
+  }
+  QwtPlotCurve::drawSeries(painter, xMap, yMap, canvasRect, from, to);
+}
+
 /*!
  * \brief PlotCurve::boundingRect
  * Reimplentation of QwtPlotCurve::boundingRect() to add a margin.
@@ -37,6 +37,41 @@
 
 namespace OMPlot
 {
+/*!
+ * \class PlotCurveData
+ * \brief Curve samples with a min/max pyramid for level of detail rendering.
+ * The x and y vectors are shared with the PlotCurve. For ascending x values only about two samples per pixel
+ * of the visible x range are handed to Qwt, the min and max sample of each bucket of the selected level.
+ * Other curves, e.g., parametric ones, get a uniform grid of the samples for finding the closest sample.
+ */
+class PlotCurveData : public QwtSeriesData<QPointF>
+{
+public:
+  PlotCurveData(const QVector<double> &xAxisVector, const QVector<double> &yAxisVector);
+  virtual size_t size() const override;
+  virtual QPointF sample(size_t i) const override;
+  virtual QRectF boundingRect() const override;
+  void selectSamples(double x1, double x2, int pixels) const;
+  int sourceIndex(size_t i) const;
+  int closestSample(const QPoint &pos, const QwtScaleMap &xMap, const QwtScaleMap &yMap, double *dist) const;
+private:
+  QVector<double> mXAxisVector;
+  QVector<double> mYAxisVector;
+  bool mAscending;
+  // index of the min and max y value per bucket, level k has buckets of 4^(k+1) samples
+  QVector<QVector<int> > mMinIndexes;
+  QVector<QVector<int> > mMaxIndexes;
+  // sample indexes per cell of a mGridSize x mGridSize grid over the bounding rectangle
+  int mGridSize;
+  QVector<int> mGridCellStarts;
+  QVector<int> mGridIndexes;
+  // samples selected by the last selectSamples
+  mutable int mFirst;
+  mutable int mLast;
+  mutable bool mDecimated;
+  mutable QVector<int> mSelection;
+};
+
 class PlotCurve : public QwtPlotCurve
 {
 private:
@@ -94,6 +129,7 @@ public:
   void updateXAxisValue(int index, double value);
   QPair<QVector<double>*, QVector<double>*> getAxisVectors();
   void clearXAxisVector() {mXAxisVector.clear();}
+  void setAxisVectors(const QVector<double> &xAxisVector, const QVector<double> &yAxisVector);
   void addYAxisValue(double value);
   void updateYAxisValue(int index, double value);
   void clearYAxisVector() {mYAxisVector.clear();}
@@ -118,6 +154,7 @@ public:
   virtual void updateLegend(QwtLegend *legend) const;
 #endif
   virtual int closestPoint(const QPoint &pos, double *dist = NULL) const;
+  virtual void drawSeries(QPainter *painter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRectF &canvasRect, int from, int to) const override;
 
   // QwtPlotItem interface
 public:
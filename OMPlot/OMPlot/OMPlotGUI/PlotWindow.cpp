@@ -31,6 +31,7 @@
 
 #include <iostream>
 #include <memory>
+#include <algorithm>
 
 #include "PlotWindow.h"
 #include "LogScaleEngine.h"
@@ -486,6 +487,9 @@ void PlotWindow::plot(PlotCurve *pPlotCurve)
       }
       setXLabel("lambda");
     }
+    // shared by all curves
+    QVector<double> timeVector(csvReader->numsteps);
+    std::copy(timeVals, timeVals + csvReader->numsteps, timeVector.begin());
 
     // read in all values
     for (int i = 0; i < csvReader->numvars; i++)
@@ -506,13 +510,9 @@ void PlotWindow::plot(PlotCurve *pPlotCurve)
           mpPlot->addPlotCurve(pPlotCurve);
         }
         // clear previous curve data
-        pPlotCurve->clearXAxisVector();
-        pPlotCurve->clearYAxisVector();
-        for (int i = 0 ; i < csvReader->numsteps ; i++)
-        {
-          pPlotCurve->addXAxisValue(timeVals[i]);
-          pPlotCurve->addYAxisValue(vals[i]);
-        }
+        QVector<double> valuesVector(csvReader->numsteps);
+        std::copy(vals, vals + csvReader->numsteps, valuesVector.begin());
+        pPlotCurve->setAxisVectors(timeVector, valuesVector);
         pPlotCurve->plotData();
         pPlotCurve->attach(mpPlot);
         mpPlot->replot();
@@ -550,6 +550,9 @@ void PlotWindow::plot(PlotCurve *pPlotCurve)
       omc_free_matlab4_reader(&reader);
       throw NoVariableException(QString("Corrupt file. nvar %1").arg(reader.nvar).toStdString().c_str());
     }
+    // shared by all curves
+    QVector<double> timeVector(reader.nrows);
+    std::copy(timeVals, timeVals + reader.nrows, timeVector.begin());
     // read in all values
     for (uint32_t i = 0; i < reader.nall; i++) {
       if (mVariablesList.contains(reader.allInfo[i].name) || isPlotAll()) {
@@ -577,10 +580,9 @@ void PlotWindow::plot(PlotCurve *pPlotCurve)
             throw NoVariableException(QString("Corrupt file. nvar %1").arg(reader.nvar).toStdString().c_str());
           }
           // set plot curve data and attach it to plot
-          for (uint32_t i = 0 ; i < reader.nrows ; i++) {
-            pPlotCurve->addXAxisValue(timeVals[i]);
-            pPlotCurve->addYAxisValue(vals[i]);
-          }
+          QVector<double> valuesVector(reader.nrows);
+          std::copy(vals, vals + reader.nrows, valuesVector.begin());
+          pPlotCurve->setAxisVectors(timeVector, valuesVector);
           pPlotCurve->plotData();
           pPlotCurve->attach(mpPlot);
           mpPlot->replot();
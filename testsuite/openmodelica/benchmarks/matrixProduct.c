@@ -0,0 +1,96 @@
+/*
+ * Benchmark for the matrix kernels of the C runtime (util/matrix_kernels.c)
+ * that implement the Modelica operators A*B, A*x and x*A. For every size the
+ * blocked (or BLAS) product is compared to the naive triple loop the runtime
+ * used before, both for speed and for the largest deviation of the results.
+ *
+ * Build against the runtime of an OpenModelica installation:
+ *   gcc -O2 -I$OPENMODELICAHOME/include/omc/c matrixProduct.c \
+ *       -L$OPENMODELICAHOME/lib/<target>/omc -lOpenModelicaRuntimeC -lm -o matrixProduct
+ * Run from time to time with:
+ *   ./matrixProduct [size ...]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "util/matrix_kernels.h"
+
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+static void naive_product(size_t n, const double *a, const double *b, double *c)
+{
+  size_t i, j, k;
+  for (i = 0; i < n; i++) {
+    for (j = 0; j < n; j++) {
+      double sum = 0;
+      for (k = 0; k < n; k++) {
+        sum += a[i*n+k] * b[k*n+j];
+      }
+      c[i*n+j] = sum;
+    }
+  }
+}
+
+static void benchmark(size_t n)
+{
+  double *a = (double*) malloc(n * n * sizeof(double));
+  double *b = (double*) malloc(n * n * sizeof(double));
+  double *c1 = (double*) malloc(n * n * sizeof(double));
+  double *c2 = (double*) malloc(n * n * sizeof(double));
+  double t0, tNaive, tKernel, err = 0;
+  size_t i;
+  int rep, reps = (int) (2e8 / ((double) n * n * n)) + 1;
+
+  for (i = 0; i < n * n; i++) {
+    a[i] = (double) rand() / RAND_MAX - 0.5;
+    b[i] = (double) rand() / RAND_MAX - 0.5;
+  }
+
+  t0 = now();
+  for (rep = 0; rep < reps; rep++) {
+    naive_product(n, a, b, c1);
+  }
+  tNaive = (now() - t0) / reps;
+
+  t0 = now();
+  for (rep = 0; rep < reps; rep++) {
+    omc_matrix_product(n, n, n, a, b, c2);
+  }
+  tKernel = (now() - t0) / reps;
+
+  for (i = 0; i < n * n; i++) {
+    err = fmax(err, fabs(c1[i] - c2[i]));
+  }
+  printf("n = %4lu: naive %9.3f ms (%6.2f GFlop/s), kernel %9.3f ms (%6.2f GFlop/s), speedup %5.1f, max deviation %g\n",
+         (unsigned long) n, 1e3 * tNaive, 2e-9 * n * n * n / tNaive, 1e3 * tKernel, 2e-9 * n * n * n / tKernel,
+         tNaive / tKernel, err);
+
+  free(a);
+  free(b);
+  free(c1);
+  free(c2);
+}
+
+int main(int argc, char **argv)
+{
+  static const size_t sizes[] = {16, 50, 100, 200, 500, 1000};
+  int i;
+
+  if (argc > 1) {
+    for (i = 1; i < argc; i++) {
+      benchmark((size_t) atol(argv[i]));
+    }
+  } else {
+    for (i = 0; i < (int) (sizeof(sizes) / sizeof(sizes[0])); i++) {
+      benchmark(sizes[i]);
+    }
+  }
+  return 0;
+}
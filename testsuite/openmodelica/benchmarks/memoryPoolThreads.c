@@ -0,0 +1,84 @@
+/*
+ * Scalability benchmark for the memory pool of the C runtime (gc/memory_pool.c).
+ * Every thread repeatedly saves the pool state, allocates a batch of temporary
+ * arrays like the generated code does and restores the state again, which is
+ * the pattern of FMUs evaluated in parallel threads. With one pool per thread
+ * the allocations per second should grow with the number of threads.
+ *
+ * Build against the runtime of an OpenModelica installation:
+ *   gcc -O2 -DOM_HAVE_PTHREADS -I$OPENMODELICAHOME/include/omc/c memoryPoolThreads.c \
+ *       -L$OPENMODELICAHOME/lib/<target>/omc -lOpenModelicaRuntimeC -lpthread -o memoryPoolThreads
+ * Run from time to time with:
+ *   ./memoryPoolThreads [maxThreads] [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+#include "gc/omc_gc.h"
+
+#define ARRAYS_PER_ITERATION 16
+
+static long iterations = 200000;
+
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+static void* allocate(void *arg)
+{
+  double sum = 0;
+  long i;
+  int j;
+
+  for (i = 0; i < iterations; i++) {
+    MemPoolState state = omc_util_get_pool_state();
+    for (j = 0; j < ARRAYS_PER_ITERATION; j++) {
+      size_t n = 8 + (size_t) ((i + j) % 64) * 16;
+      double *v = (double*) omc_alloc_interface_pooled.malloc(n * sizeof(double));
+      v[n-1] = j;
+      sum += v[n-1];
+    }
+    omc_util_restore_pool_state(state);
+  }
+  free_memory_pool();
+  *(double*) arg = sum;
+  return NULL;
+}
+
+int main(int argc, char **argv)
+{
+  int maxThreads = argc > 1 ? atoi(argv[1]) : 8;
+  double single = 0;
+  int n, i;
+
+  if (argc > 2) {
+    iterations = atol(argv[2]);
+  }
+
+  printf("threads  allocations/s  speedup\n");
+  for (n = 1; n <= maxThreads; n *= 2) {
+    pthread_t *threads = (pthread_t*) malloc(n * sizeof(pthread_t));
+    double *sums = (double*) malloc(n * sizeof(double));
+    double start = now(), rate;
+
+    for (i = 0; i < n; i++) {
+      pthread_create(&threads[i], NULL, allocate, &sums[i]);
+    }
+    for (i = 0; i < n; i++) {
+      pthread_join(threads[i], NULL);
+    }
+    rate = n * iterations * ARRAYS_PER_ITERATION / (now() - start);
+    if (n == 1) {
+      single = rate;
+    }
+    printf("%7d  %13.3g  %7.2f\n", n, rate, rate / single);
+    free(threads);
+    free(sums);
+  }
+  return 0;
+}